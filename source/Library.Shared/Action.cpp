@@ -9,9 +9,10 @@ namespace FieaGameEngine
 	RTTI_DEFINITIONS(Action)
 
 
+
 	Action::Action(const std::string& name) : mName(name)
 	{
-		InitializeAttributes();
+		InitializePrescribedAttributes();
 	}
 
 
@@ -74,6 +75,7 @@ namespace FieaGameEngine
 	void Action::SetName(const std::string& name)
 	{
 		mName = name;
+		MarkChanged();
 	}
 
 
@@ -81,15 +83,7 @@ namespace FieaGameEngine
 
 	void Action::InitializeAttributes()
 	{
-		AddExternalPrescribedAttribute("Name", &mName, 1);
-	}
-
-
-
-
-	void Action::UpdatePrescribedAttributes()
-	{
-		(*this)["Name"].SetStorage(&mName, 1);
+		AddExternalPrescribedAttribute("Name", &Action::mName);
 	}
 
 }
\ No newline at end of file
@@ -91,12 +91,6 @@ namespace FieaGameEngine
 		*/
 		virtual void InitializeAttributes() override;
 
-		/**
-		*	@brief	Method to update the list of prescribed attributes whenever
-		*			the list is reinitialized. Overriden from the Attributed class.
-		*/
-		virtual void UpdatePrescribedAttributes() override;
-
 	private:
 
 		std::string mName;		/**<	Name of the action	*/
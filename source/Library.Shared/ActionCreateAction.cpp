@@ -2,6 +2,7 @@
 #include "ActionCreateAction.h"
 #include "Entity.h"
 #include "ActionList.h"
+#include "CommandBuffer.h"
 
 
 namespace FieaGameEngine
@@ -13,7 +14,7 @@ namespace FieaGameEngine
 
 	ActionCreateAction::ActionCreateAction(const std::string& name) : Action::Action(name)
 	{
-		InitializeAttributes();
+		InitializePrescribedAttributes();
 	}
 
 
@@ -75,14 +76,11 @@ namespace FieaGameEngine
 	{
 		worldState.CurrentAction = this;
 
+		//the action is created once the update is over, so that the actions being walked stay as they are
 		auto parent = GetParent();
-		if (parent->Is(Entity::TypeIdClass()))
+		if (parent->Is<Entity>() || parent->Is<ActionList>())
 		{
-			parent->As<Entity>()->CreateAction(Find("ClassName")->Get<std::string>(0), Find("InstanceName")->Get<std::string>(0));
-		}
-		else if (parent->Is(ActionList::TypeIdClass()))
-		{
-			parent->As<ActionList>()->CreateAction(Find("ClassName")->Get<std::string>(0), Find("InstanceName")->Get<std::string>(0));
+			CommandBuffer::CreateAction(worldState, *parent->As<Attributed>(), mClassName, mInstanceName);
 		}
 	}
 
@@ -99,17 +97,8 @@ namespace FieaGameEngine
 
 	void ActionCreateAction::InitializeAttributes()
 	{
-		AddExternalPrescribedAttribute("ClassName", &mClassName, 1);
-		AddExternalPrescribedAttribute("InstanceName", &mInstanceName, 1);
-	}
-
-
-
-
-	void ActionCreateAction::UpdatePrescribedAttributes()
-	{
-		(*this)["ClassName"].SetStorage(&mClassName, 1);
-		(*this)["InstanceName"].SetStorage(&mInstanceName, 1);
+		AddExternalPrescribedAttribute("ClassName", &ActionCreateAction::mClassName);
+		AddExternalPrescribedAttribute("InstanceName", &ActionCreateAction::mInstanceName);
 	}
 
 
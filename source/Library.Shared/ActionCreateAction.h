@@ -62,7 +62,8 @@ namespace FieaGameEngine
 		~ActionCreateAction() = default;
 
 		/**
-		*	@brief	Creates an action from the class name and instance name
+		*	@brief	Records the creation of an action from the class name and instance name, which
+		*			joins the parent of this action at the end of the update
 		*/
 		void Update(WorldState& worldState) override;
 
@@ -79,12 +80,6 @@ namespace FieaGameEngine
 		*/
 		void InitializeAttributes() override;
 
-		/**
-		*	@brief	Method to update the list of prescribed attributes whenever
-		*			the list is reinitialized. Overriden from the Attributed class.
-		*/
-		void UpdatePrescribedAttributes() override;
-
 	private:
 
 		std::string mClassName;				/**<	class name of the action to be created	*/
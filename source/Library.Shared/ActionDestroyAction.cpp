@@ -1,7 +1,7 @@
 #include "pch.h"
 #include "Entity.h"
 #include "ActionList.h"
-#include "ActionDestroyer.h"
+#include "CommandBuffer.h"
 #include "ActionDestroyAction.h"
 
 
@@ -13,7 +13,7 @@ namespace FieaGameEngine
 
 	ActionDestroyAction::ActionDestroyAction(const std::string& name) : Action::Action(name)
 	{
-		InitializeAttributes();
+		InitializePrescribedAttributes();
 	}
 
 
@@ -73,32 +73,23 @@ namespace FieaGameEngine
 	{
 		worldState.CurrentAction = this;
 
-		bool found = false;
-		auto parent = GetParent();
-
-		while (found == false)
+		//the nearest container up the hierarchy that has an action with the name owns the target
+		for (Scope* container = GetParent(); container != nullptr; container = container->GetParent())
 		{
-			auto actions = parent->Search("Actions");
-
-			for (std::uint32_t i = 0; i < actions->Size(); ++i)
+			Action* action = nullptr;
+			if (container->Is<Entity>())
 			{
-				auto action = actions->Get<FieaGameEngine::Scope*>(i)->As<Action>();
-
-				if (action->Find("Name")->Get<std::string>(0) == mInstanceName)
-				{
-					ActionDestroyer::AddToListOfActionsToBeDestroyed(action);
-					found = true;
-					break;
-				}
+				action = container->As<Entity>()->FindAction(mInstanceName);
+			}
+			else if (container->Is<ActionList>())
+			{
+				action = container->As<ActionList>()->FindAction(mInstanceName);
 			}
 
-			if (found == false)
+			if (action != nullptr)
 			{
-				parent = GetParent();
-				if (parent == nullptr)
-				{
-					found = true;
-				}
+				CommandBuffer::Destroy(worldState, *action);
+				break;
 			}
 		}
 	}
@@ -116,15 +107,7 @@ namespace FieaGameEngine
 
 	void ActionDestroyAction::InitializeAttributes()
 	{
-		AddExternalPrescribedAttribute("InstanceName", &mInstanceName, 1);
-	}
-
-
-
-
-	void ActionDestroyAction::UpdatePrescribedAttributes()
-	{
-		(*this)["InstanceName"].SetStorage(&mInstanceName, 1);
+		AddExternalPrescribedAttribute("InstanceName", &ActionDestroyAction::mInstanceName);
 	}
 
 
@@ -2,6 +2,7 @@
 #include "ActionEvent.h"
 #include "Event.h"
 #include "EventMessageAttributed.h"
+#include "ObjectPool.h"
 
 namespace FieaGameEngine
 {
@@ -11,7 +12,7 @@ namespace FieaGameEngine
 
 	ActionEvent::ActionEvent(const std::string& name, const std::string& subType, const std::int32_t& delay) : Action::Action(name), mSubType(subType), mDelay(delay)
 	{
-		InitializeAttributes();
+		InitializePrescribedAttributes();
 	}
 
 
@@ -109,18 +110,25 @@ namespace FieaGameEngine
 		auto& world = worldState.CurrentWorld;
 		EventMessageAttributed ema(mSubType, worldState.CurrentWorld);
 
-		auto Attributes = GetAttributes();
-
-		for (auto& Attribute : Attributes)
+		for (auto& Attribute : GetAuxiliaryAttributes())
 		{
-			if (!IsPrescribedAttribute(Attribute->first))
-			{
-				ema.AppendAuxiliaryAttribute(Attribute->first) = Attribute->second;
-			}
+			ema.AppendAuxiliaryAttribute(Attribute->first) = Attribute->second;
 		}
 
-		std::shared_ptr<Event<EventMessageAttributed>> emaEvent = std::make_shared<Event<EventMessageAttributed>>(ema);
-		world->GetEventQueue().Enqueue(emaEvent, worldState.GetGameTime(), std::chrono::milliseconds(mDelay));
+		//events are created every time the action runs, so the event and its control block come from a pool, or from
+		//the frame allocator when the event is delivered this frame, and the message is moved in rather than copied,
+		//the arguments sharing their storage with the attributes above
+		EventQueue& eventQueue = world->GetEventQueue();
+		std::shared_ptr<Event<EventMessageAttributed>> emaEvent;
+		if ((mDelay == 0) && eventQueue.IsFrameAllocatorEnabled())
+		{
+			emaEvent = Event<EventMessageAttributed>::EmplaceTransient(eventQueue.GetFrameAllocator(), std::move(ema));
+		}
+		else
+		{
+			emaEvent = std::allocate_shared<Event<EventMessageAttributed>>(PooledAllocator<Event<EventMessageAttributed>>(), std::move(ema));
+		}
+		eventQueue.Enqueue(emaEvent, worldState, std::chrono::milliseconds(mDelay));
 	}
 
 
@@ -137,20 +145,11 @@ namespace FieaGameEngine
 	void ActionEvent::InitializeAttributes()
 	{
 		AddToPrescribedAttributes("Name");
-		AddExternalPrescribedAttribute("SubType", &mSubType, 1);
-		AddExternalPrescribedAttribute("Delay", &mDelay, 1);
+		AddExternalPrescribedAttribute("SubType", &ActionEvent::mSubType);
+		AddExternalPrescribedAttribute("Delay", &ActionEvent::mDelay);
 		Append("this") = static_cast<RTTI*>(this);
 		AddToPrescribedAttributes("this");
 	}
 
 
-
-
-	void ActionEvent::UpdatePrescribedAttributes()
-	{
-		(*this)["SubType"].SetStorage(&mSubType, 1);
-		(*this)["Delay"].SetStorage(&mDelay, 1);
-	}
-
-
 }
\ No newline at end of file
@@ -110,12 +110,6 @@ namespace FieaGameEngine
 		*/
 		void InitializeAttributes() override;
 
-		/**
-		*	@brief	Method to update the list of prescribed attributes whenever
-		*			the list is reinitialized. Overriden from the Attributed class.
-		*/
-		void UpdatePrescribedAttributes() override;
-
 	private:
 
 		std::string mSubType;	/**<	String representing the subtype	*/
@@ -0,0 +1,136 @@
+#include "pch.h"
+#include "ActionIndex.h"
+#include "Action.h"
+
+
+namespace FieaGameEngine
+{
+
+	ActionIndex::ActionIndex() : mHandles()
+	{
+	}
+
+
+
+
+	ActionIndex::ActionIndex(const ActionIndex& other) : ActionIndex()
+	{
+		UNREFERENCED_PARAMETER(other);
+	}
+
+
+
+
+	ActionIndex::ActionIndex(ActionIndex&& other) : ActionIndex()
+	{
+		UNREFERENCED_PARAMETER(other);
+	}
+
+
+
+
+	ActionIndex& ActionIndex::operator=(const ActionIndex& other)
+	{
+		UNREFERENCED_PARAMETER(other);
+		mHandles.Clear();
+		return *this;
+	}
+
+
+
+
+	ActionIndex& ActionIndex::operator=(ActionIndex&& other)
+	{
+		UNREFERENCED_PARAMETER(other);
+		mHandles.Clear();
+		return *this;
+	}
+
+
+
+
+	void ActionIndex::Add(Action& action)
+	{
+		//the first action with a name wins, the same as a search in order would find, unless its entry is out of date
+		bool wasInserted;
+		auto it = mHandles.Insert(std::make_pair(action.Name(), action.GetHandle()), wasInserted);
+		if (!wasInserted && (action.GetParent() != nullptr) && (Lookup(action.Name(), *action.GetParent()) == nullptr))
+		{
+			(*it).second = action.GetHandle();
+		}
+	}
+
+
+
+
+	Action* ActionIndex::Find(const std::string& name, const Scope& owner, const Datum* actions)
+	{
+		Action* action = Lookup(name, owner);
+		if ((action != nullptr) || (actions == nullptr))
+		{
+			return action;
+		}
+
+		//the entry may be missing or out of date, e.g. when the name was written through the attribute, so the names are compared before the index is rebuilt
+		for (std::uint32_t i = 0; i < actions->Size(); ++i)
+		{
+			Action* candidate = actions->Get<Scope*>(i)->As<Action>();
+			if ((candidate != nullptr) && (candidate->Name() == name))
+			{
+				Rebuild(actions);
+				return Lookup(name, owner);
+			}
+		}
+
+		return nullptr;
+	}
+
+
+
+
+	Action* ActionIndex::Lookup(const std::string& name, const Scope& owner) const
+	{
+		auto it = mHandles.Find(name);
+		if (it == mHandles.end())
+		{
+			return nullptr;
+		}
+
+		Attributed* attributed = HandleTable::Resolve((*it).second);
+		if ((attributed == nullptr) || (attributed->GetParent() != &owner))
+		{
+			return nullptr;
+		}
+
+		Action* action = attributed->As<Action>();
+		if ((action == nullptr) || (action->Name() != name))
+		{
+			return nullptr;
+		}
+
+		return action;
+	}
+
+
+
+
+	void ActionIndex::Rebuild(const Datum* actions)
+	{
+		mHandles.Clear();
+
+		if (actions == nullptr)
+		{
+			return;
+		}
+
+		for (std::uint32_t i = 0; i < actions->Size(); ++i)
+		{
+			Action* action = actions->Get<Scope*>(i)->As<Action>();
+			if (action != nullptr)
+			{
+				Add(*action);
+			}
+		}
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "HashMap.h"
+#include "HandleTable.h"
+
+/**
+*	@brief	The namespace under which the game engine is implemented.
+*/
+namespace FieaGameEngine
+{
+
+	class Action;	//forward declaration for the Action class
+	class Datum;	//forward declaration for the Datum class
+	class Scope;	//forward declaration for the Scope class
+
+	/**
+	*	@brief	The ActionIndex class is a secondary index from instance names to the actions of an
+	*			entity or an action list, so that actions can be found by name without comparing
+	*			the name of every action. The index holds handles, so an entry of an action that
+	*			died is simply a miss, and every hit is checked against the name and the parent of
+	*			the action before it is returned. A name can also be written through the "Name"
+	*			attribute, which the index does not see, so a miss compares the names of the actions
+	*			and rebuilds the index when one of them matches.
+	*/
+	class ActionIndex final
+	{
+
+	public:
+
+		/**
+		*	@brief	The default constructor creates an index that is rebuilt on first use.
+		*/
+		ActionIndex();
+
+		/**
+		*	@brief	The copy constructor does not copy the entries, which refer to the actions of the
+		*			other container. The new index is rebuilt on first use.
+		*	@param	other the index to be copied
+		*/
+		ActionIndex(const ActionIndex& other);
+
+		/**
+		*	@brief	The move constructor does not move the entries. The new index is rebuilt on first use.
+		*	@param	other the index to be moved
+		*/
+		ActionIndex(ActionIndex&& other);
+
+		/**
+		*	@brief	The copy assignment operator drops the entries, and the index is rebuilt on next use.
+		*	@param	other the index to be copied
+		*	@return	reference to the index
+		*/
+		ActionIndex& operator=(const ActionIndex& other);
+
+		/**
+		*	@brief	The move assignment operator drops the entries, and the index is rebuilt on next use.
+		*	@param	other the index to be moved
+		*	@return	reference to the index
+		*/
+		ActionIndex& operator=(ActionIndex&& other);
+
+		/**
+		*	@brief	The destructor is defaulted.
+		*/
+		~ActionIndex() = default;
+
+		/**
+		*	@brief	Method to index an action that was added to the container under its current name.
+		*	@param	action the action that was added
+		*/
+		void Add(Action& action);
+
+		/**
+		*	@brief	Method to find an action of the container by name.
+		*	@param	name the instance name of the action
+		*	@param	owner the container that the index belongs to
+		*	@param	actions the datum that holds the actions of the container
+		*	@return	pointer to the action if it was found, nullptr otherwise
+		*/
+		Action* Find(const std::string& name, const Scope& owner, const Datum* actions);
+
+	private:
+
+		/**
+		*	@brief	Helper method to look the name up without rebuilding.
+		*	@param	name the instance name of the action
+		*	@param	owner the container that the index belongs to
+		*	@return	pointer to the action if the entry is current, nullptr otherwise
+		*/
+		Action* Lookup(const std::string& name, const Scope& owner) const;
+
+		/**
+		*	@brief	Helper method to rebuild the index from the actions of the container.
+		*	@param	actions the datum that holds the actions of the container
+		*/
+		void Rebuild(const Datum* actions);
+
+		HashMap<std::string, Handle> mHandles;		/**<	The handles of the actions, hashed on their instance names	*/
+
+	};
+
+}
\ No newline at end of file
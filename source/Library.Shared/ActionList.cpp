@@ -8,7 +8,7 @@ namespace FieaGameEngine
 
 	ActionList::ActionList(const std::string& name) : Action::Action(name)
 	{
-		InitializeAttributes();
+		InitializePrescribedAttributes();
 	}
 
 
@@ -79,6 +79,35 @@ namespace FieaGameEngine
 
 
 
+	Action* ActionList::FindAction(const std::string& actionInstanceName)
+	{
+		return mActionIndex.Find(actionInstanceName, *this, Find("Actions"));
+	}
+
+
+
+
+	void ActionList::OnChildAdopted(Scope& child, const std::string& key)
+	{
+		Action* action = child.As<Action>();
+		if ((action != nullptr) && (key == "Actions"))
+		{
+			mActionIndex.Add(*action);
+			mActionArray.Add(*action);
+		}
+	}
+
+
+
+
+	void ActionList::OnChildOrphaned(Scope& child)
+	{
+		mActionArray.Remove(child);
+	}
+
+
+
+
 	const Datum* ActionList::Actions() const
 	{
 		return Find("Actions");
@@ -91,11 +120,11 @@ namespace FieaGameEngine
 	{
 		worldState.CurrentAction = this;
 		
-		mActions = Find("Actions");
-		for (std::uint32_t i = 0; i < mActions->Size(); ++i)
+		//actions created during the update are appended, so the array is walked by index
+		const Vector<Action*>& actions = mActionArray.Get(mActions);
+		for (std::uint32_t i = 0; i < actions.Size(); ++i)
 		{
-			assert((*mActions)[i].Is(Action::TypeIdClass()));
-			(*mActions)[i].As<Action>()->Update(worldState);
+			actions[i]->Update(worldState);
 		}
 	}
 
@@ -112,16 +141,7 @@ namespace FieaGameEngine
 
 	void ActionList::InitializeAttributes()
 	{
-		mActions = &Append("Actions");
-		AddToPrescribedAttributes("Actions");
-	}
-
-
-
-
-	void ActionList::UpdatePrescribedAttributes()
-	{
-		*Find("Actions") = *mActions;
+		AddTablePrescribedAttribute("Actions", &ActionList::mActions);
 	}
 
 }
\ No newline at end of file
@@ -2,6 +2,8 @@
 
 #include "Action.h"
 #include "Factory.h"
+#include "ActionIndex.h"
+#include "ChildArray.h"
 
 /**
 *	@brief	The namespace under which the game engine is implemented.
@@ -68,6 +70,14 @@ namespace FieaGameEngine
 		*/
 		Action& CreateAction(const std::string& actionClassName, const std::string& actionInstanceName);
 
+		/**
+		*	@brief	Method to find one of the actions of the action list by its instance name, through an index
+		*			of the actions, so the time it takes does not depend on the number of actions.
+		*	@param	actionInstanceName instance name of the action
+		*	@return	pointer to the action if it was found, nullptr otherwise
+		*/
+		Action* FindAction(const std::string& actionInstanceName);
+
 		/**
 		*	@brief	Method that returns the list of actions that are in this
 		*			action list
@@ -94,16 +104,31 @@ namespace FieaGameEngine
 		*/
 		virtual void InitializeAttributes() override;
 
+	protected:
+
 		/**
-		*	@brief	Method to update the list of prescribed attributes whenever
-		*			the list is reinitialized. Overriden from the Attributed class.
+		*	@brief	Method that indexes actions that are adopted under the actions key, and adds them to
+		*			the array of actions that is updated. Overriden from the Scope class.
+		*	@param	child the adopted child
+		*	@param	key the key that the child was adopted under
 		*/
-		virtual void UpdatePrescribedAttributes() override;
+		virtual void OnChildAdopted(Scope& child, const std::string& key) override;
+
+		/**
+		*	@brief	Method that drops actions that leave the action list from the index and from the
+		*			array of actions that is updated. Overriden from the Scope class.
+		*	@param	child the child that left
+		*/
+		virtual void OnChildOrphaned(Scope& child) override;
 
 	private:
 
 		Datum* mActions;		/**<	Datum pointer pointing to the datum containing the list of actions.	*/
 
+		ActionIndex mActionIndex;		/**<	Index of the actions by their instance names	*/
+
+		ChildArray<Action> mActionArray;		/**<	The actions that are updated, in order	*/
+
 	};
 
 	ConcreteFactory(ActionList, Action)
@@ -5,15 +5,15 @@ namespace FieaGameEngine
 {
 	RTTI_DEFINITIONS(ActionListIf)
 
-	ActionListIf::ActionListIf(const std::string& name) : ActionList::ActionList(name)
+	ActionListIf::ActionListIf(const std::string& name) : ActionList::ActionList(name), mThen(nullptr), mElse(nullptr)
 	{
-		InitializeAttributes();
+		InitializePrescribedAttributes();
 	}
 
 
 
 
-	ActionListIf::ActionListIf(const ActionListIf& other) : ActionList::ActionList(other), mCondition(other.mCondition), mThen(other.mThen), mElse(other.mElse)
+	ActionListIf::ActionListIf(const ActionListIf& other) : ActionList::ActionList(other), mCondition(other.mCondition), mThen(nullptr), mElse(nullptr)
 	{
 		SetName(other.Name());
 		UpdatePrescribedAttributes();
@@ -22,7 +22,7 @@ namespace FieaGameEngine
 
 
 
-	ActionListIf::ActionListIf(ActionListIf&& other) : ActionList::ActionList(std::move(other)), mCondition(std::move(other.mCondition)), mThen(std::move(other.mThen)), mElse(std::move(other.mElse))
+	ActionListIf::ActionListIf(ActionListIf&& other) : ActionList::ActionList(std::move(other)), mCondition(std::move(other.mCondition)), mThen(nullptr), mElse(nullptr)
 	{
 		SetName(other.Name());
 		UpdatePrescribedAttributes();
@@ -37,8 +37,8 @@ namespace FieaGameEngine
 		{
 			ActionList::operator=(other);
 			mCondition = other.mCondition;
-			mThen = other.mThen;
-			mElse = other.mElse;
+			mThen = nullptr;
+			mElse = nullptr;
 			SetName(other.Name());
 			UpdatePrescribedAttributes();
 		}
@@ -55,8 +55,8 @@ namespace FieaGameEngine
 		{
 			ActionList::operator=(std::move(other));
 			mCondition = std::move(other.mCondition);
-			mThen = std::move(other.mThen);
-			mElse = std::move(other.mElse);
+			mThen = nullptr;
+			mElse = nullptr;
 			SetName(std::move(other.Name()));
 			UpdatePrescribedAttributes();
 		}
@@ -86,26 +86,72 @@ namespace FieaGameEngine
 	{
 		worldState.CurrentAction = this;
 
-		mCondition = Find("Condition")->Get<std::int32_t>();
-
+		//the condition is bound to mCondition, so it does not have to be looked up
 		if (mCondition == 1)
 		{
-			mThen = Find("Then")->Get<Scope*>();
-			if (mThen == nullptr)
-			{
-				throw std::exception("Invalid Action List If.");
-			}
-			mThen->As<Action>()->Update(worldState);
+			ResolveBranch(mThen, "Then").Update(worldState);
 		}
 		else if (mCondition == 0)
 		{
-			mElse = Find("Else")->Get<Scope*>();
-			if (mElse == nullptr)
+			ResolveBranch(mElse, "Else").Update(worldState);
+		}
+	}
+
+
+
+
+	void ActionListIf::OnChildAdopted(Scope& child, const std::string& key)
+	{
+		ActionList::OnChildAdopted(child, key);
+
+		if ((key == "Then") && (mThen == nullptr))
+		{
+			mThen = &child;
+		}
+		else if ((key == "Else") && (mElse == nullptr))
+		{
+			mElse = &child;
+		}
+	}
+
+
+
+
+	void ActionListIf::OnChildOrphaned(Scope& child)
+	{
+		ActionList::OnChildOrphaned(child);
+
+		if (mThen == &child)
+		{
+			mThen = nullptr;
+		}
+		else if (mElse == &child)
+		{
+			mElse = nullptr;
+		}
+	}
+
+
+
+
+	Action& ActionListIf::ResolveBranch(Scope*& branch, const std::string& key)
+	{
+		if (branch == nullptr)
+		{
+			const Datum* datum = Find(key);
+			if ((datum != nullptr) && (datum->Size() > 0))
 			{
-				throw std::exception("Invalid Action List If.");
+				branch = datum->Get<Scope*>();
 			}
-			mElse->As<Action>()->Update(worldState);
 		}
+
+		Action* action = (branch != nullptr) ? branch->As<Action>() : nullptr;
+		if (action == nullptr)
+		{
+			throw std::exception("Invalid Action List If.");
+		}
+
+		return *action;
 	}
 
 
@@ -125,16 +171,6 @@ namespace FieaGameEngine
 		Append("Else");
 		AddToPrescribedAttributes("Then");
 		AddToPrescribedAttributes("Else");
-		AddExternalPrescribedAttribute("Condition", &mCondition, 1);
-	}
-
-
-
-
-	void ActionListIf::UpdatePrescribedAttributes()
-	{
-		(*this)["Condition"].SetStorage(&mCondition, 1);
-		Find("Then")->Get<Scope*>() = mThen;
-		Find("Else")->Get<Scope*>() = mElse;
+		AddExternalPrescribedAttribute("Condition", &ActionListIf::mCondition);
 	}
 }
\ No newline at end of file
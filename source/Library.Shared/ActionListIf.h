@@ -87,18 +87,37 @@ namespace FieaGameEngine
 		*/
 		void InitializeAttributes() override;
 
+	protected:
+
+		/**
+		*	@brief	Method that remembers the branches as they are adopted, on top of what the action
+		*			list does. Overriden from the ActionList class.
+		*	@param	child the adopted child
+		*	@param	key the key that the child was adopted under
+		*/
+		virtual void OnChildAdopted(Scope& child, const std::string& key) override;
+
 		/**
-		*	@brief	Method to update the list of prescribed attributes whenever
-		*			the list is reinitialized. Overriden from the Attributed class.
+		*	@brief	Method that forgets a branch that leaves the action list, on top of what the action
+		*			list does. Overriden from the ActionList class.
+		*	@param	child the child that left
 		*/
-		void UpdatePrescribedAttributes() override;
+		virtual void OnChildOrphaned(Scope& child) override;
 
 	private:
 
+		/**
+		*	@brief	Helper method to get a branch, looking it up if it is not known yet, e.g. after a copy.
+		*	@param	branch the remembered branch
+		*	@param	key the key of the branch
+		*	@return	reference to the action of the branch
+		*/
+		Action& ResolveBranch(Scope*& branch, const std::string& key);
+
 		std::int32_t mCondition;		/**<	integer representing the condition	*/
 
-		Scope* mThen;					/**<	Scope pointer to the then branch	*/
-		Scope* mElse;					/**<	Scope pointer to the else branch	*/
+		Scope* mThen;					/**<	Scope pointer to the then branch, remembered when it is adopted	*/
+		Scope* mElse;					/**<	Scope pointer to the else branch, remembered when it is adopted	*/
 
 	};
 
@@ -10,7 +10,7 @@ namespace FieaGameEngine
 
 	ActionPrint::ActionPrint(const std::string& name) : Action::Action(name)
 	{
-		InitializeAttributes();
+		InitializePrescribedAttributes();
 	}
 
 
@@ -70,7 +70,9 @@ namespace FieaGameEngine
 	{
 		worldState.CurrentAction = this;
 
-		mLog = Find("Log")->Get<std::string>();
+		//the log is read through a const Datum, so that printing it does not mark the action as changed
+		const Datum* log = Find("Log");
+		mLog = log->Get<std::string>();
 		OutputDebugStringA(mLog.c_str());
 	}
 
@@ -87,15 +89,7 @@ namespace FieaGameEngine
 
 	void ActionPrint::InitializeAttributes()
 	{
-		AddExternalPrescribedAttribute("Log", &mLog, 1);
-	}
-
-
-
-
-	void ActionPrint::UpdatePrescribedAttributes()
-	{
-		(*this)["Log"].SetStorage(&mLog, 1);
+		AddExternalPrescribedAttribute("Log", &ActionPrint::mLog);
 	}
 
 }
\ No newline at end of file
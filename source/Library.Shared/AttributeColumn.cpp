@@ -0,0 +1,271 @@
+#include "pch.h"
+#include "AttributeColumn.h"
+#include "Scope.h"
+
+
+namespace FieaGameEngine
+{
+
+	AttributeColumn::AttributeColumn(const std::string& key, const EDatumType type, const std::uint32_t capacity) : mKey(key), mType(type), mElementSize(0), mData(nullptr), mCapacity(0)
+	{
+		switch (type)
+		{
+		case EDatumType::EInteger:
+			mElementSize = sizeof(std::int32_t);
+			break;
+		case EDatumType::EFloat:
+			mElementSize = sizeof(std::float_t);
+			break;
+		case EDatumType::EVector4:
+			mElementSize = sizeof(glm::vec4);
+			break;
+		case EDatumType::EMatrix4x4:
+			mElementSize = sizeof(glm::mat4x4);
+			break;
+		default:
+			throw std::exception("Unsupported column type.");
+		}
+
+		Reserve(capacity);
+	}
+
+
+
+
+	AttributeColumn::~AttributeColumn()
+	{
+		for (std::uint32_t i = 0; i < mDatums.Size(); ++i)
+		{
+			mDatums[i]->ConvertToInternalStorage();
+		}
+
+		free(mData);
+	}
+
+
+
+
+	const std::string& AttributeColumn::Key() const
+	{
+		return mKey;
+	}
+
+
+
+
+	EDatumType AttributeColumn::Type() const
+	{
+		return mType;
+	}
+
+
+
+
+	std::uint32_t AttributeColumn::Size() const
+	{
+		return mDatums.Size();
+	}
+
+
+
+
+	bool AttributeColumn::Bind(Scope& owner)
+	{
+		Datum* datum = owner.Find(mKey);
+		if ((datum == nullptr) || (datum->Type() != mType) || (datum->Size() != 1))
+		{
+			return false;
+		}
+
+		if (!datum->mIsInternalStorage && (datum->mData.vp >= mData) && (datum->mData.vp < Slot(mDatums.Size())))
+		{
+			std::uint32_t index = static_cast<std::uint32_t>((static_cast<char*>(datum->mData.vp) - mData) / mElementSize);
+			if (mDatums[index] == datum)
+			{
+				return true;
+			}
+		}
+
+		//external storage belongs to someone else, e.g. a member of the owner, so only internal values are moved in
+		if (!datum->mIsInternalStorage)
+		{
+			return false;
+		}
+
+		if (mDatums.Size() == mCapacity)
+		{
+			Reserve((mCapacity == 0) ? 8 : (mCapacity * 2));
+		}
+
+		char* slot = Slot(mDatums.Size());
+		memcpy_s(slot, mElementSize, datum->mData.vp, mElementSize);
+		datum->ConvertToExternalStorage(slot);
+		mDatums.PushBack(datum);
+
+		return true;
+	}
+
+
+
+
+	bool AttributeColumn::Unbind(Scope& owner)
+	{
+		Datum* datum = owner.Find(mKey);
+		if ((datum == nullptr) || datum->mIsInternalStorage || (datum->mData.vp < mData) || (datum->mData.vp >= Slot(mDatums.Size())))
+		{
+			return false;
+		}
+
+		std::uint32_t index = static_cast<std::uint32_t>((static_cast<char*>(datum->mData.vp) - mData) / mElementSize);
+		datum->ConvertToInternalStorage();
+
+		if (mDatums[index] != datum)
+		{
+			return false;
+		}
+
+		std::uint32_t last = mDatums.Size() - 1;
+		if (index != last)
+		{
+			memcpy_s(Slot(index), mElementSize, Slot(last), mElementSize);
+			mDatums[index] = mDatums[last];
+			mDatums[index]->RebindStorage(Slot(index));
+		}
+		mDatums.PopBack();
+
+		return true;
+	}
+
+
+
+
+	std::int32_t* AttributeColumn::Integers()
+	{
+		CheckType(EDatumType::EInteger);
+		MarkChanged();
+		return reinterpret_cast<std::int32_t*>(mData);
+	}
+
+
+
+
+	const std::int32_t* AttributeColumn::Integers() const
+	{
+		CheckType(EDatumType::EInteger);
+		return reinterpret_cast<const std::int32_t*>(mData);
+	}
+
+
+
+
+	std::float_t* AttributeColumn::Floats()
+	{
+		CheckType(EDatumType::EFloat);
+		MarkChanged();
+		return reinterpret_cast<std::float_t*>(mData);
+	}
+
+
+
+
+	const std::float_t* AttributeColumn::Floats() const
+	{
+		CheckType(EDatumType::EFloat);
+		return reinterpret_cast<const std::float_t*>(mData);
+	}
+
+
+
+
+	glm::vec4* AttributeColumn::Vectors()
+	{
+		CheckType(EDatumType::EVector4);
+		MarkChanged();
+		return reinterpret_cast<glm::vec4*>(mData);
+	}
+
+
+
+
+	const glm::vec4* AttributeColumn::Vectors() const
+	{
+		CheckType(EDatumType::EVector4);
+		return reinterpret_cast<const glm::vec4*>(mData);
+	}
+
+
+
+
+	glm::mat4x4* AttributeColumn::Matrices()
+	{
+		CheckType(EDatumType::EMatrix4x4);
+		MarkChanged();
+		return reinterpret_cast<glm::mat4x4*>(mData);
+	}
+
+
+
+
+	const glm::mat4x4* AttributeColumn::Matrices() const
+	{
+		CheckType(EDatumType::EMatrix4x4);
+		return reinterpret_cast<const glm::mat4x4*>(mData);
+	}
+
+
+
+
+	char* AttributeColumn::Slot(const std::uint32_t index) const
+	{
+		return mData + (index * mElementSize);
+	}
+
+
+
+
+	void AttributeColumn::CheckType(const EDatumType type) const
+	{
+		if (mType != type)
+		{
+			throw std::exception("Column type mismatch.");
+		}
+	}
+
+
+
+
+	void AttributeColumn::MarkChanged()
+	{
+		for (std::uint32_t i = 0; i < mDatums.Size(); ++i)
+		{
+			mDatums[i]->MarkChanged();
+		}
+	}
+
+
+
+
+	void AttributeColumn::Reserve(const std::uint32_t capacity)
+	{
+		if (capacity <= mCapacity)
+		{
+			return;
+		}
+
+		char* data = static_cast<char*>(realloc(mData, capacity * mElementSize));
+		if (data == nullptr)
+		{
+			throw std::exception("Unable to grow the column.");
+		}
+
+		mData = data;
+		mCapacity = capacity;
+		mDatums.Reserve(capacity);
+
+		for (std::uint32_t i = 0; i < mDatums.Size(); ++i)
+		{
+			mDatums[i]->RebindStorage(Slot(i));
+		}
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,184 @@
+#pragma once
+
+#include "Vector.h"
+#include "Datum.h"
+
+/**
+*	@brief	The namespace under which the game engine is implemented.
+*/
+namespace FieaGameEngine
+{
+	/**
+	*	@brief	The AttributeColumn class stores one numeric attribute of many Scopes in a single
+	*			contiguous array, i.e. as a column of a structure of arrays. Binding a Scope moves
+	*			the value of its Datum into a slot of the column and switches the Datum to external
+	*			storage pointing at that slot, so scripts still see a normal Datum through Find,
+	*			while systems can run linear loops over the whole column. The Datums are rebound
+	*			whenever the column grows or a slot is moved, without looking them up again. Since
+	*			writes through the column bypass the Datums, handing it out for writing marks all
+	*			the bound Scopes as changed, and the const versions are there for reading.
+	*/
+	class AttributeColumn final
+	{
+
+	public:
+
+		/**
+		*	@brief	Parameterized constructor that creates an empty column.
+		*	@param	key the key of the attribute that is stored in the column
+		*	@param	type the type of the attribute. Only integers, floats, vectors and matrices are supported
+		*	@param	capacity the number of slots to allocate up front
+		*/
+		AttributeColumn(const std::string& key, const EDatumType type, const std::uint32_t capacity = 0);
+
+		/**
+		*	@brief	The copy constructor is deleted.
+		*/
+		AttributeColumn(const AttributeColumn& other) = delete;
+
+		/**
+		*	@brief	The move constructor is deleted, since the bound Datums point into the column.
+		*/
+		AttributeColumn(AttributeColumn&& other) = delete;
+
+		/**
+		*	@brief	The copy assignment operator is deleted.
+		*/
+		AttributeColumn& operator=(const AttributeColumn& other) = delete;
+
+		/**
+		*	@brief	The move assignment operator is deleted.
+		*/
+		AttributeColumn& operator=(AttributeColumn&& other) = delete;
+
+		/**
+		*	@brief	The destructor gives every Datum that is still bound its own storage back,
+		*			and frees the column.
+		*/
+		~AttributeColumn();
+
+		/**
+		*	@brief	Method to get the key of the attribute that is stored in the column.
+		*	@return	const reference to the key
+		*/
+		const std::string& Key() const;
+
+		/**
+		*	@brief	Method to get the type of the attribute that is stored in the column.
+		*	@return	the type of the column
+		*/
+		EDatumType Type() const;
+
+		/**
+		*	@brief	Method to get the number of bound Datums, which is also the number of used slots.
+		*	@return	unsigned int representing the size of the column
+		*/
+		std::uint32_t Size() const;
+
+		/**
+		*	@brief	Method to bind the attribute of a Scope to the column. The attribute must be a
+		*			single element of the type of the column in internal storage, otherwise nothing
+		*			happens.
+		*	@param	owner the Scope that contains the attribute
+		*	@return	bool indicating whether the attribute is bound to the column
+		*/
+		bool Bind(Scope& owner);
+
+		/**
+		*	@brief	Method to unbind the attribute of a Scope from the column. The Datum gets its own
+		*			storage back with the current value, and the last slot is moved into the freed
+		*			one. A Datum that merely aliases a slot, as the copy of a bound Scope does, also
+		*			gets its own storage, and the column is left unchanged.
+		*	@param	owner the Scope that contains the attribute
+		*	@return	bool indicating whether the attribute was bound to the column
+		*/
+		bool Unbind(Scope& owner);
+
+		/**
+		*	@brief	Method to get the column of an integer attribute for writing, which marks all the
+		*			bound Scopes as changed.
+		*	@return	pointer to the first element of the column
+		*/
+		std::int32_t* Integers();
+
+		/**
+		*	@brief	Method to get the column of an integer attribute for reading.
+		*	@return	const pointer to the first element of the column
+		*/
+		const std::int32_t* Integers() const;
+
+		/**
+		*	@brief	Method to get the column of a float attribute for writing, which marks all the
+		*			bound Scopes as changed.
+		*	@return	pointer to the first element of the column
+		*/
+		std::float_t* Floats();
+
+		/**
+		*	@brief	Method to get the column of a float attribute for reading.
+		*	@return	const pointer to the first element of the column
+		*/
+		const std::float_t* Floats() const;
+
+		/**
+		*	@brief	Method to get the column of a vector attribute for writing, which marks all the
+		*			bound Scopes as changed.
+		*	@return	pointer to the first element of the column
+		*/
+		glm::vec4* Vectors();
+
+		/**
+		*	@brief	Method to get the column of a vector attribute for reading.
+		*	@return	const pointer to the first element of the column
+		*/
+		const glm::vec4* Vectors() const;
+
+		/**
+		*	@brief	Method to get the column of a matrix attribute for writing, which marks all the
+		*			bound Scopes as changed.
+		*	@return	pointer to the first element of the column
+		*/
+		glm::mat4x4* Matrices();
+
+		/**
+		*	@brief	Method to get the column of a matrix attribute for reading.
+		*	@return	const pointer to the first element of the column
+		*/
+		const glm::mat4x4* Matrices() const;
+
+	private:
+
+		/**
+		*	@brief	Helper method to get the address of a slot.
+		*	@param	index the index of the slot
+		*	@return	pointer to the slot
+		*/
+		char* Slot(const std::uint32_t index) const;
+
+		/**
+		*	@brief	Helper method to check that the column stores the given type before handing it out.
+		*	@param	type the type that is expected
+		*/
+		void CheckType(const EDatumType type) const;
+
+		/**
+		*	@brief	Helper method that marks the Scopes of all the bound Datums as changed.
+		*/
+		void MarkChanged();
+
+		/**
+		*	@brief	Helper method to grow the column, rebinding every bound Datum to its moved slot.
+		*	@param	capacity the new number of slots
+		*/
+		void Reserve(const std::uint32_t capacity);
+
+		std::string mKey;						/**<	The key of the attribute stored in the column	*/
+		EDatumType mType;						/**<	The type of the attribute stored in the column	*/
+		size_t mElementSize;					/**<	The size of one slot in bytes	*/
+		char* mData;							/**<	The column itself	*/
+		std::uint32_t mCapacity;				/**<	The number of allocated slots	*/
+		Vector<Datum*> mDatums;					/**<	The bound Datums, indexed by their slots	*/
+
+	};
+
+}
\ No newline at end of file
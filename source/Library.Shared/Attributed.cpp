@@ -9,20 +9,23 @@ namespace FieaGameEngine
 
 
 
-	HashMap<std::uint64_t, Vector<std::string>> Attributed::mPrescribedAttributes(50);
+	std::atomic<const Attributed::TypeEntry*> Attributed::mTypeBuckets[Attributed::TypeBucketCount];
+	SList<Attributed::TypeEntry> Attributed::mTypeEntries;
+	std::mutex Attributed::mSchemaMutex;
+	const std::uint32_t Attributed::InvalidIndex = std::numeric_limits<std::uint32_t>::max();
 
 
 
 
-	Attributed::Attributed() : Scope::Scope()
+	Attributed::Attributed() : Scope::Scope(), mSchema(nullptr), mRegistration(nullptr)
 	{
-		(*this)["this"] = static_cast<RTTI*>(this);
+		InitializePrescribedAttributes();
 	}
 
 
 
 
-	Attributed::Attributed(const Attributed& other) : Scope::Scope(other)
+	Attributed::Attributed(const Attributed& other) : Scope::Scope(other), mSchema(other.mSchema.load(std::memory_order_acquire)), mRegistration(nullptr)
 	{
 		(*this)["this"] = static_cast<RTTI*>(this);
 	}
@@ -30,7 +33,7 @@ namespace FieaGameEngine
 
 
 
-	Attributed::Attributed(Attributed&& other) : Scope::Scope(std::move(other))
+	Attributed::Attributed(Attributed&& other) : Scope::Scope(std::move(other)), mSchema(other.mSchema.load(std::memory_order_acquire)), mRegistration(nullptr)
 	{
 		(*this)["this"] = static_cast<RTTI*>(this);
 	}
@@ -46,6 +49,42 @@ namespace FieaGameEngine
 
 
 
+	Handle Attributed::GetHandle() const
+	{
+		if (!mHandle.IsValid())
+		{
+			HandleTable::Register(const_cast<Attributed&>(*this), mHandle);
+		}
+
+		return mHandle;
+	}
+
+
+
+
+	void Attributed::Detach()
+	{
+		Scope* parent = GetParent();
+		if (parent != nullptr)
+		{
+			parent->OrphanChild(*this);
+		}
+	}
+
+
+
+
+	Attributed::~Attributed()
+	{
+		if (mHandle.IsValid())
+		{
+			HandleTable::Release(mHandle);
+		}
+	}
+
+
+
+
 	Attributed& Attributed::operator=(const Attributed& other)
 	{
 		if (this != &other)
@@ -89,19 +128,7 @@ namespace FieaGameEngine
 
 	bool Attributed::IsPrescribedAttribute(const std::string& key) const
 	{
-		auto it = mPrescribedAttributes.Find(TypeIdInstance());
-		if (it != mPrescribedAttributes.end())
-		{
-			Vector<std::string>& foundVector = it.operator*().second;
-
-			if (foundVector.Find(key) != foundVector.end())
-			{
-				return true;
-			}
-
-		}
-
-		return false;
+		return IsPrescribedDatum(key, Find(key));
 	}
 
 
@@ -109,7 +136,8 @@ namespace FieaGameEngine
 
 	bool Attributed::IsAuxiliaryAttribute(const std::string& key) const
 	{
-		return ((IsAttribute(key)) && !(IsPrescribedAttribute(key)));
+		const Datum* datum = Find(key);
+		return ((datum != nullptr) && !(IsPrescribedDatum(key, datum)));
 	}
 
 
@@ -135,42 +163,36 @@ namespace FieaGameEngine
 
 
 
-	Vector<std::pair<std::string, Datum>*> Attributed::GetPrescribedAttributes() const
+	Attributed::AttributeView Attributed::GetPrescribedAttributes() const
 	{
-		Vector<std::pair<std::string, Datum>*> prescribedAttributes = mPointersToLookupTable;
+		std::uint32_t layoutSize = (std::min)(GetSchema().mLayoutSize, mPointersToLookupTable.Size());
+		return AttributeView(mPointersToLookupTable, 0, layoutSize);
+	}
 
-		auto& prescribedAttributeKeys = mPrescribedAttributes.Find(TypeIdInstance()).operator*().second;
 
-		for (std::int32_t i = (prescribedAttributes.Size() - 1); i >= 0; --i)
-		{
-			if (prescribedAttributeKeys.Find(prescribedAttributes[i]->first) == prescribedAttributeKeys.end())
-			{
-				prescribedAttributes.Remove(prescribedAttributes[i]);
-			}
-		}
 
-		return prescribedAttributes;
 
+	Attributed::AttributeView Attributed::GetAuxiliaryAttributes() const
+	{
+		std::uint32_t layoutSize = (std::min)(GetSchema().mLayoutSize, mPointersToLookupTable.Size());
+		return AttributeView(mPointersToLookupTable, layoutSize, mPointersToLookupTable.Size());
 	}
 
 
 
 
-	Vector<std::pair<std::string, Datum>*> Attributed::GetAuxiliaryAttributes() const
+	const std::vector<Attributed::FieldDescriptor>& Attributed::GetPrescribedFields() const
 	{
-		Vector<std::pair<std::string, Datum>*> auxiliaryAttributes = mPointersToLookupTable;
+		return GetSchema().mFields;
+	}
+
 
-		auto& prescribedAttributeKeys = mPrescribedAttributes.Find(TypeIdInstance()).operator*().second;
 
-		for (std::int32_t i = (auxiliaryAttributes.Size() - 1); i >= 0; --i)
-		{
-			if (prescribedAttributeKeys.Find(auxiliaryAttributes[i]->first) != prescribedAttributeKeys.end())
-			{
-				auxiliaryAttributes.Remove(auxiliaryAttributes[i]);
-			}
-		}
 
-		return auxiliaryAttributes;
+	const std::vector<Attributed::FieldDescriptor>* Attributed::FindPrescribedFields(const std::uint64_t typeId)
+	{
+		const TypeEntry* entry = FindType(typeId);
+		return (entry != nullptr) ? &entry->mSchema.mFields : nullptr;
 	}
 
 
@@ -343,16 +365,345 @@ namespace FieaGameEngine
 
 	void Attributed::AddToPrescribedAttributes(const std::string& name)
 	{
-		auto it = mPrescribedAttributes.Find(TypeIdInstance());
-		if (it == mPrescribedAttributes.end())
+		if (mRegistration == nullptr)
+		{
+			return;
+		}
+
+		const Datum* datum = Find(name);
+		if (datum == nullptr)
+		{
+			RegisterField(name, EDatumType::EUnknown, 0, false);
+		}
+		else
+		{
+			RegisterField(name, datum->Type(), datum->Size(), datum->IsExternalStorage());
+		}
+	}
+
+
+
+
+	void Attributed::InitializePrescribedAttributes()
+	{
+		std::uint64_t typeId = TypeIdInstance();
+
+		const TypeEntry* entry = FindType(typeId);
+		if (entry != nullptr)
+		{
+			InitializeAttributes();
+		}
+		else
+		{
+			//the first construction of a type records what it registers, without holding the lock while it runs
+			TypeEntry registeredEntry;
+			registeredEntry.mNext = nullptr;
+			mRegistration = &registeredEntry.mDescriptor;
+			InitializeAttributes();
+			mRegistration = nullptr;
+
+			CompileSchema(registeredEntry.mSchema, &registeredEntry.mDescriptor);
+
+			std::lock_guard<std::mutex> lock(mSchemaMutex);
+			entry = &PublishType(typeId, registeredEntry);
+		}
+
+		mSchema.store(&entry->mSchema, std::memory_order_release);
+	}
+
+
+
+
+	void Attributed::RegisterField(const std::string& name, const EDatumType type, const std::uint32_t size, const bool isExternal)
+	{
+		if (mRegistration == nullptr)
+		{
+			return;
+		}
+
+		if (FindField(mRegistration->mFields, name) == InvalidIndex)
+		{
+			mRegistration->mFields.push_back({ name, type, size, InvalidIndex, isExternal });
+		}
+	}
+
+
+
+
+	void Attributed::AddFieldBinding(const std::string& name, const void* field, const bool isDatumReference)
+	{
+		if (mRegistration == nullptr)
+		{
+			return;
+		}
+
+		for (auto& binding : mRegistration->mBindings)
+		{
+			if (binding.mKey == name)
+			{
+				return;
+			}
+		}
+
+		FieldBinding binding;
+		binding.mKey = name;
+		binding.mIndex = InvalidIndex;
+		binding.mOffset = static_cast<const char*>(field) - reinterpret_cast<const char*>(this);
+		binding.mIsDatumReference = isDatumReference;
+		mRegistration->mBindings.push_back(std::move(binding));
+	}
+
+
+
+
+	bool Attributed::IsPrescribedDatum(const std::string& key, const Datum* datum) const
+	{
+		const Schema& schema = GetSchema();
+
+		//the layout attributes are found by comparing addresses, so their keys are never hashed or compared
+		if (datum != nullptr)
+		{
+			std::uint32_t layoutSize = (std::min)(schema.mLayoutSize, mPointersToLookupTable.Size());
+			for (std::uint32_t i = 0; i < layoutSize; ++i)
+			{
+				if (&mPointersToLookupTable[i]->second == datum)
+				{
+					return true;
+				}
+			}
+		}
+
+		for (std::uint32_t i = schema.mLayoutSize; i < schema.mFields.size(); ++i)
+		{
+			if (schema.mFields[i].mKey == key)
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+
+
+
+	const Attributed::Schema& Attributed::GetSchema() const
+	{
+		const Schema* schema = mSchema.load(std::memory_order_acquire);
+		if ((schema != nullptr) && (schema->mTypeId == TypeIdInstance()))
+		{
+			return *schema;
+		}
+
+		const TypeEntry* entry = FindType(TypeIdInstance());
+		if (entry == nullptr)
+		{
+			//a type that registers nothing of its own is published the first time its schema is asked for
+			TypeEntry compiledEntry;
+			compiledEntry.mNext = nullptr;
+			CompileSchema(compiledEntry.mSchema, nullptr);
+
+			std::lock_guard<std::mutex> lock(mSchemaMutex);
+			entry = &PublishType(TypeIdInstance(), compiledEntry);
+		}
+
+		mSchema.store(&entry->mSchema, std::memory_order_release);
+		return entry->mSchema;
+	}
+
+
+
+
+	void Attributed::CompileSchema(Schema& schema, const TypeDescriptor* descriptor) const
+	{
+		std::uint64_t typeId = TypeIdInstance();
+
+		//the descriptors are gathered from the root of the hierarchy down, the way the constructors run
+		Vector<const TypeDescriptor*> descriptors;
+		const Ancestry& ancestry = InstanceAncestry();
+		for (std::uint32_t i = 0; i < ancestry.mDepth; ++i)
+		{
+			if ((ancestry.mIds[i] == typeId) && (descriptor != nullptr))
+			{
+				descriptors.PushBack(descriptor);
+				continue;
+			}
+
+			const TypeEntry* entry = FindType(ancestry.mIds[i]);
+			if (entry != nullptr)
+			{
+				descriptors.PushBack(&entry->mDescriptor);
+			}
+		}
+
+		std::vector<FieldDescriptor> registeredFields;
+		for (auto& typeDescriptor : descriptors)
+		{
+			for (auto& field : typeDescriptor->mFields)
+			{
+				if (FindField(registeredFields, field.mKey) == InvalidIndex)
+				{
+					registeredFields.push_back(field);
+				}
+			}
+		}
+
+		schema.mLayoutSize = 0;
+		schema.mTypeId = typeId;
+
+		for (std::uint32_t i = 0; i < mPointersToLookupTable.Size(); ++i)
+		{
+			const std::string& key = mPointersToLookupTable[i]->first;
+			std::uint32_t registeredIndex = FindField(registeredFields, key);
+			if (registeredIndex == InvalidIndex)
+			{
+				break;
+			}
+
+			FieldDescriptor field = registeredFields[registeredIndex];
+			field.mIndex = i;
+			schema.mFields.push_back(std::move(field));
+			++schema.mLayoutSize;
+		}
+
+		//registered keys that the instance never appended are still prescribed, they just are not part of the layout
+		for (auto& field : registeredFields)
+		{
+			if (FindField(schema.mFields, field.mKey) == InvalidIndex)
+			{
+				schema.mFields.push_back(field);
+			}
+		}
+
+		//the bound members of the ancestors are gathered the same way, and their keys are resolved to layout indices once
+		for (auto& typeDescriptor : descriptors)
+		{
+			for (auto binding : typeDescriptor->mBindings)
+			{
+				std::uint32_t index = FindField(schema.mFields, binding.mKey);
+				binding.mIndex = (index < schema.mLayoutSize) ? index : InvalidIndex;
+				schema.mBindings.push_back(std::move(binding));
+			}
+		}
+	}
+
+
+
+
+	std::uint32_t Attributed::FindField(const std::vector<FieldDescriptor>& fields, const std::string& key)
+	{
+		for (std::uint32_t i = 0; i < fields.size(); ++i)
+		{
+			if (fields[i].mKey == key)
+			{
+				return i;
+			}
+		}
+
+		return InvalidIndex;
+	}
+
+
+
+
+	const Attributed::TypeEntry* Attributed::FindType(const std::uint64_t typeId)
+	{
+		//the links of an entry are set before it is published, and are never changed after
+		for (const TypeEntry* entry = TypeBucket(typeId).load(std::memory_order_acquire); entry != nullptr; entry = entry->mNext)
+		{
+			if (entry->mSchema.mTypeId == typeId)
+			{
+				return entry;
+			}
+		}
+
+		return nullptr;
+	}
+
+
+
+
+	const Attributed::TypeEntry& Attributed::PublishType(const std::uint64_t typeId, const TypeEntry& entry)
+	{
+		const TypeEntry* publishedEntry = FindType(typeId);
+		if (publishedEntry != nullptr)
 		{
-			it = mPrescribedAttributes.Insert(std::make_pair(TypeIdInstance(), Vector<std::string>()));
+			return *publishedEntry;
 		}
 
-		if ((*it).second.Find(name) == (*it).second.end())
+		//readers may be walking the bucket, which stays valid since the new entry only links to its old head
+		std::atomic<const TypeEntry*>& bucket = TypeBucket(typeId);
+		mTypeEntries.PushBack(entry);
+		TypeEntry& newEntry = mTypeEntries.Back();
+		newEntry.mNext = bucket.load(std::memory_order_relaxed);
+		bucket.store(&newEntry, std::memory_order_release);
+
+		return newEntry;
+	}
+
+
+
+
+	std::atomic<const Attributed::TypeEntry*>& Attributed::TypeBucket(const std::uint64_t typeId)
+	{
+		return mTypeBuckets[Datum::MixHash(typeId) & (TypeBucketCount - 1)];
+	}
+
+
+
+
+	Attributed::AttributeView::AttributeView(const Vector<std::pair<std::string, Datum>*>& attributes, const std::uint32_t first, const std::uint32_t last) : mFirst(nullptr), mLast(nullptr)
+	{
+		if (first < last)
+		{
+			mFirst = &attributes[first];
+			mLast = mFirst + (last - first);
+		}
+	}
+
+
+
+
+	std::pair<std::string, Datum>* const* Attributed::AttributeView::begin() const
+	{
+		return mFirst;
+	}
+
+
+
+
+	std::pair<std::string, Datum>* const* Attributed::AttributeView::end() const
+	{
+		return mLast;
+	}
+
+
+
+
+	std::uint32_t Attributed::AttributeView::Size() const
+	{
+		return static_cast<std::uint32_t>(mLast - mFirst);
+	}
+
+
+
+
+	bool Attributed::AttributeView::IsEmpty() const
+	{
+		return (mFirst == mLast);
+	}
+
+
+
+
+	std::pair<std::string, Datum>* Attributed::AttributeView::operator[](const std::uint32_t index) const
+	{
+		if (index >= Size())
 		{
-			(*it).second.PushBack(name);
+			throw std::exception("Index out of bounds.");
 		}
+
+		return mFirst[index];
 	}
 
 
@@ -360,7 +711,8 @@ namespace FieaGameEngine
 
 	void Attributed::InitializeAttributes()
 	{
-		//do nothing
+		Append("this") = static_cast<RTTI*>(this);
+		AddToPrescribedAttributes("this");
 	}
 
 
@@ -368,7 +720,35 @@ namespace FieaGameEngine
 
 	void Attributed::UpdatePrescribedAttributes()
 	{
-		//do nothing
+		const Schema& schema = GetSchema();
+		char* base = reinterpret_cast<char*>(this);
+
+		for (auto& binding : schema.mBindings)
+		{
+			//the layout index is only trusted while the attribute at it still has the key, e.g. not after an instance was assigned another layout
+			Datum* datum;
+			if ((binding.mIndex < mPointersToLookupTable.Size()) && (mPointersToLookupTable[binding.mIndex]->first == binding.mKey))
+			{
+				datum = &mPointersToLookupTable[binding.mIndex]->second;
+			}
+			else
+			{
+				datum = Find(binding.mKey);
+				if (datum == nullptr)
+				{
+					continue;
+				}
+			}
+
+			if (binding.mIsDatumReference)
+			{
+				*reinterpret_cast<Datum**>(base + binding.mOffset) = datum;
+			}
+			else
+			{
+				datum->RebindStorage(base + binding.mOffset);
+			}
+		}
 	}
 
 }
\ No newline at end of file
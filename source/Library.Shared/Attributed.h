@@ -4,6 +4,8 @@
 #include "Vector.h"
 #include "HashMap.h"
 #include "Scope.h"
+#include "HandleTable.h"
+#include <vector>
 
 /**
 *	@brief	The namespace under which the game engine is implemented.
@@ -12,8 +14,8 @@ namespace FieaGameEngine
 {
 	/**
 	*	@brief	The default hash function for an unsigned 64-bit integer.
-	*			This functor is defined to be used in the static hashmap
-	*			that keeps track of the prescribed attributes.
+	*			This functor is defined to be used in the hashmaps that
+	*			are keyed by the instance ids of types.
 	*/
 	template<>
 	class DefaultHashFunction<std::uint64_t>
@@ -36,7 +38,81 @@ namespace FieaGameEngine
 
 		RTTI_DECLARATIONS(Attributed, Scope)
 
+		friend class DeferredDestroyer;		//DeferredDestroyer is allowed to kill the handle of an object it is about to destroy
+		friend class CommandBuffer;			//CommandBuffer is allowed to detach the objects that it moves
+
 	public:
+
+		/**
+		*	@brief	AttributeView is a read-only view over a contiguous run of the attributes of an
+		*			Attributed. The prescribed and auxiliary attribute getters return views instead
+		*			of copying the attribute list. A view is invalidated when attributes are appended.
+		*/
+		class AttributeView final
+		{
+
+		public:
+
+			/**
+			*	@brief	Parameterized constructor that creates a view over a range of an attribute list.
+			*	@param	attributes the attribute list of the Attributed
+			*	@param	first index of the first attribute in the view
+			*	@param	last index one past the last attribute in the view
+			*/
+			AttributeView(const Vector<std::pair<std::string, Datum>*>& attributes, const std::uint32_t first, const std::uint32_t last);
+
+			/**
+			*	@brief	Method to get the beginning of the view, so that it can be used in range based for loops.
+			*	@return	pointer to the first attribute in the view
+			*/
+			std::pair<std::string, Datum>* const* begin() const;
+
+			/**
+			*	@brief	Method to get the end of the view, so that it can be used in range based for loops.
+			*	@return	pointer one past the last attribute in the view
+			*/
+			std::pair<std::string, Datum>* const* end() const;
+
+			/**
+			*	@brief	Method to get the number of attributes in the view.
+			*	@return	unsigned int representing the number of attributes
+			*/
+			std::uint32_t Size() const;
+
+			/**
+			*	@brief	Method to check whether the view is empty.
+			*	@return	bool indicating whether the view is empty
+			*/
+			bool IsEmpty() const;
+
+			/**
+			*	@brief	This operator overload returns the attribute at the given index of the view.
+			*	@param	index the index of the attribute in the view
+			*	@return	pointer to the string-Datum pair of the attribute
+			*/
+			std::pair<std::string, Datum>* operator[](const std::uint32_t index) const;
+
+		private:
+
+			std::pair<std::string, Datum>* const* mFirst;		/**<	Pointer to the first attribute in the view	*/
+			std::pair<std::string, Datum>* const* mLast;		/**<	Pointer one past the last attribute in the view	*/
+
+		};
+
+		/**
+		*	@brief	A FieldDescriptor describes a prescribed attribute of a type, so that tools can list
+		*			the attributes of a type without reading them off an instance.
+		*/
+		struct FieldDescriptor
+		{
+			std::string mKey;						/**<	The key of the prescribed attribute	*/
+			EDatumType mType;						/**<	The type of the attribute when it was registered	*/
+			std::uint32_t mSize;					/**<	The number of elements of the attribute when it was registered	*/
+			std::uint32_t mIndex;					/**<	Index of the attribute in the layout of an instance, or InvalidIndex if it is not part of it	*/
+			bool mIsExternal;						/**<	True if the attribute is stored in a member of the type	*/
+		};
+
+		static const std::uint32_t InvalidIndex;	/**<	Layout index of a prescribed attribute that is not part of the layout	*/
 		
 		/**
 		*	@brief	The default constructor initializes member variables.
@@ -126,20 +202,54 @@ namespace FieaGameEngine
 		const Vector<std::pair<std::string, Datum>*>& GetAttributes() const;
 
 		/**
-		*	@brief	Method to get the vector of prescribed attributes.
+		*	@brief	Method to get the prescribed attributes. Prescribed attributes are always appended
+		*			before any auxiliary one, so this is a view over the front of the attribute list.
+		*	@return	view over the prescribed attributes
+		*/
+		AttributeView GetPrescribedAttributes() const;
+
+		/**
+		*	@brief	Method to get the auxiliary attributes, which is a view over the attribute list
+		*			after the prescribed attributes.
+		*	@return	view over the auxiliary attributes
+		*/
+		AttributeView GetAuxiliaryAttributes() const;
+
+		/**
+		*	@brief	Method to get the descriptors of the prescribed attributes of the type of this
+		*			instance, including those of its ancestors. The attributes of the layout come first,
+		*			in the order they appear in an instance.
+		*	@return	const reference to the descriptors
+		*/
+		const std::vector<FieldDescriptor>& GetPrescribedFields() const;
+
+		/**
+		*	@brief	Static method to get the descriptors of the prescribed attributes of a type, once an
+		*			instance of the type has been constructed.
+		*	@param	typeId the instance id of the type
+		*	@return	pointer to the descriptors, or nullptr if no instance of the type has been constructed
+		*/
+		static const std::vector<FieldDescriptor>* FindPrescribedFields(const std::uint64_t typeId);
+
+		/**
+		*	@brief	Method to get a handle to the Attributed. The Attributed gets a slot in the handle table
+		*			the first time this is called, and keeps it until it is destroyed. Copies get their
+		*			own handles.
+		*	@return	the handle of the Attributed
 		*/
-		Vector<std::pair<std::string, Datum>*> GetPrescribedAttributes() const;
+		Handle GetHandle() const;
 
 		/**
-		*	@brief	Method to get the vector of auxiliary attributes.
+		*	@brief	Method to take the Attributed out of its parent, e.g. so that it can be destroyed
+		*			away from the thread that owns the parent. Derived classes release anything that
+		*			the parent keeps for them before calling this.
 		*/
-		Vector<std::pair<std::string, Datum>*> GetAuxiliaryAttributes() const;
+		virtual void Detach();
 
 		/**
-		*	@brief	The destructor is defaulted to ensure
-		*			there are no memory leaks.
+		*	@brief	The destructor kills the handle of the Attributed.
 		*/
-		virtual ~Attributed() = default;
+		virtual ~Attributed();
 
 	protected:
 
@@ -261,38 +371,207 @@ namespace FieaGameEngine
 		Datum* AddExternalPrescribedAttribute(const std::string& name, RTTI** externalData, const std::uint32_t size);
 
 		/**
-		*	@brief	Helper method to add the name to the static
-		*			hashmap that keeps track of the prescribed
-		*			attributes.
+		*	@brief	Method to add an external prescribed attribute that is bound to a member of the derived
+		*			class. The offset of the member is recorded once per type, so that copies and moves of
+		*			the object rebind the attribute to their own member without looking it up by name.
+		*	@param	name a const string that refers to the name of the prescribed attribute
+		*	@param	field pointer to the member of the derived class that stores the attribute
+		*	@param	size the number of elements stored starting at the member
+		*	@return	pointer to the Datum that is the prescribed attribute
+		*/
+		template <typename TDerived, typename TField>
+		Datum* AddExternalPrescribedAttribute(const std::string& name, TField TDerived::* field, const std::uint32_t size = 1);
+
+		/**
+		*	@brief	Method to add a prescribed attribute that holds nested scopes, and to bind a Datum pointer
+		*			member of the derived class to it. Like the external attributes, the member is rebound
+		*			by its offset whenever the object is copied or moved.
+		*	@param	name a const string that refers to the name of the prescribed attribute
+		*	@param	datumField pointer to the Datum pointer member of the derived class
+		*	@return	pointer to the Datum that is the prescribed attribute
+		*/
+		template <typename TDerived>
+		Datum* AddTablePrescribedAttribute(const std::string& name, Datum* TDerived::* datumField);
+
+		/**
+		*	@brief	Helper method to register a key as a
+		*			prescribed attribute of the type whose
+		*			constructor is running. Types are only
+		*			registered the first time they are
+		*			constructed, so this does nothing after.
 		*	@param	name the string key that corresponds to the
 		*			prescribed attribute.
 		*/
 		void AddToPrescribedAttributes(const std::string& name);
 
+		/**
+		*	@brief	Method that the constructors call to append
+		*			the prescribed attributes of their type, by
+		*			calling InitializeAttributes. The first time
+		*			a type is constructed, what it registers is
+		*			recorded as the descriptor of the type and
+		*			its schema is compiled. After that, the type
+		*			is found without locking and only appends.
+		*/
+		void InitializePrescribedAttributes();
+
 		/**
 		*	@brief	Method to initialize the attributes of
-		*			the class. It is a pure virtual function 
-		*			and is expected to be implemented in the
-		*			derived classes.
+		*			the class. It is expected to be implemented
+		*			in the derived classes, and is called by
+		*			InitializePrescribedAttributes.
 		*/
 		virtual void InitializeAttributes();
 
 		/**
 		*	@brief	Method to update the list of prescribed
-		*			attributes whenever the list is reinitialized.
-		*			It is a pure virtual function and is expected
-		*			to be implemented in the derived classes.
+		*			attributes whenever the list is reinitialized,
+		*			i.e. after a copy or a move. The members that
+		*			were bound through their offsets are rebound
+		*			to this object by pointer arithmetic. Derived
+		*			classes only need to override this for state
+		*			that cannot be bound that way.
 		*/
 		virtual void UpdatePrescribedAttributes();
 
+	private:
+
+		/**
+		*	@brief	A FieldBinding records where a member that backs a prescribed attribute lives in
+		*			an object, relative to the start of its Attributed base.
+		*/
+		struct FieldBinding
+		{
+			std::string mKey;						/**<	The key of the prescribed attribute	*/
+			std::uint32_t mIndex;					/**<	Index of the attribute in the layout of the schema, or InvalidIndex if it is not part of it	*/
+			std::ptrdiff_t mOffset;					/**<	Byte offset of the member from the Attributed base	*/
+			bool mIsDatumReference;					/**<	True if the member is a Datum pointer, false if it is the external storage of the attribute	*/
+		};
+
 		/**
-		*	@brief	The Attributed interface contains a static hashmap that is shared
-		*			by all the instances of all the derived classes of this interface.
-		*			This hashmap keeps track of all the prescribed attributes, hashed
-		*			based on the instance id of the different classes.
+		*	@brief	The attributes and members that one type registers in its own constructor, i.e. not
+		*			counting those of its ancestors.
 		*/
-		static HashMap<std::uint64_t, Vector<std::string>> mPrescribedAttributes;
+		struct TypeDescriptor
+		{
+			std::vector<FieldDescriptor> mFields;	/**<	The prescribed attributes that the type registers	*/
+			std::vector<FieldBinding> mBindings;	/**<	The members that back the attributes that the type registers	*/
+		};
+
+		/**
+		*	@brief	The compiled, immutable prescribed attribute layout of one Attributed type. The fields
+		*			include the ones registered by all the ancestors of the type, and the ones of the layout
+		*			are ordered the way the attributes are laid out in an instance.
+		*/
+		struct Schema
+		{
+			std::vector<FieldDescriptor> mFields;	/**<	The prescribed attributes, the ones of the layout first, at their layout indices	*/
+			std::uint32_t mLayoutSize;				/**<	Number of attributes at the front of an instance that are prescribed	*/
+			std::vector<FieldBinding> mBindings;	/**<	The members to rebind after a copy or a move, with their layout indices resolved	*/
+			std::uint64_t mTypeId;					/**<	The instance id of the type that the schema was compiled for	*/
+		};
+
+		/**
+		*	@brief	Everything that is known about a type once it has been constructed. Entries are never
+		*			changed or freed once they are published.
+		*/
+		struct TypeEntry
+		{
+			TypeDescriptor mDescriptor;				/**<	What the type registers in its own constructor	*/
+			Schema mSchema;							/**<	The compiled schema of the type	*/
+			const TypeEntry* mNext;					/**<	The entry that was published before this one in the same bucket	*/
+		};
+
+		/**
+		*	@brief	Helper method to register a prescribed attribute, if the type whose constructor is
+		*			running is being registered.
+		*	@param	name the key of the prescribed attribute
+		*	@param	type the type of the attribute
+		*	@param	size the number of elements of the attribute
+		*	@param	isExternal whether the attribute is stored in a member of the type
+		*/
+		void RegisterField(const std::string& name, const EDatumType type, const std::uint32_t size, const bool isExternal);
+
+		/**
+		*	@brief	Helper method to record the offset of a member that backs a prescribed attribute,
+		*			if the type whose constructor is running is being registered.
+		*	@param	name the key of the prescribed attribute
+		*	@param	field address of the member in this object
+		*	@param	isDatumReference whether the member is a Datum pointer rather than external storage
+		*/
+		void AddFieldBinding(const std::string& name, const void* field, const bool isDatumReference);
+
+		/**
+		*	@brief	Helper method to check whether an attribute is prescribed. The attributes of the layout
+		*			are told apart by the position of their Datum in the attribute list, so only the keys
+		*			that were registered outside of the layout are compared.
+		*	@param	key the key of the attribute
+		*	@param	datum the Datum of the attribute in this instance, or nullptr if there is none
+		*	@return	bool that indicates whether the attribute is prescribed
+		*/
+		bool IsPrescribedDatum(const std::string& key, const Datum* datum) const;
+
+		/**
+		*	@brief	Helper method to get the compiled schema of the type of this instance. The instance
+		*			keeps a pointer to it, which is only trusted if it was compiled for the current type,
+		*			since the constructors of the base classes ask for their own schemas. Otherwise it is
+		*			looked up without locking, and only compiled if the type registers nothing of its own.
+		*	@return	const reference to the schema
+		*/
+		const Schema& GetSchema() const;
+
+		/**
+		*	@brief	Helper method to compile the schema of the type of this instance, from the descriptors
+		*			of the type and its ancestors and from the order of the attributes of this instance.
+		*	@param	schema the schema to be compiled
+		*	@param	descriptor the descriptor of the type, if it is not published yet, or nullptr
+		*/
+		void CompileSchema(Schema& schema, const TypeDescriptor* descriptor) const;
+
+		/**
+		*	@brief	Static helper method to find a field by its key.
+		*	@param	fields the fields to be searched
+		*	@param	key the key of the field
+		*	@return	the index of the field, or InvalidIndex if there is none with the key
+		*/
+		static std::uint32_t FindField(const std::vector<FieldDescriptor>& fields, const std::string& key);
+
+		/**
+		*	@brief	Static helper method to find the entry of a type without locking.
+		*	@param	typeId the instance id of the type
+		*	@return	pointer to the entry, or nullptr if the type has not been published
+		*/
+		static const TypeEntry* FindType(const std::uint64_t typeId);
+
+		/**
+		*	@brief	Static helper method to publish the entry of a type. The caller holds mSchemaMutex. If
+		*			another thread published the type first, its entry is kept. The entry is linked in
+		*			front of its bucket, so nothing that was published before is copied.
+		*	@param	typeId the instance id of the type
+		*	@param	entry the entry of the type
+		*	@return	const reference to the published entry
+		*/
+		static const TypeEntry& PublishType(const std::uint64_t typeId, const TypeEntry& entry);
+
+		/**
+		*	@brief	Static helper method to get the bucket that the entry of a type is published in.
+		*	@param	typeId the instance id of the type
+		*	@return	reference to the head of the bucket
+		*/
+		static std::atomic<const TypeEntry*>& TypeBucket(const std::uint64_t typeId);
+
+		static const std::uint32_t TypeBucketCount = 64;			/**<	The number of buckets that the published types are spread over, a power of two	*/
+
+		mutable std::atomic<const Schema*> mSchema;					/**<	The schema of the type of this instance, nullptr until it is first needed	*/
+		mutable Handle mHandle;										/**<	The handle of this instance, the null handle until it is first asked for	*/
+		TypeDescriptor* mRegistration;								/**<	The descriptor that the running constructor registers into, nullptr unless it is the first of its type	*/
+
+		static std::atomic<const TypeEntry*> mTypeBuckets[TypeBucketCount];	/**<	The last entry published in each bucket, from which the others are reached	*/
+		static SList<TypeEntry> mTypeEntries;						/**<	The storage of the published entries, which never moves them	*/
+		static std::mutex mSchemaMutex;								/**<	Mutex that serializes the publishing of the types	*/
 
 	};
 
-}
\ No newline at end of file
+}
+
+#include "Attributed.inl"
\ No newline at end of file
@@ -0,0 +1,33 @@
+#include "pch.h"
+#include "Attributed.h"
+
+namespace FieaGameEngine
+{
+
+	template <typename TDerived, typename TField>
+	Datum* Attributed::AddExternalPrescribedAttribute(const std::string& name, TField TDerived::* field, const std::uint32_t size)
+	{
+		TField* externalData = &(static_cast<TDerived*>(this)->*field);
+		Datum* datum = AddExternalPrescribedAttribute(name, externalData, size);
+		AddFieldBinding(name, externalData, false);
+
+		return datum;
+	}
+
+
+
+
+	template <typename TDerived>
+	Datum* Attributed::AddTablePrescribedAttribute(const std::string& name, Datum* TDerived::* datumField)
+	{
+		Datum& datum = Append(name);
+		RegisterField(name, EDatumType::ETable, 0, false);
+
+		Datum*& member = static_cast<TDerived*>(this)->*datumField;
+		member = &datum;
+		AddFieldBinding(name, &member, true);
+
+		return &datum;
+	}
+
+}
\ No newline at end of file
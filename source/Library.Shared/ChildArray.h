@@ -0,0 +1,106 @@
+#pragma once
+
+#include "Vector.h"
+
+/**
+*	@brief	The namespace under which the game engine is implemented.
+*/
+namespace FieaGameEngine
+{
+
+	class Datum;	//forward declaration for the Datum class
+	class Scope;	//forward declaration for the Scope class
+
+	/**
+	*	@brief	The ChildArray class keeps the children of a container that are stored under one key as
+	*			a contiguous array of typed pointers, in the same order as the Datum that holds them.
+	*			Containers add and remove children as they are adopted and orphaned, so that update
+	*			loops walk a flat array without looking the key up or checking the type of every child.
+	*			Children that are copied into the Datum without being adopted, e.g. by the copy
+	*			constructors, are picked up by rebuilding the array from the Datum, which happens when
+	*			the sizes of the two no longer match.
+	*/
+	template <typename T>
+	class ChildArray final
+	{
+
+	public:
+
+		/**
+		*	@brief	The default constructor creates an empty array that is built on first use.
+		*/
+		ChildArray();
+
+		/**
+		*	@brief	The copy constructor does not copy the pointers, which refer to the children of the
+		*			other container. The new array is built on first use.
+		*	@param	other the array to be copied
+		*/
+		ChildArray(const ChildArray& other);
+
+		/**
+		*	@brief	The move constructor does not move the pointers. The new array is built on first use.
+		*	@param	other the array to be moved
+		*/
+		ChildArray(ChildArray&& other);
+
+		/**
+		*	@brief	The copy assignment operator drops the pointers, and the array is rebuilt on next use.
+		*	@param	other the array to be copied
+		*	@return	reference to the array
+		*/
+		ChildArray& operator=(const ChildArray& other);
+
+		/**
+		*	@brief	The move assignment operator drops the pointers, and the array is rebuilt on next use.
+		*	@param	other the array to be moved
+		*	@return	reference to the array
+		*/
+		ChildArray& operator=(ChildArray&& other);
+
+		/**
+		*	@brief	The destructor is defaulted.
+		*/
+		~ChildArray() = default;
+
+		/**
+		*	@brief	Method to append a child that was adopted at the end of the Datum.
+		*	@param	child the adopted child
+		*/
+		void Add(Scope& child);
+
+		/**
+		*	@brief	Method to remove a child that left the container. The child is matched by address,
+		*			so it can be removed while it is being destroyed.
+		*	@param	child the child that left
+		*/
+		void Remove(Scope& child);
+
+		/**
+		*	@brief	Method to force the array to be rebuilt on next use.
+		*/
+		void Invalidate();
+
+		/**
+		*	@brief	Method to get the children, rebuilding the array from the Datum if it is out of date.
+		*	@param	datum the Datum that holds the children, which may be nullptr
+		*	@return	const reference to the array of children
+		*/
+		const Vector<T*>& Get(const Datum* datum);
+
+	private:
+
+		/**
+		*	@brief	Helper method to rebuild the array from the Datum.
+		*	@param	datum the Datum that holds the children, which may be nullptr
+		*/
+		void Rebuild(const Datum* datum);
+
+		Vector<T*> mChildren;		/**<	The children, in the order of the Datum	*/
+		bool mIsStale;				/**<	Whether the array has to be rebuilt before it is used	*/
+
+	};
+
+}
+
+#include "ChildArray.inl"
\ No newline at end of file
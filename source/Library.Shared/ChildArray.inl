@@ -0,0 +1,150 @@
+#include "pch.h"
+#include "ChildArray.h"
+#include "Scope.h"
+
+namespace FieaGameEngine
+{
+
+	template <typename T>
+	ChildArray<T>::ChildArray() : mChildren(), mIsStale(true)
+	{
+	}
+
+
+
+
+	template <typename T>
+	ChildArray<T>::ChildArray(const ChildArray& other) : ChildArray()
+	{
+		UNREFERENCED_PARAMETER(other);
+	}
+
+
+
+
+	template <typename T>
+	ChildArray<T>::ChildArray(ChildArray&& other) : ChildArray()
+	{
+		UNREFERENCED_PARAMETER(other);
+	}
+
+
+
+
+	template <typename T>
+	ChildArray<T>& ChildArray<T>::operator=(const ChildArray& other)
+	{
+		UNREFERENCED_PARAMETER(other);
+		Invalidate();
+		return *this;
+	}
+
+
+
+
+	template <typename T>
+	ChildArray<T>& ChildArray<T>::operator=(ChildArray&& other)
+	{
+		UNREFERENCED_PARAMETER(other);
+		Invalidate();
+		return *this;
+	}
+
+
+
+
+	template <typename T>
+	void ChildArray<T>::Add(Scope& child)
+	{
+		if (mIsStale)
+		{
+			return;
+		}
+
+		T* typedChild = child.As<T>();
+		if (typedChild == nullptr)
+		{
+			//the Datum now holds a child that the array cannot, so it no longer mirrors the Datum
+			Invalidate();
+			return;
+		}
+
+		mChildren.PushBack(typedChild);
+	}
+
+
+
+
+	template <typename T>
+	void ChildArray<T>::Remove(Scope& child)
+	{
+		if (mIsStale)
+		{
+			return;
+		}
+
+		//the child is matched by address, since it may be orphaned by its own destructor, when it is no longer a T
+		for (std::uint32_t i = 0; i < mChildren.Size(); ++i)
+		{
+			if (static_cast<Scope*>(mChildren[i]) == &child)
+			{
+				T* typedChild = mChildren[i];
+				mChildren.Remove(typedChild);
+				return;
+			}
+		}
+	}
+
+
+
+
+	template <typename T>
+	void ChildArray<T>::Invalidate()
+	{
+		mChildren.Clear();
+		mIsStale = true;
+	}
+
+
+
+
+	template <typename T>
+	const Vector<T*>& ChildArray<T>::Get(const Datum* datum)
+	{
+		std::uint32_t size = (datum != nullptr) ? datum->Size() : 0;
+		if (mIsStale || (mChildren.Size() != size))
+		{
+			Rebuild(datum);
+		}
+
+		return mChildren;
+	}
+
+
+
+
+	template <typename T>
+	void ChildArray<T>::Rebuild(const Datum* datum)
+	{
+		mChildren.Clear();
+		mIsStale = false;
+
+		if (datum == nullptr)
+		{
+			return;
+		}
+
+		mChildren.Reserve(datum->Size());
+		for (std::uint32_t i = 0; i < datum->Size(); ++i)
+		{
+			T* child = datum->Get<Scope*>(i)->As<T>();
+			if (child == nullptr)
+			{
+				throw std::exception("Child is of the wrong type.");
+			}
+
+			mChildren.PushBack(child);
+		}
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,372 @@
+#include "pch.h"
+#include "CommandBuffer.h"
+#include "Action.h"
+#include "DeferredDestroyer.h"
+#include "Factory.h"
+#include "WorldState.h"
+
+
+namespace FieaGameEngine
+{
+
+	SList<CommandBuffer::Buffer> CommandBuffer::mBuffers;
+	std::mutex CommandBuffer::mBuffersMutex;
+	std::vector<std::exception_ptr> CommandBuffer::mFailures;
+
+
+
+
+	void CommandBuffer::CreateAction(const WorldState& worldState, Attributed& parent, const std::string& className, const std::string& instanceName, const std::string& key)
+	{
+		Command command;
+		command.mType = ECommandType::ECreateAction;
+		command.mTarget = parent.GetHandle();
+		command.mClassName = className;
+		command.mName = instanceName;
+		command.mKey = key;
+		Record(worldState, std::move(command));
+	}
+
+
+
+
+	void CommandBuffer::Destroy(const WorldState& worldState, Attributed& object)
+	{
+		Command command;
+		command.mType = ECommandType::EDestroy;
+		command.mTarget = object.GetHandle();
+		Record(worldState, std::move(command));
+	}
+
+
+
+
+	void CommandBuffer::Adopt(const WorldState& worldState, Attributed& parent, Attributed& child, const std::string& key)
+	{
+		if (&parent == &child)
+		{
+			throw std::exception("Cannot adopt self.");
+		}
+
+		Command command;
+		command.mType = ECommandType::EAdopt;
+		command.mTarget = parent.GetHandle();
+		command.mChild = child.GetHandle();
+		command.mKey = key;
+		Record(worldState, std::move(command));
+	}
+
+
+
+
+	void CommandBuffer::Orphan(const WorldState& worldState, Attributed& child)
+	{
+		Command command;
+		command.mType = ECommandType::EOrphan;
+		command.mTarget = child.GetHandle();
+		Record(worldState, std::move(command));
+	}
+
+
+
+
+	void CommandBuffer::SetAttribute(const WorldState& worldState, Attributed& object, const std::string& key, const Datum& value)
+	{
+		if (value.Type() == EDatumType::ETable)
+		{
+			throw std::exception("Nested scopes have to be adopted.");
+		}
+
+		Command command;
+		command.mType = ECommandType::ESetAttribute;
+		command.mTarget = object.GetHandle();
+		command.mName = key;
+		command.mValue = value;
+		Record(worldState, std::move(command));
+	}
+
+
+
+
+	void CommandBuffer::Apply()
+	{
+		ApplyCommands(nullptr);
+	}
+
+
+
+
+	void CommandBuffer::Apply(const World& world)
+	{
+		ApplyCommands(&world);
+	}
+
+
+
+
+	std::vector<std::exception_ptr> CommandBuffer::TakeFailures()
+	{
+		std::vector<std::exception_ptr> failures;
+		failures.swap(mFailures);
+		return failures;
+	}
+
+
+
+
+	void CommandBuffer::ApplyCommands(const World* world)
+	{
+		Vector<Buffer*> buffers;
+		{
+			std::lock_guard<std::mutex> lock(mBuffersMutex);
+
+			//the commands of other worlds are kept at the front, in the order they were recorded
+			for (Buffer& buffer : mBuffers)
+			{
+				auto applied = std::stable_partition(buffer.mCommands.begin(), buffer.mCommands.end(), [world](const Command& command)
+				{
+					return ((world != nullptr) && (command.mWorld != world));
+				});
+
+				if (applied != buffer.mCommands.end())
+				{
+					buffer.mApplying.assign(std::make_move_iterator(applied), std::make_move_iterator(buffer.mCommands.end()));
+					buffer.mCommands.erase(applied, buffer.mCommands.end());
+					buffers.PushBack(&buffer);
+				}
+			}
+		}
+
+		if (buffers.IsEmpty())
+		{
+			return;
+		}
+
+		Vector<Command*> batch;
+		for (std::uint32_t i = 0; i < buffers.Size(); ++i)
+		{
+			for (Command& command : buffers[i]->mApplying)
+			{
+				batch.PushBack(&command);
+			}
+		}
+
+		//the commands of an entity or of a reaction all come from the thread that ran it, in the order they were recorded, which the stable sort keeps
+		std::stable_sort(&batch[0], &batch[0] + batch.Size(), IsAppliedBefore);
+
+		//a command that fails only loses itself, the rest of the frame's commands are still applied
+		for (std::uint32_t i = 0; i < batch.Size(); ++i)
+		{
+			try
+			{
+				Execute(*batch[i]);
+			}
+			catch (...)
+			{
+				mFailures.push_back(std::current_exception());
+			}
+		}
+
+		for (std::uint32_t i = 0; i < buffers.Size(); ++i)
+		{
+			buffers[i]->mApplying.clear();
+		}
+	}
+
+
+
+
+	std::uint32_t CommandBuffer::PendingCount()
+	{
+		std::lock_guard<std::mutex> lock(mBuffersMutex);
+
+		std::uint32_t count = 0;
+		for (const Buffer& buffer : mBuffers)
+		{
+			count += static_cast<std::uint32_t>(buffer.mCommands.size());
+		}
+
+		return count;
+	}
+
+
+
+
+	CommandBuffer::BufferLease::~BufferLease()
+	{
+		if (mBuffer != nullptr)
+		{
+			//the commands stay in the buffer until they are applied, the next thread just appends to them
+			std::lock_guard<std::mutex> lock(mBuffersMutex);
+			mBuffer->mIsInUse = false;
+		}
+	}
+
+
+
+
+	void CommandBuffer::Record(const WorldState& worldState, Command&& command)
+	{
+		command.mWorld = worldState.CurrentWorld;
+		command.mOrder = worldState.UpdateOrder;
+		command.mEventSequence = worldState.EventSequence;
+		command.mSubscriberIndex = worldState.SubscriberIndex;
+		ThreadBuffer().mCommands.push_back(std::move(command));
+	}
+
+
+
+
+	void CommandBuffer::Execute(Command& command)
+	{
+		Attributed* target = HandleTable::Resolve(command.mTarget);
+		if (target == nullptr)
+		{
+			return;
+		}
+
+		switch (command.mType)
+		{
+		case ECommandType::ECreateAction:
+		{
+			Action* action = Factory<Action>::Create(command.mClassName);
+			if (action == nullptr)
+			{
+				throw std::exception("Unable to create action!");
+			}
+			action->SetName(command.mName);
+			target->Adopt(*action, command.mKey);
+			break;
+		}
+
+		case ECommandType::EDestroy:
+			DeferredDestroyer::Enqueue(command.mTarget, command.mWorld);
+			break;
+
+		case ECommandType::EAdopt:
+		{
+			Attributed* child = HandleTable::Resolve(command.mChild);
+			if (child != nullptr)
+			{
+				child->Detach();
+				target->Adopt(*child, command.mKey);
+			}
+			break;
+		}
+
+		case ECommandType::EOrphan:
+			target->Detach();
+			break;
+
+		case ECommandType::ESetAttribute:
+		{
+			Datum* attribute = target->Find(command.mName);
+			if (attribute == nullptr)
+			{
+				attribute = &target->AppendAuxiliaryAttribute(command.mName);
+			}
+
+			if (!attribute->IsExternalStorage())
+			{
+				*attribute = command.mValue;
+				break;
+			}
+
+			//external storage keeps its size, so the values are copied over one by one, read through a const Datum so they are not copied first
+			const Datum& value = command.mValue;
+			if ((attribute->Type() != value.Type()) || (attribute->Size() < value.Size()))
+			{
+				throw std::exception("Value does not fit the attribute.");
+			}
+
+			for (std::uint32_t i = 0; i < value.Size(); ++i)
+			{
+				switch (value.Type())
+				{
+				case EDatumType::EInteger:
+					attribute->Set(value.Get<std::int32_t>(i), i);
+					break;
+
+				case EDatumType::EFloat:
+					attribute->Set(value.Get<std::float_t>(i), i);
+					break;
+
+				case EDatumType::EVector4:
+					attribute->Set(value.Get<glm::vec4>(i), i);
+					break;
+
+				case EDatumType::EMatrix4x4:
+					attribute->Set(value.Get<glm::mat4x4>(i), i);
+					break;
+
+				case EDatumType::EString:
+					attribute->Set(value.Get<std::string>(i), i);
+					break;
+
+				case EDatumType::ERTTIPointer:
+					attribute->Set(value.Get<RTTI*>(i), i);
+					break;
+
+				default:
+					break;
+				}
+			}
+			break;
+		}
+
+		default:
+			break;
+		}
+	}
+
+
+
+
+	CommandBuffer::Buffer& CommandBuffer::ThreadBuffer()
+	{
+		static thread_local BufferLease lease = { nullptr };
+
+		if (lease.mBuffer == nullptr)
+		{
+			std::lock_guard<std::mutex> lock(mBuffersMutex);
+			for (Buffer& buffer : mBuffers)
+			{
+				if (!buffer.mIsInUse)
+				{
+					lease.mBuffer = &buffer;
+					break;
+				}
+			}
+
+			//the list never moves its nodes, so the buffer stays where the lease points
+			if (lease.mBuffer == nullptr)
+			{
+				mBuffers.PushBack(Buffer());
+				lease.mBuffer = &mBuffers.Back();
+			}
+
+			lease.mBuffer->mIsInUse = true;
+		}
+
+		return *lease.mBuffer;
+	}
+
+
+
+
+	bool CommandBuffer::IsAppliedBefore(const Command* lhs, const Command* rhs)
+	{
+		if (lhs->mOrder != rhs->mOrder)
+		{
+			return (lhs->mOrder < rhs->mOrder);
+		}
+
+		if (lhs->mEventSequence != rhs->mEventSequence)
+		{
+			return (lhs->mEventSequence < rhs->mEventSequence);
+		}
+
+		return (lhs->mSubscriberIndex < rhs->mSubscriberIndex);
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,233 @@
+#pragma once
+
+#include <vector>
+#include "Datum.h"
+#include "HandleTable.h"
+#include "SList.h"
+#include "Vector.h"
+
+/**
+*	@brief	The namespace under which the game engine is implemented.
+*/
+namespace FieaGameEngine
+{
+
+	class Attributed;	//forward declaration for the Attributed class
+	class WorldState;	//forward declaration for the WorldState class
+	class World;		//forward declaration for the World class
+
+	/**
+	*	@brief	The CommandBuffer class records changes to the structure of the world that are made while
+	*			it is being updated, i.e. creating, destroying, adopting and orphaning objects, and setting
+	*			their attributes, and applies them together at the end of the update. Nothing is changed
+	*			under the loops that walk the world, and entities that are updated in parallel never
+	*			touch each other. Every thread records into a buffer of its own, without locking. The
+	*			commands are applied in the order of the entities that recorded them, then of the events
+	*			and of the subscribers of each event for those recorded by reactions, and in the order
+	*			that each of them recorded them, so the result does not depend on how the entities and
+	*			the reactions were spread over the threads. Commands on objects that died in the meantime
+	*			are skipped, and a command that fails does not stop the others. Each world applies the
+	*			commands recorded during its own update.
+	*/
+	class CommandBuffer final
+	{
+
+	public:
+
+		/**
+		*	@brief	The default constructor is deleted, since the class only has static members.
+		*/
+		CommandBuffer() = delete;
+
+		/**
+		*	@brief	The copy constructor for this class is deleted.
+		*/
+		CommandBuffer(const CommandBuffer& other) = delete;
+
+		/**
+		*	@brief	The move constructor for this class is deleted.
+		*/
+		CommandBuffer(CommandBuffer&& other) = delete;
+
+		/**
+		*	@brief	The copy assignment operator is deleted.
+		*/
+		CommandBuffer& operator=(const CommandBuffer& other) = delete;
+
+		/**
+		*	@brief	The move assignment operator is deleted.
+		*/
+		CommandBuffer& operator=(CommandBuffer&& other) = delete;
+
+		/**
+		*	@brief	The destructor is deleted, since the class only has static members.
+		*/
+		~CommandBuffer() = delete;
+
+		/**
+		*	@brief	Static method to record the creation of an action.
+		*	@param	worldState the world state of the update that records the command
+		*	@param	parent the object that adopts the action
+		*	@param	className the class name of the action
+		*	@param	instanceName the instance name of the action
+		*	@param	key the key that the action is adopted under
+		*/
+		static void CreateAction(const WorldState& worldState, Attributed& parent, const std::string& className, const std::string& instanceName, const std::string& key = "Actions");
+
+		/**
+		*	@brief	Static method to record the destruction of an object, which is handed to the
+		*			DeferredDestroyer when the commands are applied.
+		*	@param	worldState the world state of the update that records the command
+		*	@param	object the object to be destroyed
+		*/
+		static void Destroy(const WorldState& worldState, Attributed& object);
+
+		/**
+		*	@brief	Static method to record the adoption of an object, which leaves its current parent first.
+		*	@param	worldState the world state of the update that records the command
+		*	@param	parent the object that adopts the child
+		*	@param	child the object to be adopted
+		*	@param	key the key that the child is adopted under
+		*/
+		static void Adopt(const WorldState& worldState, Attributed& parent, Attributed& child, const std::string& key);
+
+		/**
+		*	@brief	Static method to record that an object leaves its parent. The object then belongs to
+		*			whoever recorded the command, and must be adopted or destroyed later.
+		*	@param	worldState the world state of the update that records the command
+		*	@param	child the object that leaves its parent
+		*/
+		static void Orphan(const WorldState& worldState, Attributed& child);
+
+		/**
+		*	@brief	Static method to record setting an attribute of an object. The attribute is appended if
+		*			the object does not have it. Nested scopes have to be adopted instead.
+		*	@param	worldState the world state of the update that records the command
+		*	@param	object the object whose attribute is set
+		*	@param	key the name of the attribute
+		*	@param	value the values of the attribute
+		*/
+		static void SetAttribute(const WorldState& worldState, Attributed& object, const std::string& key, const Datum& value);
+
+		/**
+		*	@brief	Static method that applies the commands recorded by all the threads, in order, for
+		*			every world and outside of any. Threads record without locking, so it must only run
+		*			while no thread records, i.e. not concurrently with the update of any world, or with
+		*			itself. A command that throws is skipped and its exception is kept, see TakeFailures.
+		*/
+		static void Apply();
+
+		/**
+		*	@brief	Static method that applies the commands recorded during the updates of a world, in
+		*			order, and leaves those of other worlds pending. It is called by the world once its
+		*			events are delivered, and must only run while no thread records, like Apply().
+		*	@param	world the world whose commands are applied
+		*/
+		static void Apply(const World& world);
+
+		/**
+		*	@brief	Static method to take the exceptions of the commands that failed since the last
+		*			call, in the order the commands were applied. Like Apply, it must only run while no
+		*			thread records.
+		*	@return	the exceptions of the failed commands
+		*/
+		static std::vector<std::exception_ptr> TakeFailures();
+
+		/**
+		*	@brief	Static method to get the number of commands that are recorded and not yet applied.
+		*	@return	unsigned int representing the number of pending commands
+		*/
+		static std::uint32_t PendingCount();
+
+	private:
+
+		/**
+		*	@brief	The kinds of commands.
+		*/
+		enum class ECommandType
+		{
+			ECreateAction,
+			EDestroy,
+			EAdopt,
+			EOrphan,
+			ESetAttribute
+		};
+
+		/**
+		*	@brief	A recorded command. Which of the members are used depends on the type.
+		*/
+		struct Command
+		{
+			ECommandType mType;				/**<	The kind of the command	*/
+			const World* mWorld;			/**<	The world whose update recorded the command, if any	*/
+			std::uint64_t mOrder;			/**<	The update order of the entity that recorded the command	*/
+			std::uint64_t mEventSequence;	/**<	The delivery sequence of the event whose reaction recorded the command	*/
+			std::uint32_t mSubscriberIndex;	/**<	The position of that reaction among the subscribers of the event	*/
+			Handle mTarget;					/**<	The object that the command works on, or the parent for creation	*/
+			Handle mChild;					/**<	The object to be adopted	*/
+			std::string mClassName;			/**<	The class name of the action to be created	*/
+			std::string mName;				/**<	The instance name of the action, or the name of the attribute	*/
+			std::string mKey;				/**<	The key that the child is adopted under	*/
+			Datum mValue;					/**<	The values of the attribute	*/
+		};
+
+		/**
+		*	@brief	The commands of a thread.
+		*/
+		struct Buffer
+		{
+			std::vector<Command> mCommands;		/**<	The recorded commands, in the order they were recorded	*/
+			std::vector<Command> mApplying;		/**<	The commands that are being applied, taken from mCommands	*/
+			bool mIsInUse;					/**<	Whether a live thread records into the buffer	*/
+		};
+
+		/**
+		*	@brief	Owns the buffer of a thread, and hands it back for reuse when the thread exits.
+		*/
+		struct BufferLease
+		{
+			Buffer* mBuffer;	/**<	The buffer of the thread	*/
+			~BufferLease();
+		};
+
+		/**
+		*	@brief	Helper method to record a command in the buffer of the calling thread.
+		*	@param	worldState the world state of the update that records the command
+		*	@param	command the command, whose order is filled in from the world state
+		*/
+		static void Record(const WorldState& worldState, Command&& command);
+
+		/**
+		*	@brief	Helper method that applies the commands of a world, or all of them.
+		*	@param	world the world whose commands are applied, or nullptr for all the commands
+		*/
+		static void ApplyCommands(const World* world);
+
+		/**
+		*	@brief	Helper method that applies one command.
+		*	@param	command the command to be applied
+		*/
+		static void Execute(Command& command);
+
+		/**
+		*	@brief	Helper method to get the buffer of the calling thread, taking one if it has none yet.
+		*	@return	reference to the buffer of the calling thread
+		*/
+		static Buffer& ThreadBuffer();
+
+		/**
+		*	@brief	Helper method that orders the commands when they are applied.
+		*	@param	lhs the first command
+		*	@param	rhs the second command
+		*	@return	bool indicating whether lhs is applied before rhs
+		*/
+		static bool IsAppliedBefore(const Command* lhs, const Command* rhs);
+
+		static SList<Buffer> mBuffers;			/**<	The buffers of all the threads, which are reused as threads come and go	*/
+		static std::mutex mBuffersMutex;		/**<	The lock for the list of buffers and for taking their commands	*/
+
+		static std::vector<std::exception_ptr> mFailures;	/**<	The exceptions of the commands that failed, until they are taken	*/
+
+	};
+
+}
\ No newline at end of file
@@ -1,10 +1,13 @@
 #include "pch.h"
 #include "Scope.h"
 #include "Datum.h"
+#include "Writer.h"
 
 
 namespace FieaGameEngine
 {
+	const size_t Datum::PayloadHeaderSize = 16;
+
 	const size_t Datum::TypeToSizeMapping[static_cast<std::uint32_t>(EDatumType::ENumberOfSupportedDatatypes)]
 	{
 		0,
@@ -20,79 +23,73 @@ namespace FieaGameEngine
 
 
 
-	Datum::Datum() : mSize(0), mCapacity(0), mDatumType(EDatumType::EUnknown), mIsInternalStorage(true)
+	Datum::Datum() : mSize(0), mCapacity(0), mDatumType(EDatumType::EUnknown), mIsInternalStorage(true), mOwner(nullptr), mElementHash(0), mIsHashValid(true), mIsExposed(false)
 	{
 
 	}
 
-	Datum::Datum(const Datum& other) : mSize(0), mCapacity(0), mDatumType(other.mDatumType), mIsInternalStorage(other.mIsInternalStorage)
+	Datum::Datum(const Datum& other) : mSize(0), mCapacity(0), mDatumType(other.mDatumType), mIsInternalStorage(other.mIsInternalStorage), mOwner(nullptr), mElementHash(other.mElementHash), mIsHashValid(other.mIsHashValid), mIsExposed(false)
 	{
-		if (mIsInternalStorage)
+		mData = other.mData;
+		mSize = other.mSize;
+		mCapacity = other.mCapacity;
+
+		if (mIsInternalStorage && (mCapacity != 0))
 		{
-			Reserve(other.mCapacity);
+			Header()->mReferenceCount.fetch_add(1, std::memory_order_relaxed);
 
-			if (mDatumType == EDatumType::EString)
-			{
-				for (std::uint32_t i = 0; i < other.mSize; ++i)
-				{
-					new (mData.s + i) std::string(other.mData.s[i]);
-				}
-			}
-			else
+			//references that Get handed out can still write to the array of other, so it is not shared
+			if (other.mIsExposed)
 			{
-				memcpy_s(mData.vp, (TypeToSizeMapping[static_cast<std::uint32_t>(mDatumType)] * other.mSize), other.mData.vp, (TypeToSizeMapping[static_cast<std::uint32_t>(other.mDatumType)] * other.mSize));
+				CopyPayload(mCapacity);
 			}
-
-			mSize = other.mSize;
-		}
-		else
-		{
-			mData = other.mData;
-			mSize = other.mSize;
-			mCapacity = other.mCapacity;
 		}
 	}
 
-	Datum::Datum(Datum&& other) : mSize(other.mSize), mCapacity(other.mCapacity), mDatumType(other.mDatumType), mData(other.mData), mIsInternalStorage(other.mIsInternalStorage)
+	Datum::Datum(Datum&& other) : mSize(other.mSize), mCapacity(other.mCapacity), mDatumType(other.mDatumType), mData(other.mData), mIsInternalStorage(other.mIsInternalStorage), mOwner(nullptr), mElementHash(other.mElementHash), mIsHashValid(other.mIsHashValid), mIsExposed(other.mIsExposed)
 	{
 		other.mSize = 0;
 		other.mCapacity = 0;
 		other.mDatumType = EDatumType::EUnknown;
 		other.mData.vp = nullptr;
 		other.mIsInternalStorage = true;
+		other.mElementHash = 0;
+		other.mIsHashValid = true;
+		other.mIsExposed = false;
+		other.MarkChanged();
 	}
 
-	Datum::Datum(const std::int32_t& other) : mSize(0), mCapacity(0), mDatumType(EDatumType::EInteger), mIsInternalStorage(true)
+	Datum::Datum(const std::int32_t& other) : mSize(0), mCapacity(0), mDatumType(EDatumType::EInteger), mIsInternalStorage(true), mOwner(nullptr), mElementHash(0), mIsHashValid(true), mIsExposed(false)
 	{
 		PushBack(other);
 	}
 
-	Datum::Datum(const std::float_t& other) : mSize(0), mCapacity(0), mDatumType(EDatumType::EFloat), mIsInternalStorage(true)
+	Datum::Datum(const std::float_t& other) : mSize(0), mCapacity(0), mDatumType(EDatumType::EFloat), mIsInternalStorage(true), mOwner(nullptr), mElementHash(0), mIsHashValid(true), mIsExposed(false)
 	{
 		PushBack(other);
 	}
 
-	Datum::Datum(const glm::vec4& other) : mSize(0), mCapacity(0), mDatumType(EDatumType::EVector4), mIsInternalStorage(true)
+	Datum::Datum(const glm::vec4& other) : mSize(0), mCapacity(0), mDatumType(EDatumType::EVector4), mIsInternalStorage(true), mOwner(nullptr), mElementHash(0), mIsHashValid(true), mIsExposed(false)
 	{
 		PushBack(other);
 	}
 
-	Datum::Datum(const glm::mat4x4& other) : mSize(0), mCapacity(0), mDatumType(EDatumType::EMatrix4x4), mIsInternalStorage(true)
+	Datum::Datum(const glm::mat4x4& other) : mSize(0), mCapacity(0), mDatumType(EDatumType::EMatrix4x4), mIsInternalStorage(true), mOwner(nullptr), mElementHash(0), mIsHashValid(true), mIsExposed(false)
 	{
 		PushBack(other);
 	}
 
-	Datum::Datum(Scope* const& other) : mSize(0), mCapacity(0), mDatumType(EDatumType::ETable), mIsInternalStorage(true)
+	Datum::Datum(Scope* const& other) : mSize(0), mCapacity(0), mDatumType(EDatumType::ETable), mIsInternalStorage(true), mOwner(nullptr), mElementHash(0), mIsHashValid(true), mIsExposed(false)
 	{
 		PushBack(other);
 	}
 
-	Datum::Datum(const std::string& other) : mSize(0), mCapacity(0), mDatumType(EDatumType::EString), mIsInternalStorage(true)
+	Datum::Datum(const std::string& other) : mSize(0), mCapacity(0), mDatumType(EDatumType::EString), mIsInternalStorage(true), mOwner(nullptr), mElementHash(0), mIsHashValid(true), mIsExposed(false)
 	{
 		PushBack(other);
 	}
 
-	Datum::Datum(RTTI* const& other) : mSize(0), mCapacity(0), mDatumType(EDatumType::ERTTIPointer), mIsInternalStorage(true)
+	Datum::Datum(RTTI* const& other) : mSize(0), mCapacity(0), mDatumType(EDatumType::ERTTIPointer), mIsInternalStorage(true), mOwner(nullptr), mElementHash(0), mIsHashValid(true), mIsExposed(false)
 	{
 		PushBack(other);
 	}
@@ -111,7 +108,27 @@ namespace FieaGameEngine
 		{
 			Clear();
 			mDatumType = other.mDatumType;
-			if(mDatumType != EDatumType::EUnknown)
+			if (other.mIsInternalStorage)
+			{
+				mData = other.mData;
+				mSize = other.mSize;
+				mCapacity = other.mCapacity;
+
+				if (mCapacity != 0)
+				{
+					Header()->mReferenceCount.fetch_add(1, std::memory_order_relaxed);
+
+					//references that Get handed out can still write to the array of other, so it is not shared
+					if (other.mIsExposed)
+					{
+						CopyPayload(mCapacity);
+					}
+				}
+
+				mElementHash = other.mElementHash;
+				mIsHashValid = other.mIsHashValid;
+			}
+			else if(mDatumType != EDatumType::EUnknown)
 			{
 				Reserve(other.mCapacity);
 
@@ -127,7 +144,10 @@ namespace FieaGameEngine
 					memcpy_s(mData.vp, (TypeToSizeMapping[static_cast<std::uint32_t>(mDatumType)] * other.mSize), other.mData.vp, (TypeToSizeMapping[static_cast<std::uint32_t>(other.mDatumType)] * other.mSize));
 				}
 				mSize = other.mSize;
+				mIsHashValid = false;
 			}
+
+			MarkChanged();
 		}
 		return *this;
 	}
@@ -147,12 +167,21 @@ namespace FieaGameEngine
 			mDatumType = other.mDatumType;
 			mData = other.mData;
 			mIsInternalStorage = other.mIsInternalStorage;
+			mElementHash = other.mElementHash;
+			mIsHashValid = other.mIsHashValid;
+			mIsExposed = other.mIsExposed;
 
 			other.mSize = 0;
 			other.mCapacity = 0;
 			other.mDatumType = EDatumType::EUnknown;
 			other.mData.vp = nullptr;
 			other.mIsInternalStorage = true;
+			other.mElementHash = 0;
+			other.mIsHashValid = true;
+			other.mIsExposed = false;
+
+			MarkChanged();
+			other.MarkChanged();
 		}
 
 		return *this;
@@ -361,6 +390,11 @@ namespace FieaGameEngine
 	{
 		if ((mSize == other.mSize) && (mDatumType == other.mDatumType))
 		{
+			if (mData.vp == other.mData.vp)
+			{
+				return true;
+			}
+
 			if (mDatumType != EDatumType::EUnknown)
 			{
 				if (mDatumType == EDatumType::EString)
@@ -511,6 +545,7 @@ namespace FieaGameEngine
 		}
 
 		mDatumType = datumType;
+		MarkChanged();
 	}
 
 
@@ -535,6 +570,14 @@ namespace FieaGameEngine
 			throw std::exception("Invalid datum type.");
 		}
 
+		if (size == 0)
+		{
+			Clear();
+			return;
+		}
+
+		Detach();
+		InvalidateHash();
 		Reserve(size);
 
 		size_t typeSize = TypeToSizeMapping[static_cast<std::uint32_t>(mDatumType)];
@@ -545,7 +588,7 @@ namespace FieaGameEngine
 				mData.s[i].~basic_string();
 			}
 		}
-		mData.vp = realloc(mData.vp, (typeSize * size));
+		mData.vp = static_cast<char*>(realloc(Header(), (PayloadHeaderSize + (typeSize * size)))) + PayloadHeaderSize;
 		if (mDatumType == EDatumType::EString)
 		{
 			for (std::uint32_t i = mSize; i < size; ++i)
@@ -564,23 +607,15 @@ namespace FieaGameEngine
 
 	void Datum::Clear()
 	{
-		if (mIsInternalStorage)
-		{
-			if ((mDatumType != EDatumType::EUnknown) && (mCapacity != 0))
-			{
-				if (mDatumType == EDatumType::EString)
-				{
-					for (std::uint32_t i = 0; i < mSize; ++i)
-					{
-						mData.s[i].~basic_string();
-					}
-				}
-				free(mData.vp);
-			}
-		}
+		ReleasePayload();
+
 		mData.vp = nullptr;
 		mSize = 0;
 		mCapacity = 0;
+		mElementHash = 0;
+		mIsHashValid = true;
+		mIsExposed = false;
+		MarkChanged();
 	}
 
 
@@ -597,10 +632,18 @@ namespace FieaGameEngine
 			throw std::exception("Index out of bounds.");
 		}
 
+		Detach();
+		InvalidateHash();
+
+		if (mDatumType == EDatumType::EString)
+		{
+			mData.s[index].~basic_string();
+		}
+
 		memmove_s((static_cast<char*>(mData.vp) + (index * TypeToSizeMapping[static_cast<std::uint32_t>(mDatumType)])), 
-			(TypeToSizeMapping[static_cast<std::uint32_t>(mDatumType)] * (mSize - index)),
+			(TypeToSizeMapping[static_cast<std::uint32_t>(mDatumType)] * (mSize - index - 1)),
 			(static_cast<char*>(mData.vp) + (index * TypeToSizeMapping[static_cast<std::uint32_t>(mDatumType)]) + TypeToSizeMapping[static_cast<std::uint32_t>(mDatumType)]),
-			(TypeToSizeMapping[static_cast<std::uint32_t>(mDatumType)] * (mSize - index)));
+			(TypeToSizeMapping[static_cast<std::uint32_t>(mDatumType)] * (mSize - index - 1)));
 		--mSize;
 	}
 
@@ -614,7 +657,9 @@ namespace FieaGameEngine
 			std::uint32_t index = Find(data);
 			if (index < mSize)
 			{
-				memmove_s((mData.i + index), (sizeof(std::int32_t) * (mSize - index)), (mData.i + index + 1), (sizeof(std::int32_t) * (mSize - index)));
+				Detach();
+				InvalidateHash();
+				memmove_s((mData.i + index), (sizeof(std::int32_t) * (mSize - index - 1)), (mData.i + index + 1), (sizeof(std::int32_t) * (mSize - index - 1)));
 				--mSize;
 			}
 		}
@@ -627,7 +672,9 @@ namespace FieaGameEngine
 			std::uint32_t index = Find(data);
 			if (index < mSize)
 			{
-				memmove_s((mData.f + index), (sizeof(std::float_t) * (mSize - index)), (mData.f + index + 1), (sizeof(std::float_t) * (mSize - index)));
+				Detach();
+				InvalidateHash();
+				memmove_s((mData.f + index), (sizeof(std::float_t) * (mSize - index - 1)), (mData.f + index + 1), (sizeof(std::float_t) * (mSize - index - 1)));
 				--mSize;
 			}
 		}
@@ -640,7 +687,9 @@ namespace FieaGameEngine
 			std::uint32_t index = Find(data);
 			if (index < mSize)
 			{
-				memmove_s((mData.v + index), (sizeof(glm::vec4) * (mSize - index)), (mData.v + index + 1), (sizeof(glm::vec4) * (mSize - index)));
+				Detach();
+				InvalidateHash();
+				memmove_s((mData.v + index), (sizeof(glm::vec4) * (mSize - index - 1)), (mData.v + index + 1), (sizeof(glm::vec4) * (mSize - index - 1)));
 				--mSize;
 			}
 		}
@@ -653,7 +702,9 @@ namespace FieaGameEngine
 			std::uint32_t index = Find(data);
 			if (index < mSize)
 			{
-				memmove_s((mData.m + index), (sizeof(glm::mat4x4) * (mSize - index)), (mData.m + index + 1), (sizeof(glm::mat4x4) * (mSize - index)));
+				Detach();
+				InvalidateHash();
+				memmove_s((mData.m + index), (sizeof(glm::mat4x4) * (mSize - index - 1)), (mData.m + index + 1), (sizeof(glm::mat4x4) * (mSize - index - 1)));
 				--mSize;
 			}
 		}
@@ -666,7 +717,9 @@ namespace FieaGameEngine
 			std::uint32_t index = Find(data);
 			if (index < mSize)
 			{
-				memmove_s((mData.t + index), (sizeof(Scope*) * (mSize - index)), (mData.t + index + 1), (sizeof(Scope*) * (mSize - index)));
+				Detach();
+				InvalidateHash();
+				memmove_s((mData.t + index), (sizeof(Scope*) * (mSize - index - 1)), (mData.t + index + 1), (sizeof(Scope*) * (mSize - index - 1)));
 				--mSize;
 			}
 		}
@@ -679,8 +732,10 @@ namespace FieaGameEngine
 			std::uint32_t index = Find(data);
 			if (index < mSize)
 			{
+				Detach();
+				InvalidateHash();
 				mData.s[index].~basic_string();
-				memmove_s((mData.s + index), (sizeof(std::string) * (mSize - index)), (mData.s + index + 1), (sizeof(std::string) * (mSize - index)));
+				memmove_s((mData.s + index), (sizeof(std::string) * (mSize - index - 1)), (mData.s + index + 1), (sizeof(std::string) * (mSize - index - 1)));
 				--mSize;
 			}
 		}
@@ -693,7 +748,9 @@ namespace FieaGameEngine
 			std::uint32_t index = Find(data);
 			if (index < mSize)
 			{
-				memmove_s((mData.r + index), (sizeof(RTTI*) * (mSize - index)), (mData.r + index + 1), (sizeof(RTTI*) * (mSize - index)));
+				Detach();
+				InvalidateHash();
+				memmove_s((mData.r + index), (sizeof(RTTI*) * (mSize - index - 1)), (mData.r + index + 1), (sizeof(RTTI*) * (mSize - index - 1)));
 				--mSize;
 			}
 		}
@@ -1005,6 +1062,7 @@ namespace FieaGameEngine
 			mData.i = data;
 			mSize = size;
 			mCapacity = size;
+			MarkChanged();
 		}
 	}
 
@@ -1015,6 +1073,7 @@ namespace FieaGameEngine
 			mData.f = data;
 			mSize = size;
 			mCapacity = size;
+			MarkChanged();
 		}
 	}
 
@@ -1025,6 +1084,7 @@ namespace FieaGameEngine
 			mData.v = data;
 			mSize = size;
 			mCapacity = size;
+			MarkChanged();
 		}
 	}
 
@@ -1035,6 +1095,7 @@ namespace FieaGameEngine
 			mData.m = data;
 			mSize = size;
 			mCapacity = size;
+			MarkChanged();
 		}
 	}
 
@@ -1045,6 +1106,7 @@ namespace FieaGameEngine
 			mData.s = data;
 			mSize = size;
 			mCapacity = size;
+			MarkChanged();
 		}
 	}
 
@@ -1055,6 +1117,7 @@ namespace FieaGameEngine
 			mData.r = data;
 			mSize = size;
 			mCapacity = size;
+			MarkChanged();
 		}
 	}
 
@@ -1101,14 +1164,18 @@ namespace FieaGameEngine
 
 			if (mCapacity == 0)
 			{
-				mData.vp = malloc(size * capacity);
+				mData.vp = AllocatePayload(capacity);
+				mCapacity = capacity;
+			}
+			else if (Header()->mReferenceCount.load(std::memory_order_acquire) > 1)
+			{
+				CopyPayload(capacity);
 			}
 			else
 			{
-				mData.vp = realloc(mData.vp, (size * capacity));
+				mData.vp = static_cast<char*>(realloc(Header(), (PayloadHeaderSize + (size * capacity)))) + PayloadHeaderSize;
+				mCapacity = capacity;
 			}
-			
-			mCapacity = capacity;
 		}
 	}
 
@@ -1119,7 +1186,11 @@ namespace FieaGameEngine
 	{
 		if (SetMethodExceptionHandler(EDatumType::EInteger, index))
 		{
+			Detach();
+			RemoveElementHash(index);
 			mData.i[index] = data;
+			AddElementHash(index);
+			MarkChanged();
 		}
 	}
 
@@ -1127,7 +1198,11 @@ namespace FieaGameEngine
 	{
 		if (SetMethodExceptionHandler(EDatumType::EFloat, index))
 		{
+			Detach();
+			RemoveElementHash(index);
 			mData.f[index] = data;
+			AddElementHash(index);
+			MarkChanged();
 		}
 	}
 
@@ -1135,7 +1210,11 @@ namespace FieaGameEngine
 	{
 		if (SetMethodExceptionHandler(EDatumType::EVector4, index))
 		{
+			Detach();
+			RemoveElementHash(index);
 			mData.v[index] = data;
+			AddElementHash(index);
+			MarkChanged();
 		}
 	}
 
@@ -1143,7 +1222,11 @@ namespace FieaGameEngine
 	{
 		if (SetMethodExceptionHandler(EDatumType::EMatrix4x4, index))
 		{
+			Detach();
+			RemoveElementHash(index);
 			mData.m[index] = data;
+			AddElementHash(index);
+			MarkChanged();
 		}
 	}
 
@@ -1151,7 +1234,11 @@ namespace FieaGameEngine
 	{
 		if (SetMethodExceptionHandler(EDatumType::ETable, index))
 		{
+			Detach();
+			RemoveElementHash(index);
 			mData.t[index] = data;
+			AddElementHash(index);
+			MarkChanged();
 		}
 	}
 
@@ -1159,7 +1246,11 @@ namespace FieaGameEngine
 	{
 		if (SetMethodExceptionHandler(EDatumType::EString, index))
 		{
+			Detach();
+			RemoveElementHash(index);
 			mData.s[index] = data;
+			AddElementHash(index);
+			MarkChanged();
 		}
 	}
 
@@ -1167,7 +1258,11 @@ namespace FieaGameEngine
 	{
 		if (SetMethodExceptionHandler(EDatumType::ERTTIPointer, index))
 		{
+			Detach();
+			RemoveElementHash(index);
 			mData.r[index] = data;
+			AddElementHash(index);
+			MarkChanged();
 		}
 	}
 
@@ -1195,9 +1290,15 @@ namespace FieaGameEngine
 			{
 				Reserve(mCapacity + 5);
 			}
+			else
+			{
+				Detach();
+			}
 
 			mData.i[mSize] = data;
 			++mSize;
+			AddElementHash(mSize - 1);
+			MarkChanged();
 		}
 	}
 
@@ -1209,9 +1310,15 @@ namespace FieaGameEngine
 			{
 				Reserve(mCapacity + 5);
 			}
+			else
+			{
+				Detach();
+			}
 
 			mData.f[mSize] = data;
 			++mSize;
+			AddElementHash(mSize - 1);
+			MarkChanged();
 		}
 	}
 
@@ -1223,9 +1330,15 @@ namespace FieaGameEngine
 			{
 				Reserve(mCapacity + 5);
 			}
+			else
+			{
+				Detach();
+			}
 
 			mData.v[mSize] = data;
 			++mSize;
+			AddElementHash(mSize - 1);
+			MarkChanged();
 		}
 	}
 
@@ -1237,9 +1350,15 @@ namespace FieaGameEngine
 			{
 				Reserve(mCapacity + 5);
 			}
+			else
+			{
+				Detach();
+			}
 
 			mData.m[mSize] = data;
 			++mSize;
+			AddElementHash(mSize - 1);
+			MarkChanged();
 		}
 	}
 
@@ -1251,9 +1370,15 @@ namespace FieaGameEngine
 			{
 				Reserve(mCapacity + 5);
 			}
+			else
+			{
+				Detach();
+			}
 
 			mData.t[mSize] = data;
 			++mSize;
+			AddElementHash(mSize - 1);
+			MarkChanged();
 		}
 	}
 
@@ -1265,9 +1390,15 @@ namespace FieaGameEngine
 			{
 				Reserve(mCapacity + 5);
 			}
+			else
+			{
+				Detach();
+			}
 
 			new (mData.s + mSize) std::string(data);
 			++mSize;
+			AddElementHash(mSize - 1);
+			MarkChanged();
 		}
 	}
 
@@ -1279,9 +1410,15 @@ namespace FieaGameEngine
 			{
 				Reserve(mCapacity + 5);
 			}
+			else
+			{
+				Detach();
+			}
 
 			mData.r[mSize] = data;
 			++mSize;
+			AddElementHash(mSize - 1);
+			MarkChanged();
 		}
 	}
 
@@ -1351,6 +1488,9 @@ namespace FieaGameEngine
 			throw std::exception("Index out of bounds.");
 		}
 
+		Detach();
+		RemoveElementHash(index);
+
 		std::stringstream ss(data);
 		switch (mDatumType)
 		{
@@ -1389,12 +1529,25 @@ namespace FieaGameEngine
 				break;
 			}
 		}
+
+		AddElementHash(index);
+		MarkChanged();
 	}
 
 
 
 
 	std::string Datum::ToString(const std::uint32_t index)
+	{
+		Writer writer;
+		Write(writer, index);
+		return writer.Buffer();
+	}
+
+
+
+
+	void Datum::Write(Writer& writer, const std::uint32_t index) const
 	{
 		if (mDatumType == EDatumType::EUnknown)
 		{
@@ -1405,48 +1558,54 @@ namespace FieaGameEngine
 			throw std::exception("Index out of bounds.");
 		}
 
-		std::string value;
-		std::stringstream ss;
 		switch (mDatumType)
 		{
 		case EDatumType::EInteger:
 			{
-				value = std::to_string(Get<std::int32_t>(index));
+				writer.Write(mData.i[index]);
 				break;
 			}
 		case EDatumType::EFloat:
 			{
-				value = std::to_string(Get<std::float_t>(index));
+				writer.Write(mData.f[index]);
 				break;
 			}
 		case EDatumType::EVector4:
 			{
-				value = glm::to_string(Get<glm::vec4>(index));
+				writer.Write(mData.v[index]);
 				break;
 			}
 		case EDatumType::EMatrix4x4:
 			{
-				value = glm::to_string(Get<glm::mat4x4>(index));
+				writer.Write(mData.m[index]);
 				break;
 			}
 		case EDatumType::ETable:
 			{
 				if (mData.t[index] != nullptr)
 				{
-					value = Get<Scope*>(index)->ToString();
+					mData.t[index]->Write(writer);
 				}
 				break;
 			}
 		case EDatumType::EString:
 			{
-				value = Get<std::string>(index);
+				writer.Write(mData.s[index]);
 				break;
 			}
 		case EDatumType::ERTTIPointer:
 			{
-				if (mData.r[index] != nullptr)
+				if ((mData.r[index] != nullptr) && (mData.r[index] != mOwner))
 				{
-					value = Get<RTTI*>(index)->ToString();
+					Scope* scope = mData.r[index]->As<Scope>();
+					if (scope != nullptr)
+					{
+						scope->Write(writer);
+					}
+					else
+					{
+						writer.Write(mData.r[index]->ToString());
+					}
 				}
 				break;
 			}
@@ -1456,8 +1615,6 @@ namespace FieaGameEngine
 				break;
 			}
 		}
-
-		return value;
 	}
 
 
@@ -1471,8 +1628,310 @@ namespace FieaGameEngine
 
 
 
+	Datum::PayloadHeader* Datum::Header() const
+	{
+		return reinterpret_cast<PayloadHeader*>(static_cast<char*>(mData.vp) - PayloadHeaderSize);
+	}
+
+
+
+
+	void* Datum::AllocatePayload(const std::uint32_t capacity) const
+	{
+		char* memory = static_cast<char*>(malloc(PayloadHeaderSize + (TypeToSizeMapping[static_cast<std::uint32_t>(mDatumType)] * capacity)));
+		new (memory) PayloadHeader();
+		reinterpret_cast<PayloadHeader*>(memory)->mReferenceCount.store(1, std::memory_order_relaxed);
+		return (memory + PayloadHeaderSize);
+	}
+
+
+
+
+	void Datum::ReleasePayload()
+	{
+		if (!mIsInternalStorage || (mDatumType == EDatumType::EUnknown) || (mCapacity == 0))
+		{
+			return;
+		}
+
+		PayloadHeader* header = Header();
+
+		//only the last Datum sharing the array destroys it, all the others just drop their reference
+		if (header->mReferenceCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		{
+			if (mDatumType == EDatumType::EString)
+			{
+				for (std::uint32_t i = 0; i < mSize; ++i)
+				{
+					mData.s[i].~basic_string();
+				}
+			}
+
+			header->~PayloadHeader();
+			free(header);
+		}
+	}
+
+
+
+
+	void Datum::CopyPayload(const std::uint32_t capacity)
+	{
+		void* data = AllocatePayload(capacity);
+
+		if (mDatumType == EDatumType::EString)
+		{
+			for (std::uint32_t i = 0; i < mSize; ++i)
+			{
+				new (static_cast<std::string*>(data) + i) std::string(mData.s[i]);
+			}
+		}
+		else
+		{
+			memcpy_s(data, (TypeToSizeMapping[static_cast<std::uint32_t>(mDatumType)] * capacity), mData.vp, (TypeToSizeMapping[static_cast<std::uint32_t>(mDatumType)] * mSize));
+		}
+
+		ReleasePayload();
+
+		mData.vp = data;
+		mCapacity = capacity;
+	}
+
+
+
+
+	void Datum::Detach()
+	{
+		if (mIsInternalStorage && (mCapacity != 0) && (Header()->mReferenceCount.load(std::memory_order_acquire) > 1))
+		{
+			CopyPayload(mCapacity);
+		}
+	}
+
+
+
+
+	std::uint64_t Datum::Hash() const
+	{
+		std::uint64_t hash = 0;
+
+		if ((mDatumType == EDatumType::ETable) || !mIsInternalStorage || !mIsHashValid || mIsExposed)
+		{
+			for (std::uint32_t i = 0; i < mSize; ++i)
+			{
+				hash += ElementHash(i);
+			}
+
+			//nested scopes keep track of their own hashes, and exposed elements can be written behind the Datum's back, so only the other plain values are cached here
+			if (mIsInternalStorage && (mDatumType != EDatumType::ETable) && !mIsExposed)
+			{
+				mElementHash = hash;
+				mIsHashValid = true;
+			}
+		}
+		else
+		{
+			hash = mElementHash;
+		}
+
+		return MixHash(hash ^ MixHash((static_cast<std::uint64_t>(mDatumType) << 32) | mSize));
+	}
+
+
+
+
+	std::uint64_t Datum::HashBytes(const void* data, const size_t size)
+	{
+		const std::uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+		const std::uint64_t FNV_PRIME = 1099511628211ULL;
+
+		std::uint64_t hash = FNV_OFFSET_BASIS;
+		const unsigned char* bytes = static_cast<const unsigned char*>(data);
+		for (size_t i = 0; i < size; ++i)
+		{
+			hash = (hash ^ bytes[i]) * FNV_PRIME;
+		}
+
+		return hash;
+	}
+
+
+
+
+	std::uint64_t Datum::MixHash(std::uint64_t hash)
+	{
+		hash ^= (hash >> 33);
+		hash *= 0xff51afd7ed558ccdULL;
+		hash ^= (hash >> 33);
+		hash *= 0xc4ceb9fe1a85ec53ULL;
+		hash ^= (hash >> 33);
+		return hash;
+	}
+
+
+
+
+	std::uint64_t Datum::ElementHash(const std::uint32_t index) const
+	{
+		std::uint64_t hash = 0;
+
+		switch (mDatumType)
+		{
+		case EDatumType::EString:
+			{
+				hash = HashBytes(mData.s[index].c_str(), mData.s[index].size());
+				break;
+			}
+		case EDatumType::ETable:
+			{
+				if (mData.t[index] != nullptr)
+				{
+					hash = mData.t[index]->Hash();
+				}
+				break;
+			}
+		case EDatumType::ERTTIPointer:
+			{
+				//RTTI pointers are compared with Equals, which the hash has no way of mirroring, so only their count is hashed
+				break;
+			}
+		default:
+			{
+				hash = HashBytes((static_cast<char*>(mData.vp) + (index * TypeToSizeMapping[static_cast<std::uint32_t>(mDatumType)])), TypeToSizeMapping[static_cast<std::uint32_t>(mDatumType)]);
+				break;
+			}
+		}
+
+		//the elements are summed up, so the position is mixed in to keep the order significant
+		return MixHash(hash + MixHash(static_cast<std::uint64_t>(index) + 1));
+	}
+
+
+
+
+	void Datum::RemoveElementHash(const std::uint32_t index)
+	{
+		if (mIsInternalStorage && mIsHashValid && (mDatumType != EDatumType::ETable))
+		{
+			mElementHash -= ElementHash(index);
+		}
+	}
+
+
+
+
+	void Datum::AddElementHash(const std::uint32_t index)
+	{
+		if (mIsInternalStorage && mIsHashValid && (mDatumType != EDatumType::ETable))
+		{
+			mElementHash += ElementHash(index);
+		}
+	}
+
+
+
+
+	void Datum::InvalidateHash()
+	{
+		mIsHashValid = false;
+		MarkChanged();
+	}
+
+
+
+
+	void Datum::Expose()
+	{
+		//the cached hashes only have to go stale once, as they are not cached again while the Datum is exposed
+		if (!mIsExposed)
+		{
+			mIsExposed = true;
+			InvalidateHash();
+		}
+	}
+
+
+
+
+	void Datum::MarkChanged()
+	{
+		if (mOwner != nullptr)
+		{
+			mOwner->MarkChanged();
+		}
+	}
+
+
+
+
+	void Datum::RebindStorage(void* data)
+	{
+		if (mIsInternalStorage)
+		{
+			throw std::exception("Cannot rebind internal storage.");
+		}
+
+		mData.vp = data;
+		MarkChanged();
+	}
+
+
+
+
+	void Datum::ConvertToExternalStorage(void* data)
+	{
+		if (mDatumType == EDatumType::EString)
+		{
+			throw std::exception("Cannot convert string storage.");
+		}
+
+		ReleasePayload();
+
+		mData.vp = data;
+		mCapacity = mSize;
+		mIsInternalStorage = false;
+		InvalidateHash();
+	}
+
+
+
+
+	void Datum::ConvertToInternalStorage()
+	{
+		if (mIsInternalStorage)
+		{
+			return;
+		}
+		if (mDatumType == EDatumType::EString)
+		{
+			throw std::exception("Cannot convert string storage.");
+		}
+
+		void* data = mData.vp;
+		std::uint32_t size = mSize;
+		size_t byteCount = TypeToSizeMapping[static_cast<std::uint32_t>(mDatumType)] * size;
+
+		mData.vp = nullptr;
+		mSize = 0;
+		mCapacity = 0;
+		mIsInternalStorage = true;
+
+		if (size > 0)
+		{
+			Reserve(size);
+			memcpy_s(mData.vp, byteCount, data, byteCount);
+			mSize = size;
+		}
+
+		InvalidateHash();
+	}
+
+
+
+
 	Datum::~Datum()
 	{
+		mOwner = nullptr;
 		Clear();
 	}
 }
\ No newline at end of file
@@ -9,6 +9,7 @@
 namespace FieaGameEngine
 {
 	class Scope;
+	class Writer;
 
 	/**
 	*	@brief	Enumeration that contains a list of
@@ -32,9 +33,17 @@ namespace FieaGameEngine
 	*	@brief	The Datum class can store an array of primitive
 	*			or user-defined values. Different Datum objects
 	*			can store values of different types.
+	*			Copies of a Datum with internal storage share the
+	*			same values array, which is reference counted, and
+	*			a Datum only makes its own copy of the array the
+	*			first time it is modified (copy-on-write).
 	*/
 	class Datum final
 	{
+		friend class Scope;		//Scope is allowed to register itself as the owner of the Datums it contains
+		friend class Attributed;		//Attributed is allowed to rebind the external storage of its prescribed attributes
+		friend class AttributeColumn;		//AttributeColumn is allowed to move the storage of the Datums it binds in and out of its column
+
 	public:
 
 		/**
@@ -45,8 +54,9 @@ namespace FieaGameEngine
 
 		/**
 		*	@brief	Copy constructor for the Datum that takes
-		*			another Datum object and performs a deep
-		*			copy.
+		*			another Datum object and shares its values
+		*			array. The array is only deep copied when
+		*			either of the two Datums is modified.
 		*	@param	other a const reference to the Datum object
 		*			to be copied.
 		*/
@@ -125,7 +135,8 @@ namespace FieaGameEngine
 
 		/**
 		*	@brief	The copy assignment operator is overloaded to copy
-		*			one datum into another
+		*			one datum into another. Like the copy constructor,
+		*			the values array is shared until it is modified.
 		*	@param	other a const reference of the Datum to be copied
 		*	@return	reference to the Datum to which the data was copied
 		*/
@@ -811,7 +822,13 @@ namespace FieaGameEngine
 		/**
 		*	@brief	Given an optional index (defaults to 0), this method returns the
 		*			appropriate element from the values array. It is a templated method
-		*			that is specialized for the supported datatypes.
+		*			that is specialized for the supported datatypes. Since the returned
+		*			reference can be written to, a shared values array is copied first, and
+		*			the Datum is exposed: its array is no longer shared by copies, and it is
+		*			hashed on every call like external storage. Only the first call marks the
+		*			owning Scopes changed, so writes through the reference after that do not
+		*			move their change stamps. Nested scopes are the exception, as they are
+		*			only ever added or removed through the owning Scope.
 		*	@param	index the index of the element to get
 		*/
 		template<typename T>
@@ -821,6 +838,8 @@ namespace FieaGameEngine
 		std::int32_t& Get(const std::uint32_t index)
 		{
 			GetMethodExceptionHandler(EDatumType::EInteger, index);
+			Detach();
+			Expose();
 
 			return mData.i[index];
 		}
@@ -829,6 +848,8 @@ namespace FieaGameEngine
 		std::float_t& Get(const std::uint32_t index)
 		{
 			GetMethodExceptionHandler(EDatumType::EFloat, index);
+			Detach();
+			Expose();
 
 			return mData.f[index];
 		}
@@ -837,6 +858,8 @@ namespace FieaGameEngine
 		glm::vec4& Get(const std::uint32_t index)
 		{
 			GetMethodExceptionHandler(EDatumType::EVector4, index);
+			Detach();
+			Expose();
 
 			return mData.v[index];
 		}
@@ -845,6 +868,8 @@ namespace FieaGameEngine
 		glm::mat4x4& Get(const std::uint32_t index)
 		{
 			GetMethodExceptionHandler(EDatumType::EMatrix4x4, index);
+			Detach();
+			Expose();
 
 			return mData.m[index];
 		}
@@ -853,6 +878,7 @@ namespace FieaGameEngine
 		Scope*& Get(const std::uint32_t index)
 		{
 			GetMethodExceptionHandler(EDatumType::ETable, index);
+			Detach();
 
 			return mData.t[index];
 		}
@@ -861,6 +887,8 @@ namespace FieaGameEngine
 		std::string& Get(const std::uint32_t index)
 		{
 			GetMethodExceptionHandler(EDatumType::EString, index);
+			Detach();
+			Expose();
 
 			return mData.s[index];
 		}
@@ -869,6 +897,8 @@ namespace FieaGameEngine
 		RTTI*& Get(const std::uint32_t index)
 		{
 			GetMethodExceptionHandler(EDatumType::ERTTIPointer, index);
+			Detach();
+			Expose();
 
 			return mData.r[index];
 		}
@@ -958,6 +988,8 @@ namespace FieaGameEngine
 		std::int32_t PopBack()
 		{
 			PopBackMethodExceptionHandler(EDatumType::EInteger);
+			RemoveElementHash(mSize - 1);
+			MarkChanged();
 
 			std::int32_t data = mData.i[--mSize];
 			return data;
@@ -967,6 +999,8 @@ namespace FieaGameEngine
 		std::float_t PopBack()
 		{
 			PopBackMethodExceptionHandler(EDatumType::EFloat);
+			RemoveElementHash(mSize - 1);
+			MarkChanged();
 
 			std::float_t data = mData.f[--mSize];
 			return data;
@@ -976,6 +1010,8 @@ namespace FieaGameEngine
 		glm::vec4 PopBack()
 		{
 			PopBackMethodExceptionHandler(EDatumType::EVector4);
+			RemoveElementHash(mSize - 1);
+			MarkChanged();
 
 			glm::vec4 data = mData.v[--mSize];
 			return data;
@@ -985,6 +1021,8 @@ namespace FieaGameEngine
 		glm::mat4x4 PopBack()
 		{
 			PopBackMethodExceptionHandler(EDatumType::EMatrix4x4);
+			RemoveElementHash(mSize - 1);
+			MarkChanged();
 
 			glm::mat4x4 data = mData.m[--mSize];
 			return data;
@@ -994,6 +1032,8 @@ namespace FieaGameEngine
 		Scope* PopBack()
 		{
 			PopBackMethodExceptionHandler(EDatumType::ETable);
+			RemoveElementHash(mSize - 1);
+			MarkChanged();
 
 			Scope* data = mData.t[--mSize];
 			return data;
@@ -1003,6 +1043,9 @@ namespace FieaGameEngine
 		std::string PopBack()
 		{
 			PopBackMethodExceptionHandler(EDatumType::EString);
+			Detach();
+			RemoveElementHash(mSize - 1);
+			MarkChanged();
 
 			std::string data = mData.s[--mSize];
 			mData.s[mSize].~basic_string();
@@ -1013,6 +1056,8 @@ namespace FieaGameEngine
 		RTTI* PopBack()
 		{
 			PopBackMethodExceptionHandler(EDatumType::ERTTIPointer);
+			RemoveElementHash(mSize - 1);
+			MarkChanged();
 
 			RTTI* data = mData.r[--mSize];
 			return data;
@@ -1043,12 +1088,51 @@ namespace FieaGameEngine
 		*/
 		std::string ToString(const std::uint32_t index = 0);
 
+		/**
+		*	@brief	Given a Writer and an optional index (defaults to 0), this method writes the
+		*			appropriate element in the values array to the Writer, in the same format as
+		*			ToString, but without building an intermediate string. Nested scopes are
+		*			written recursively. An RTTI pointer to the Scope that owns this Datum (like
+		*			the "this" attribute of an Attributed) is skipped, to avoid infinite recursion.
+		*	@param	writer the Writer to write to
+		*	@param	index the location of the element to be written
+		*/
+		void Write(Writer& writer, const std::uint32_t index = 0) const;
+
 		/**
 		*	@brief	Method to check whether the datum is external storage
 		*	@return	bool indicating whether the datum is external storage
 		*/
 		bool IsExternalStorage() const;
 
+		/**
+		*	@brief	Method to get a 64-bit hash of the contents of the Datum. Equal Datums
+		*			always have equal hashes, so two different hashes mean that the Datums
+		*			differ. For internal storage the hash is cached and kept up to date by
+		*			Set, PushBack and PopBack, while other changes only mark it stale.
+		*			External storage is hashed every time, since the bound array can be
+		*			written without going through the Datum. Nested tables contribute the
+		*			hash of each of their Scopes.
+		*	@return	unsigned 64-bit integer representing the contents of the Datum
+		*/
+		std::uint64_t Hash() const;
+
+		/**
+		*	@brief	Helper method that hashes a block of memory (FNV-1a).
+		*	@param	data pointer to the memory to be hashed
+		*	@param	size the number of bytes to be hashed
+		*	@return	unsigned 64-bit hash of the memory
+		*/
+		static std::uint64_t HashBytes(const void* data, const size_t size);
+
+		/**
+		*	@brief	Helper method that scrambles the bits of a hash, so that hashes can be
+		*			combined by simply adding them up.
+		*	@param	hash the hash to be scrambled
+		*	@return	the scrambled hash
+		*/
+		static std::uint64_t MixHash(std::uint64_t hash);
+
 		/**
 		*	@brief	Destructor for the Datum class that ensures there are no memory leaks.
 		*/
@@ -1093,11 +1177,122 @@ namespace FieaGameEngine
 			DatumType& operator=(const DatumType& rhs) = default;
 		};
 
+		/**
+		*	@brief	The header that is allocated in front of every internal values array.
+		*			It holds the number of Datums that currently share the array.
+		*/
+		struct PayloadHeader
+		{
+			std::atomic<std::uint32_t> mReferenceCount;		/**<	Number of Datums that share the values array	*/
+		};
+
+		/**
+		*	@brief	Helper method to get the header of the internal values array.
+		*	@return	pointer to the header in front of the values array
+		*/
+		PayloadHeader* Header() const;
+
+		/**
+		*	@brief	Helper method that allocates a new internal values array, along with
+		*			its header. The reference count of the new array is 1.
+		*	@param	capacity the number of elements the array can hold
+		*	@return	pointer to the first element of the new array
+		*/
+		void* AllocatePayload(const std::uint32_t capacity) const;
+
+		/**
+		*	@brief	Helper method that gives up this Datum's share of the values array.
+		*			The elements are destroyed and the memory is freed only if this was
+		*			the last Datum using the array.
+		*/
+		void ReleasePayload();
+
+		/**
+		*	@brief	Helper method that copies the values array into a newly allocated
+		*			array owned only by this Datum, and releases the old one.
+		*	@param	capacity the capacity of the new array, at least the current size
+		*/
+		void CopyPayload(const std::uint32_t capacity);
+
+		/**
+		*	@brief	Helper method that is called before the values array is modified.
+		*			If the array is shared with other Datums, this Datum gets its own copy.
+		*/
+		void Detach();
+
+		/**
+		*	@brief	Helper method that hashes a single element along with its position.
+		*	@param	index the index of the element to be hashed
+		*	@return	unsigned 64-bit hash of the element
+		*/
+		std::uint64_t ElementHash(const std::uint32_t index) const;
+
+		/**
+		*	@brief	Helper method that takes an element out of the cached hash, before the
+		*			element is overwritten or removed.
+		*	@param	index the index of the element
+		*/
+		void RemoveElementHash(const std::uint32_t index);
+
+		/**
+		*	@brief	Helper method that adds an element to the cached hash, after the
+		*			element is written.
+		*	@param	index the index of the element
+		*/
+		void AddElementHash(const std::uint32_t index);
+
+		/**
+		*	@brief	Helper method that marks the cached hash as stale, for changes that
+		*			cannot be tracked element by element.
+		*/
+		void InvalidateHash();
+
+		/**
+		*	@brief	Helper method that is called when Get hands out a reference that can be
+		*			written. The first call marks the cached hashes stale, after which they
+		*			are not cached for this Datum until it is cleared.
+		*/
+		void Expose();
+
+		/**
+		*	@brief	Helper method that lets the Scope which owns this Datum know that it
+		*			has changed.
+		*/
+		void MarkChanged();
+
+		/**
+		*	@brief	Helper method that points an external storage Datum at a different copy of
+		*			its array, keeping its type and size. The array is not read, so it can be
+		*			rebound before the array itself is constructed.
+		*	@param	data pointer to the new external array
+		*/
+		void RebindStorage(void* data);
+
+		/**
+		*	@brief	Helper method that switches the Datum to external storage at the given address,
+		*			releasing its internal array if it had one. The elements are not copied, the
+		*			caller is expected to have written them at the new address already.
+		*	@param	data pointer to the external array
+		*/
+		void ConvertToExternalStorage(void* data);
+
+		/**
+		*	@brief	Helper method that copies the elements of an external storage Datum into a newly
+		*			allocated internal array, and switches the Datum to internal storage.
+		*/
+		void ConvertToInternalStorage();
+
 		DatumType mData;				/**<	The values array of the Datum	*/
 		std::uint32_t mSize;			/**<	The size of the values array	*/
 		std::uint32_t mCapacity;		/**<	The capacity of the values array	*/
 		EDatumType mDatumType;			/**<	The type of data that this Datum stores	*/
 		bool mIsInternalStorage;		/**<	Bool that indicates whether this Datum points to internal storage or external storage	*/
+		Scope* mOwner;					/**<	The Scope that contains this Datum, if any	*/
+		mutable std::uint64_t mElementHash;		/**<	Cached sum of the hashes of the elements, for internal storage	*/
+		mutable bool mIsHashValid;		/**<	Bool that indicates whether mElementHash is up to date	*/
+		bool mIsExposed;				/**<	Bool that indicates whether Get handed out a reference that can be written	*/
+
+		static const size_t PayloadHeaderSize;		/**<	The space reserved in front of the values array for its header, which keeps the elements aligned	*/
 
 		static const size_t TypeToSizeMapping[static_cast<std::uint32_t>(EDatumType::ENumberOfSupportedDatatypes)];	/**<	A static array that stores the size of each of the supported datatypes indexed by their enum representations	*/
 	};
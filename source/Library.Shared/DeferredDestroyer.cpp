@@ -0,0 +1,154 @@
+#include "pch.h"
+#include "DeferredDestroyer.h"
+#include "Attributed.h"
+
+
+namespace FieaGameEngine
+{
+
+	Vector<DeferredDestroyer::PendingObject> DeferredDestroyer::mPending;
+	std::mutex DeferredDestroyer::mPendingMutex;
+	bool DeferredDestroyer::mDestroyOnBackgroundThread = false;
+	std::future<void> DeferredDestroyer::mBackgroundDestruction;
+
+
+
+
+	bool DeferredDestroyer::Enqueue(Attributed& object, const World* world)
+	{
+		return Enqueue(object.GetHandle(), world);
+	}
+
+
+
+
+	bool DeferredDestroyer::Enqueue(const Handle& handle, const World* world)
+	{
+		if (!HandleTable::MarkForDestruction(handle))
+		{
+			return false;
+		}
+
+		std::lock_guard<std::mutex> lock(mPendingMutex);
+		mPending.PushBack({ handle, world });
+		return true;
+	}
+
+
+
+
+	void DeferredDestroyer::Cleanup()
+	{
+		Destroy(nullptr);
+	}
+
+
+
+
+	void DeferredDestroyer::Cleanup(const World& world)
+	{
+		Destroy(&world);
+	}
+
+
+
+
+	void DeferredDestroyer::Destroy(const World* world)
+	{
+		Vector<Handle> batch;
+		{
+			std::lock_guard<std::mutex> lock(mPendingMutex);
+
+			//the objects of other worlds stay queued, in the order they were queued
+			Vector<PendingObject> remaining;
+			for (std::uint32_t i = 0; i < mPending.Size(); ++i)
+			{
+				if ((world == nullptr) || (mPending[i].mWorld == world))
+				{
+					batch.PushBack(mPending[i].mHandle);
+				}
+				else
+				{
+					remaining.PushBack(mPending[i]);
+				}
+			}
+			std::swap(remaining, mPending);
+		}
+
+		if (batch.IsEmpty())
+		{
+			return;
+		}
+
+		if (!mDestroyOnBackgroundThread)
+		{
+			//an object may take queued children down with it, whose handles are then dead and skipped
+			for (std::uint32_t i = 0; i < batch.Size(); ++i)
+			{
+				delete HandleTable::Resolve(batch[i]);
+			}
+			return;
+		}
+
+		Flush();
+
+		Vector<Attributed*> detached;
+		detached.Reserve(batch.Size());
+		for (std::uint32_t i = 0; i < batch.Size(); ++i)
+		{
+			Attributed* object = HandleTable::Resolve(batch[i]);
+			if (object != nullptr)
+			{
+				object->Detach();
+				HandleTable::Release(object->mHandle);
+				object->mHandle = Handle();
+				detached.PushBack(object);
+			}
+		}
+
+		mBackgroundDestruction = std::async(std::launch::async, [detached]()
+		{
+			for (std::uint32_t i = 0; i < detached.Size(); ++i)
+			{
+				delete detached[i];
+			}
+		});
+	}
+
+
+
+
+	void DeferredDestroyer::SetDestroyOnBackgroundThread(const bool destroyOnBackgroundThread)
+	{
+		mDestroyOnBackgroundThread = destroyOnBackgroundThread;
+	}
+
+
+
+
+	bool DeferredDestroyer::DestroysOnBackgroundThread()
+	{
+		return mDestroyOnBackgroundThread;
+	}
+
+
+
+
+	void DeferredDestroyer::Flush()
+	{
+		if (mBackgroundDestruction.valid())
+		{
+			mBackgroundDestruction.get();
+		}
+	}
+
+
+
+
+	std::uint32_t DeferredDestroyer::PendingCount()
+	{
+		std::lock_guard<std::mutex> lock(mPendingMutex);
+		return mPending.Size();
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <future>
+#include <mutex>
+#include "Vector.h"
+#include "HandleTable.h"
+
+/**
+*	@brief	The namespace under which the game engine is implemented.
+*/
+namespace FieaGameEngine
+{
+
+	class Attributed;	//forward declaration for the Attributed class
+	class World;		//forward declaration for the World class
+
+	/**
+	*	@brief	The DeferredDestroyer class serves as a garbage collector for entities, sectors, actions,
+	*			reactions and any other Attributed. Objects are queued by handle while the world is being
+	*			updated and destroyed together once the frame is over, so that nothing is deleted out from
+	*			under the loops that are still walking the world. Queuing an object twice, or queuing an
+	*			object that dies with its parent before the end of the frame, is harmless. Objects with
+	*			heavy destructors can be destroyed on a background thread, in which case they are only
+	*			detached from the world at the end of the frame. The world flushes them before it
+	*			delivers the events of the next frame, since a reaction stays subscribed until its
+	*			destructor runs.
+	*/
+	class DeferredDestroyer final
+	{
+
+	public:
+
+		/**
+		*	@brief	The default constructor is deleted, since the class only has static members.
+		*/
+		DeferredDestroyer() = delete;
+
+		/**
+		*	@brief	The copy constructor for this class is deleted.
+		*/
+		DeferredDestroyer(const DeferredDestroyer& other) = delete;
+
+		/**
+		*	@brief	The move constructor for this class is deleted.
+		*/
+		DeferredDestroyer(DeferredDestroyer&& other) = delete;
+
+		/**
+		*	@brief	The copy assignment operator is deleted.
+		*/
+		DeferredDestroyer& operator=(const DeferredDestroyer& other) = delete;
+
+		/**
+		*	@brief	The move assignment operator is deleted.
+		*/
+		DeferredDestroyer& operator=(DeferredDestroyer&& other) = delete;
+
+		/**
+		*	@brief	The destructor is deleted, since the class only has static members.
+		*/
+		~DeferredDestroyer() = delete;
+
+		/**
+		*	@brief	Static method to queue an object to be destroyed at the end of the frame. The object
+		*			must have been created with new, as Scopes that are adopted always are.
+		*	@param	object the object to be destroyed
+		*	@param	world the world whose update destroys the object, or nullptr if it belongs to none
+		*	@return	bool indicating whether the object was queued, false if it already was
+		*/
+		static bool Enqueue(Attributed& object, const World* world = nullptr);
+
+		/**
+		*	@brief	Static method to queue the object that a handle refers to.
+		*	@param	handle the handle of the object to be destroyed
+		*	@param	world the world whose update destroys the object, or nullptr if it belongs to none
+		*	@return	bool indicating whether the object was queued, false if it is dead or already queued
+		*/
+		static bool Enqueue(const Handle& handle, const World* world = nullptr);
+
+		/**
+		*	@brief	Static method that destroys all the queued objects that are still alive, of every world
+		*			and of none, or hands them to a background thread. The handles of the objects are
+		*			dead when it returns.
+		*/
+		static void Cleanup();
+
+		/**
+		*	@brief	Static method that destroys the queued objects of a world, like Cleanup(), and leaves
+		*			those of other worlds queued. It is called by the world at the end of every update.
+		*	@param	world the world whose objects are destroyed
+		*/
+		static void Cleanup(const World& world);
+
+		/**
+		*	@brief	Static method to choose whether queued objects are destroyed on a background thread.
+		*	@param	destroyOnBackgroundThread true to destroy the objects on a background thread
+		*/
+		static void SetDestroyOnBackgroundThread(const bool destroyOnBackgroundThread);
+
+		/**
+		*	@brief	Static method to check whether queued objects are destroyed on a background thread.
+		*	@return	bool indicating whether the objects are destroyed on a background thread
+		*/
+		static bool DestroysOnBackgroundThread();
+
+		/**
+		*	@brief	Static method to wait until the objects handed to the background thread are destroyed.
+		*/
+		static void Flush();
+
+		/**
+		*	@brief	Static method to get the number of objects that are queued.
+		*	@return	unsigned int representing the number of queued objects
+		*/
+		static std::uint32_t PendingCount();
+
+	private:
+
+		/**
+		*	@brief	A queued object, with the world that destroys it.
+		*/
+		struct PendingObject
+		{
+			Handle mHandle;				/**<	The handle of the object	*/
+			const World* mWorld;		/**<	The world whose update destroys the object, if any	*/
+		};
+
+		/**
+		*	@brief	Helper method that destroys the queued objects of a world, or all of them.
+		*	@param	world the world whose objects are destroyed, or nullptr for all the objects
+		*/
+		static void Destroy(const World* world);
+
+		static Vector<PendingObject> mPending;				/**<	The queued objects	*/
+		static std::mutex mPendingMutex;					/**<	The lock for the queue, since objects may be queued from any thread	*/
+		static bool mDestroyOnBackgroundThread;				/**<	Whether the objects are destroyed on a background thread	*/
+		static std::future<void> mBackgroundDestruction;	/**<	The destruction that is running on the background thread, if any	*/
+
+	};
+
+}
\ No newline at end of file
@@ -10,7 +10,7 @@ namespace FieaGameEngine
 
 	Entity::Entity(const std::string& name) : mName(name)
 	{
-		InitializeAttributes();
+		InitializePrescribedAttributes();
 	}
 
 
@@ -19,6 +19,13 @@ namespace FieaGameEngine
 	Entity::Entity(const Entity& other) : Attributed::Attributed(other), mName(other.mName), mActions(other.mActions)
 	{
 		UpdatePrescribedAttributes();
+
+		//the copied attributes still point into the columns of the sector of the other entity
+		Sector* sector = ParentSector(other);
+		if (sector != nullptr)
+		{
+			sector->UnbindColumns(*this);
+		}
 	}
 
 
@@ -27,6 +34,13 @@ namespace FieaGameEngine
 	Entity::Entity(Entity&& other) : Attributed::Attributed(std::move(other)), mName(std::move(other.mName)), mActions(std::move(other.mActions))
 	{
 		UpdatePrescribedAttributes();
+
+		//the sector of the other entity adopted this one in its place before it was an entity, so it is bound here
+		Sector* sector = ParentSector(*this);
+		if (sector != nullptr)
+		{
+			sector->BindColumns(*this);
+		}
 	}
 
 
@@ -40,6 +54,13 @@ namespace FieaGameEngine
 			mName = other.mName;
 			mActions = other.mActions;
 			UpdatePrescribedAttributes();
+
+			//the copied attributes still point into the columns of the sector of the other entity
+			Sector* sector = ParentSector(other);
+			if (sector != nullptr)
+			{
+				sector->UnbindColumns(*this);
+			}
 		}
 
 		return *this;
@@ -75,6 +96,36 @@ namespace FieaGameEngine
 	void Entity::SetName(const std::string& name)
 	{
 		mName = name;
+		MarkChanged();
+	}
+
+
+
+
+	Action* Entity::FindAction(const std::string& actionInstanceName)
+	{
+		return mActionIndex.Find(actionInstanceName, *this, Find("Actions"));
+	}
+
+
+
+
+	void Entity::OnChildAdopted(Scope& child, const std::string& key)
+	{
+		Action* action = child.As<Action>();
+		if ((action != nullptr) && (key == "Actions"))
+		{
+			mActionIndex.Add(*action);
+			mActionArray.Add(*action);
+		}
+	}
+
+
+
+
+	void Entity::OnChildOrphaned(Scope& child)
+	{
+		mActionArray.Remove(child);
 	}
 
 
@@ -83,7 +134,7 @@ namespace FieaGameEngine
 	Sector const* Entity::GetSector() const
 	{
 		assert(GetParent() != nullptr);
-		assert(GetParent()->Is(Sector::TypeIdClass()));
+		assert(GetParent()->Is<Sector>());
 		return GetParent()->As<Sector>();
 	}
 
@@ -132,11 +183,11 @@ namespace FieaGameEngine
 	{
 		worldState.CurrentEntity = this;
 
-		mActions = Find("Actions");
-		for (std::uint32_t i = 0; i < mActions->Size(); ++i)
+		//actions created during the update are appended, so the array is walked by index
+		const Vector<Action*>& actions = mActionArray.Get(mActions);
+		for (std::uint32_t i = 0; i < actions.Size(); ++i)
 		{
-			assert((*mActions)[i].Is(Action::TypeIdClass()));
-			(*mActions)[i].As<Action>()->Update(worldState);
+			actions[i]->Update(worldState);
 		}
 	}
 
@@ -151,20 +202,19 @@ namespace FieaGameEngine
 
 
 
-	void Entity::InitializeAttributes()
+	Sector* Entity::ParentSector(const Entity& entity)
 	{
-		mActions = &Append("Actions");
-		AddToPrescribedAttributes("Actions");
-		AddExternalPrescribedAttribute("Name", &mName, 1);
+		Scope* parent = entity.GetParent();
+		return (parent != nullptr) ? parent->As<Sector>() : nullptr;
 	}
 
 
 
 
-	void Entity::UpdatePrescribedAttributes()
+	void Entity::InitializeAttributes()
 	{
-		(*this)["Name"].SetStorage(&mName, 1);
-		*Find("Actions") = *mActions;
+		AddTablePrescribedAttribute("Actions", &Entity::mActions);
+		AddExternalPrescribedAttribute("Name", &Entity::mName);
 	}
 
 }
\ No newline at end of file
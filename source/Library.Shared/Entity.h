@@ -4,6 +4,8 @@
 #include "WorldState.h"
 #include "Action.h"
 #include "Factory.h"
+#include "ActionIndex.h"
+#include "ChildArray.h"
 
 /**
 *	@brief	The namespace under which the game engine is implemented.
@@ -91,6 +93,14 @@ namespace FieaGameEngine
 		*/
 		Action& CreateAction(const std::string& actionClassName, const std::string& actionInstanceName);
 
+		/**
+		*	@brief	Method to find one of the actions of the entity by its instance name, through an index
+		*			of the actions, so the time it takes does not depend on the number of actions.
+		*	@param	actionInstanceName instance name of the action
+		*	@return	pointer to the action if it was found, nullptr otherwise
+		*/
+		Action* FindAction(const std::string& actionInstanceName);
+
 		/**
 		*	@brief	Method that gets the sector that contains this entity.
 		*	@return	pointer to the sector that contains this entity.
@@ -122,18 +132,40 @@ namespace FieaGameEngine
 		*/
 		virtual void InitializeAttributes() override;
 
+	protected:
+
 		/**
-		*	@brief	Method to update the list of prescribed attributes whenever
-		*			the list is reinitialized. Overriden from the Attributed class.
+		*	@brief	Method that indexes actions that are adopted under the actions key, and adds them to
+		*			the array of actions that is updated. Overriden from the Scope class.
+		*	@param	child the adopted child
+		*	@param	key the key that the child was adopted under
 		*/
-		virtual void UpdatePrescribedAttributes() override;
+		virtual void OnChildAdopted(Scope& child, const std::string& key) override;
+
+		/**
+		*	@brief	Method that drops actions that leave the entity from the index and from the array
+		*			of actions that is updated. Overriden from the Scope class.
+		*	@param	child the child that left
+		*/
+		virtual void OnChildOrphaned(Scope& child) override;
 
 	private:
 
+		/**
+		*	@brief	Helper method that gets the sector that contains the given entity, if any.
+		*	@param	entity the entity whose sector is needed
+		*	@return	pointer to the sector, nullptr if the entity is not contained in a sector
+		*/
+		static Sector* ParentSector(const Entity& entity);
+
 		std::string mName;		/**<	The name of the entity	*/
 
 		Datum* mActions;		/**<	Datum pointer that points to the datum containing the list of actions	*/
 
+		ActionIndex mActionIndex;		/**<	Index of the actions by their instance names	*/
+
+		ChildArray<Action> mActionArray;		/**<	The actions that are updated, in order	*/
+
 	};
 
 
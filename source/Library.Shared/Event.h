@@ -1,17 +1,64 @@
 #pragma once
 
 #include "IEventPublisher.h"
+#include "HashMap.h"
+#include "ObjectPool.h"
+#include "FrameAllocator.h"
+#include "EventBatch.h"
 
 /**
 *	@brief	The namespace under which the game engine is implemented.
 */
 namespace FieaGameEngine
 {
+	/**
+	*	@brief	The EventRoute struct gives the route of a payload, i.e. the key that subscribers of
+	*			its event type can subscribe under to only hear about payloads with that key. Payload
+	*			types are not routed unless they specialize it.
+	*/
+	template<typename Payload>
+	struct EventRoute
+	{
+		/**
+		*	@brief	Static method to get the route of a payload.
+		*	@param	payload the payload
+		*	@return	pointer to the route, or nullptr if the payload is not routed
+		*/
+		static const std::string* Key(const Payload& payload);
+	};
+
+	/**
+	*	@brief	The EventCoalescing struct gives the coalescing key of a payload. Batch subscribers that
+	*			coalesce only get the latest event of each key in a batch, e.g. the last position of
+	*			each entity. Payloads are not coalesced unless the type specializes it, and payloads
+	*			without a key are never dropped.
+	*/
+	template<typename Payload>
+	struct EventCoalescing
+	{
+		/**
+		*	@brief	Static method to get the coalescing key of a payload.
+		*	@param	payload the payload
+		*	@param	key the key of the payload, if it has one
+		*	@return	bool indicating whether the payload has a key
+		*/
+		static bool Key(const Payload& payload, std::uint64_t& key);
+	};
+
 	/**
 	*	@brief	The Event class is a templated class that derives from the EventPublisher interface.
 	*			The Event system implements the observer pattern and each event has a set of subscribers.
 	*			Events carry a templated data 'payload' and can be delivered immediately, or queued for
-	*			future delivery.
+	*			future delivery. The payload is immutable once the event is built, and is reference counted,
+	*			so copies of an event share it and subscribers read it in place. Subscribers may also subscribe under a route, in which case they are only
+	*			notified of events whose payload has that route, see EventRoute. Batch subscribers are
+	*			notified of the due events of the type together, see IEventBatchSubscriber.
+	*			The subscribers of the type are kept in a list that is never changed once it is published.
+	*			Subscribing and unsubscribing publish a changed copy, so deliveries read the list without
+	*			locking, and subscribers may come and go at any time. Removing a subscriber waits for the
+	*			deliveries that started with the previous list, so a subscriber may be destroyed once it
+	*			has unsubscribed. A subscriber that unsubscribes from inside a notification does not wait,
+	*			and may still be notified by the deliveries that are in flight on other threads.
 	*/
 	template<typename Payload>
 	class Event : public IEventPublisher
@@ -29,7 +76,21 @@ namespace FieaGameEngine
 		Event(const Payload& payload = Payload(), const Vector<IEventSubscriber*>& subscribers = Vector<IEventSubscriber*>());
 
 		/**
-		*	@brief	Copy constructor for the Event class is defaulted
+		*	@brief	Parameterized constructor that moves the payload into the event
+		*	@param	payload the data that this event contains specific to the template
+		*	@param	subscribers the list of subscribers that will subscribe to this event
+		*/
+		explicit Event(Payload&& payload, const Vector<IEventSubscriber*>& subscribers = Vector<IEventSubscriber*>());
+
+		/**
+		*	@brief	Parameterized constructor that shares a payload that is already built, e.g. with
+		*			another event
+		*	@param	payload the shared payload, which must not be nullptr
+		*/
+		explicit Event(const std::shared_ptr<const Payload>& payload);
+
+		/**
+		*	@brief	Copy constructor for the Event class is defaulted. The copy shares the payload.
 		*	@param	other the event to be copied
 		*/
 		Event(const Event& other) = default;
@@ -64,29 +125,184 @@ namespace FieaGameEngine
 		static void Subscribe(IEventSubscriber& eventSubscriber);
 
 		/**
-		*	@brief	Static method to remove a subscriber from the list of subscribers for this event type
+		*	@brief	Static method to remove a subscriber from the list of subscribers for this event type.
+		*			Unless it is called from inside a notification, it returns once the deliveries that
+		*			were in flight are over, after which the subscriber is not notified again.
 		*	@param	eventSubscriber reference to the subscriber
 		*/
 		static void Unsubscribe(IEventSubscriber& eventSubscriber);
 
 		/**
-		*	@brief	Static method to remove all subscribers for this event type
+		*	@brief	Static method to remove all subscribers for this event type, waiting for the
+		*			deliveries in flight like Unsubscribe
 		*/
 		static void UnsubscribeAll();
 
+		/**
+		*	@brief	Static method to add a subscriber that is only notified of events whose payload has the given route
+		*	@param	eventSubscriber reference to the subscriber
+		*	@param	route the route of the payloads that the subscriber is notified of
+		*/
+		static void Subscribe(IEventSubscriber& eventSubscriber, const std::string& route);
+
+		/**
+		*	@brief	Static method to remove a subscriber from the subscribers of a route, waiting for the
+		*			deliveries in flight like Unsubscribe
+		*	@param	eventSubscriber reference to the subscriber
+		*	@param	route the route that the subscriber was subscribed under
+		*/
+		static void Unsubscribe(IEventSubscriber& eventSubscriber, const std::string& route);
+
+		/**
+		*	@brief	Static method to add a subscriber that is notified of the events of this type in batches
+		*	@param	eventSubscriber reference to the batch subscriber
+		*/
+		static void SubscribeBatch(IEventBatchSubscriber<Payload>& eventSubscriber);
+
+		/**
+		*	@brief	Static method to remove a subscriber from the batch subscribers of this event type,
+		*			waiting for the deliveries in flight like Unsubscribe
+		*	@param	eventSubscriber reference to the batch subscriber
+		*/
+		static void UnsubscribeBatch(IEventBatchSubscriber<Payload>& eventSubscriber);
+
 		/**
 		*	@brief	Method to obtain the payload of this event
 		*	@return	reference to the Payload object contained in this event
 		*/
 		const Payload& Message() const;
 
+		/**
+		*	@brief	Method to obtain the shared payload of this event, e.g. to raise another event with it
+		*	@return	reference to the shared pointer to the payload
+		*/
+		const std::shared_ptr<const Payload>& SharedMessage() const;
+
+		/**
+		*	@brief	Static method that creates an event whose payload is constructed in place from the
+		*			given arguments. The event and the payload are allocated from pools.
+		*	@param	args the arguments of the constructor of the payload
+		*	@return	shared pointer to the event
+		*/
+		template<typename... Args>
+		static std::shared_ptr<Event> Emplace(Args&&... args);
+
+		/**
+		*	@brief	Static method that creates a transient event, i.e. one whose event and payload are
+		*			allocated from a frame allocator, for events that are delivered within the frame.
+		*			The event must be let go of before the allocator is reset; an event queue promotes
+		*			the transient events that it holds on to.
+		*	@param	allocator the frame allocator
+		*	@param	args the arguments of the constructor of the payload
+		*	@return	shared pointer to the event
+		*/
+		template<typename... Args>
+		static std::shared_ptr<Event> EmplaceTransient(FrameAllocator& allocator, Args&&... args);
+
+		/**
+		*	@brief	Method that copies this event and its payload into pooled storage, keeping its time.
+		*			Overriden from the IEventPublisher class.
+		*	@return	shared pointer to the copy
+		*/
+		virtual std::shared_ptr<IEventPublisher> Promote() const override;
+
+		/**
+		*	@brief	Method that delivers a batch of events of this type. Overriden from the IEventPublisher class.
+		*	@param	events pointer to the first of the events, which are all of this type
+		*	@param	count the number of events
+		*	@param	jobs the job system that delivers the events, or nullptr to deliver them on the calling thread
+		*	@param	grainSize the largest number of subscribers in one group
+		*	@param	isOrdered whether the events are delivered one after the other
+		*/
+		virtual void DeliverBatch(const std::shared_ptr<IEventPublisher>* events, const std::uint32_t count, JobSystem* jobs = nullptr, const std::uint32_t grainSize = SubscriberGrainSize, const bool isOrdered = false) override;
+
+	protected:
+
+		/**
+		*	@brief	Method that notifies the subscribers of this type, and those of the route of the payload.
+		*			Overriden from the IEventPublisher class.
+		*	@param	includeBatchSubscribers whether the batch subscribers are notified as well
+		*	@param	jobs the job system that notifies the subscribers in groups, or nullptr
+		*	@param	grainSize the largest number of subscribers in one group
+		*/
+		virtual void NotifySubscribers(const bool includeBatchSubscribers, JobSystem* jobs, const std::uint32_t grainSize) const override;
+
 	private:
 
-		static std::mutex mMutex;							/**<	static mutex for the templated event class	*/
+		/**
+		*	@brief	The subscribers of the event type, as published by the last change.
+		*/
+		struct SubscriberList
+		{
+			Vector<IEventSubscriber*> mSubscribers;									/**<	the subscribers of all the events of the type	*/
+			HashMap<std::string, Vector<IEventSubscriber*>> mRoutedSubscribers;		/**<	map from routes to the subscribers of that route	*/
+			Vector<IEventBatchSubscriber<Payload>*> mBatchSubscribers;				/**<	the batch subscribers	*/
+		};
+
+		/**
+		*	@brief	Helper method that notifies the subscribers of a list.
+		*	@param	subscribers the list of subscribers
+		*	@param	includeBatchSubscribers whether the batch subscribers are notified as well
+		*	@param	jobs the job system that notifies the subscribers in groups, or nullptr
+		*	@param	grainSize the largest number of subscribers in one group
+		*/
+		void NotifySubscribers(const SubscriberList& subscribers, const bool includeBatchSubscribers, JobSystem* jobs, const std::uint32_t grainSize) const;
+
+		/**
+		*	@brief	Helper method that notifies a batch subscriber of a batch, timing the call when the
+		*			EventProfiler samples it. This event stands for the batch in the profile.
+		*	@param	subscriber the batch subscriber
+		*	@param	events the events of the batch
+		*/
+		void NotifyBatchSubscriber(IEventBatchSubscriber<Payload>& subscriber, const Vector<const Event*>& events) const;
+
+		/**
+		*	@brief	Static helper method that publishes a changed copy of the subscribers. Changes are
+		*			made one at a time, and a change that leaves the list as it was publishes nothing.
+		*	@param	change the change, which returns whether it changed the copy it is given
+		*	@param	waitForDeliveries whether to wait for the deliveries that use the previous list, which
+		*			removals do so that the removed subscribers are not notified once they return
+		*/
+		template<typename Change>
+		static void ChangeSubscribers(Change change, const bool waitForDeliveries);
+
+		/**
+		*	@brief	Static helper method that waits until the deliveries that started before the last
+		*			change are over. It returns at once when called from inside a notification, whose
+		*			own delivery may be one of them.
+		*/
+		static void WaitForDeliveries();
+
+		/**
+		*	@brief	Counts a delivery of the type in for as long as it lives, so that removals can wait
+		*			for it. A delivery reads the list of subscribers only while it is counted in.
+		*/
+		struct DeliveryScope
+		{
+			DeliveryScope();
+			~DeliveryScope();
+
+			std::uint32_t mEpoch;				/**<	the counter that the delivery is counted in	*/
+		};
+
+		/**
+		*	@brief	Helper method that keeps the latest event of each coalescing key in a batch.
+		*	@param	batch the events, in the order they expire
+		*	@param	coalesced the events that are kept, in the same order
+		*/
+		static void Coalesce(const Vector<const Event*>& batch, Vector<const Event*>& coalesced);
+
+		static std::mutex mMutex;							/**<	static mutex that makes the changes to the subscribers one at a time	*/
+
+		static std::mutex mGraceMutex;						/**<	static mutex that makes the waits for deliveries one at a time, since each flips the epoch	*/
+
+		static std::atomic<std::uint32_t> mDeliveryEpoch;	/**<	the counter that the deliveries that start now are counted in	*/
+
+		static std::atomic<std::uint32_t> mDeliveries[2];	/**<	the deliveries in flight, counted by the epoch that they started in	*/
 
-		Payload mPayload;									/**<	the payload object	*/
+		std::shared_ptr<const Payload> mPayload;			/**<	the payload object, shared by the copies of this event	*/
 		
-		static Vector<IEventSubscriber*> mSubscribers;		/**<	static vector of pointers to event subscribers	*/
+		static std::shared_ptr<const SubscriberList> mSubscriberList;		/**<	the published subscribers of the event type, only accessed atomically	*/
 
 	};
 
@@ -1,5 +1,7 @@
 #include "pch.h"
 #include "Event.h"
+#include "JobSystem.h"
+#include "EventProfiler.h"
 
 
 namespace FieaGameEngine
@@ -9,17 +11,43 @@ namespace FieaGameEngine
 
 
 	template<typename Payload>
-	Vector<IEventSubscriber*> Event<Payload>::mSubscribers(0);
+	std::shared_ptr<const typename Event<Payload>::SubscriberList> Event<Payload>::mSubscriberList(std::make_shared<typename Event<Payload>::SubscriberList>());
 
 	template<typename Payload>
 	std::mutex Event<Payload>::mMutex;
 
+	template<typename Payload>
+	std::mutex Event<Payload>::mGraceMutex;
+
+	template<typename Payload>
+	std::atomic<std::uint32_t> Event<Payload>::mDeliveryEpoch(0);
+
+	template<typename Payload>
+	std::atomic<std::uint32_t> Event<Payload>::mDeliveries[2];
+
+
+
 
 	template<typename Payload>
-	Event<Payload>::Event(const Payload& payload, const Vector<IEventSubscriber*>& subscribers) : IEventPublisher::IEventPublisher(mSubscribers, mMutex), mPayload(payload)
+	const std::string* EventRoute<Payload>::Key(const Payload& payload)
 	{
-		std::lock_guard<std::mutex> lock(mMutex);
+		UNREFERENCED_PARAMETER(payload);
+		return nullptr;
+	}
+
+
+	template<typename Payload>
+	bool EventCoalescing<Payload>::Key(const Payload& payload, std::uint64_t& key)
+	{
+		UNREFERENCED_PARAMETER(payload);
+		UNREFERENCED_PARAMETER(key);
+		return false;
+	}
 
+
+	template<typename Payload>
+	Event<Payload>::Event(const Payload& payload, const Vector<IEventSubscriber*>& subscribers) : IEventPublisher::IEventPublisher(), mPayload(std::allocate_shared<Payload>(PooledAllocator<Payload>(), payload))
+	{
 		for (auto& subscriber : subscribers)
 		{
 			Event<Payload>::Subscribe(*subscriber);
@@ -31,25 +59,61 @@ namespace FieaGameEngine
 
 
 	template<typename Payload>
-	void Event<Payload>::Subscribe(IEventSubscriber& eventSubscriber)
+	Event<Payload>::Event(Payload&& payload, const Vector<IEventSubscriber*>& subscribers) : IEventPublisher::IEventPublisher(), mPayload(std::allocate_shared<Payload>(PooledAllocator<Payload>(), std::move(payload)))
 	{
-		std::lock_guard<std::mutex> lock(mMutex);
+		for (auto& subscriber : subscribers)
+		{
+			Event<Payload>::Subscribe(*subscriber);
+		}
+
+	}
+
 
-		if (mSubscribers.Find(&eventSubscriber) == mSubscribers.end())
+
+
+	template<typename Payload>
+	Event<Payload>::Event(const std::shared_ptr<const Payload>& payload) : IEventPublisher::IEventPublisher(), mPayload(payload)
+	{
+		if (mPayload == nullptr)
 		{
-			mSubscribers.PushBack(&eventSubscriber);
+			throw std::exception("Payload cannot be null.");
 		}
 	}
 
 
 
 
+	template<typename Payload>
+	void Event<Payload>::Subscribe(IEventSubscriber& eventSubscriber)
+	{
+		ChangeSubscribers([&eventSubscriber](SubscriberList& subscribers)
+		{
+			if (subscribers.mSubscribers.Find(&eventSubscriber) != subscribers.mSubscribers.end())
+			{
+				return false;
+			}
+
+			subscribers.mSubscribers.PushBack(&eventSubscriber);
+			return true;
+		}, false);
+	}
+
+
+
+
 	template<typename Payload>
 	void Event<Payload>::Unsubscribe(IEventSubscriber& eventSubscriber)
 	{
-		std::lock_guard<std::mutex> lock(mMutex);
+		ChangeSubscribers([&eventSubscriber](SubscriberList& subscribers)
+		{
+			if (subscribers.mSubscribers.Find(&eventSubscriber) == subscribers.mSubscribers.end())
+			{
+				return false;
+			}
 
-		mSubscribers.Remove(&eventSubscriber);
+			subscribers.mSubscribers.Remove(&eventSubscriber);
+			return true;
+		}, true);
 	}
 
 
@@ -58,9 +122,87 @@ namespace FieaGameEngine
 	template<typename Payload>
 	void Event<Payload>::UnsubscribeAll()
 	{
-		std::lock_guard<std::mutex> lock(mMutex);
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+
+			std::atomic_store(&mSubscriberList, std::shared_ptr<const SubscriberList>(std::make_shared<SubscriberList>()));
+		}
+
+		WaitForDeliveries();
+	}
+
+
+
+
+	template<typename Payload>
+	void Event<Payload>::Subscribe(IEventSubscriber& eventSubscriber, const std::string& route)
+	{
+		ChangeSubscribers([&eventSubscriber, &route](SubscriberList& subscribers)
+		{
+			Vector<IEventSubscriber*>& routedSubscribers = subscribers.mRoutedSubscribers[route];
+			if (routedSubscribers.Find(&eventSubscriber) != routedSubscribers.end())
+			{
+				return false;
+			}
+
+			routedSubscribers.PushBack(&eventSubscriber);
+			return true;
+		}, false);
+	}
+
+
+
+
+	template<typename Payload>
+	void Event<Payload>::Unsubscribe(IEventSubscriber& eventSubscriber, const std::string& route)
+	{
+		ChangeSubscribers([&eventSubscriber, &route](SubscriberList& subscribers)
+		{
+			auto it = subscribers.mRoutedSubscribers.Find(route);
+			if ((it == subscribers.mRoutedSubscribers.end()) || ((*it).second.Find(&eventSubscriber) == (*it).second.end()))
+			{
+				return false;
+			}
+
+			(*it).second.Remove(&eventSubscriber);
+			return true;
+		}, true);
+	}
+
+
+
+
+	template<typename Payload>
+	void Event<Payload>::SubscribeBatch(IEventBatchSubscriber<Payload>& eventSubscriber)
+	{
+		ChangeSubscribers([&eventSubscriber](SubscriberList& subscribers)
+		{
+			if (subscribers.mBatchSubscribers.Find(&eventSubscriber) != subscribers.mBatchSubscribers.end())
+			{
+				return false;
+			}
+
+			subscribers.mBatchSubscribers.PushBack(&eventSubscriber);
+			return true;
+		}, false);
+	}
+
+
+
+
+	template<typename Payload>
+	void Event<Payload>::UnsubscribeBatch(IEventBatchSubscriber<Payload>& eventSubscriber)
+	{
+		ChangeSubscribers([&eventSubscriber](SubscriberList& subscribers)
+		{
+			if (subscribers.mBatchSubscribers.Find(&eventSubscriber) == subscribers.mBatchSubscribers.end())
+			{
+				return false;
+			}
 
-		mSubscribers.Clear();
+			subscribers.mBatchSubscribers.Remove(&eventSubscriber);
+			return true;
+		}, true);
 	}
 
 
@@ -68,8 +210,286 @@ namespace FieaGameEngine
 
 	template<typename Payload>
 	const Payload& Event<Payload>::Message() const
+	{
+		return *mPayload;
+	}
+
+
+
+
+	template<typename Payload>
+	const std::shared_ptr<const Payload>& Event<Payload>::SharedMessage() const
 	{
 		return mPayload;
 	}
 
+
+
+
+	template<typename Payload>
+	template<typename... Args>
+	std::shared_ptr<Event<Payload>> Event<Payload>::Emplace(Args&&... args)
+	{
+		std::shared_ptr<const Payload> payload = std::allocate_shared<Payload>(PooledAllocator<Payload>(), std::forward<Args>(args)...);
+		return std::allocate_shared<Event<Payload>>(PooledAllocator<Event<Payload>>(), payload);
+	}
+
+
+
+
+	template<typename Payload>
+	template<typename... Args>
+	std::shared_ptr<Event<Payload>> Event<Payload>::EmplaceTransient(FrameAllocator& allocator, Args&&... args)
+	{
+		std::shared_ptr<const Payload> payload = std::allocate_shared<Payload>(FrameAllocatorAdapter<Payload>(allocator), std::forward<Args>(args)...);
+		std::shared_ptr<Event<Payload>> event = std::allocate_shared<Event<Payload>>(FrameAllocatorAdapter<Event<Payload>>(allocator), payload);
+		event->mIsTransient = true;
+		return event;
+	}
+
+
+
+
+	template<typename Payload>
+	std::shared_ptr<IEventPublisher> Event<Payload>::Promote() const
+	{
+		std::shared_ptr<Event<Payload>> event = Emplace(*mPayload);
+		event->SetTime(mTimeEnqueued, mDelay);
+		return event;
+	}
+
+
+
+
+	template<typename Payload>
+	void Event<Payload>::DeliverBatch(const std::shared_ptr<IEventPublisher>* events, const std::uint32_t count, JobSystem* jobs, const std::uint32_t grainSize, const bool isOrdered)
+	{
+		if (count == 0)
+		{
+			return;
+		}
+
+		//the whole batch is delivered to the subscribers as they are when it starts
+		DeliveryScope deliveryScope;
+		std::shared_ptr<const SubscriberList> subscribers = std::atomic_load(&mSubscriberList);
+
+		//the subscribers of single events hear about each event in turn, as if it was delivered on its own
+		if ((jobs == nullptr) || (count == 1) || isOrdered)
+		{
+			for (std::uint32_t i = 0; i < count; ++i)
+			{
+				static_cast<Event*>(events[i].get())->NotifySubscribers(*subscribers, false, jobs, grainSize);
+			}
+		}
+		else
+		{
+			jobs->ParallelFor(count, 1, [events, &subscribers, jobs, grainSize](std::uint32_t begin, std::uint32_t end)
+			{
+				for (std::uint32_t i = begin; i < end; ++i)
+				{
+					static_cast<Event*>(events[i].get())->NotifySubscribers(*subscribers, false, jobs, grainSize);
+				}
+			});
+		}
+
+		const Vector<IEventBatchSubscriber<Payload>*>& batchSubscribers = subscribers->mBatchSubscribers;
+		if (batchSubscribers.IsEmpty())
+		{
+			return;
+		}
+
+		Vector<const Event*> batch(count);
+		for (std::uint32_t i = 0; i < count; ++i)
+		{
+			batch.PushBack(static_cast<const Event*>(events[i].get()));
+		}
+
+		//the coalesced batch is only built if a subscriber asks for it
+		Vector<const Event*> coalesced;
+		bool isCoalesced = false;
+
+		for (auto& batchSubscriber : batchSubscribers)
+		{
+			if (!batchSubscriber->IsCoalescing())
+			{
+				NotifyBatchSubscriber(*batchSubscriber, batch);
+				continue;
+			}
+
+			if (!isCoalesced)
+			{
+				Coalesce(batch, coalesced);
+				isCoalesced = true;
+			}
+			NotifyBatchSubscriber(*batchSubscriber, coalesced);
+		}
+	}
+
+
+
+
+	template<typename Payload>
+	void Event<Payload>::NotifySubscribers(const bool includeBatchSubscribers, JobSystem* jobs, const std::uint32_t grainSize) const
+	{
+		DeliveryScope deliveryScope;
+		std::shared_ptr<const SubscriberList> subscribers = std::atomic_load(&mSubscriberList);
+		NotifySubscribers(*subscribers, includeBatchSubscribers, jobs, grainSize);
+	}
+
+
+
+
+	template<typename Payload>
+	void Event<Payload>::NotifySubscribers(const SubscriberList& subscribers, const bool includeBatchSubscribers, JobSystem* jobs, const std::uint32_t grainSize) const
+	{
+		//the subscribers are numbered across the lists, so that each one has its own position in the delivery
+		std::uint32_t firstIndex = subscribers.mSubscribers.Size();
+		Notify(subscribers.mSubscribers, jobs, grainSize);
+
+		const std::string* route = EventRoute<Payload>::Key(*mPayload);
+		if (route != nullptr)
+		{
+			auto it = subscribers.mRoutedSubscribers.Find(*route);
+			if (it != subscribers.mRoutedSubscribers.end())
+			{
+				Notify((*it).second, jobs, grainSize, firstIndex);
+				firstIndex += (*it).second.Size();
+			}
+		}
+
+		if (includeBatchSubscribers)
+		{
+			for (std::uint32_t i = 0; i < subscribers.mBatchSubscribers.Size(); ++i)
+			{
+				NotifySubscriber(*subscribers.mBatchSubscribers[i], firstIndex + i);
+			}
+		}
+	}
+
+
+
+
+	template<typename Payload>
+	void Event<Payload>::NotifyBatchSubscriber(IEventBatchSubscriber<Payload>& subscriber, const Vector<const Event*>& events) const
+	{
+		NotifyScope notifyScope;
+		if (!EventProfiler::SampleNotify())
+		{
+			subscriber.NotifyBatch(EventBatch<Payload>(&events[0], events.Size()));
+			return;
+		}
+
+		std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+		subscriber.NotifyBatch(EventBatch<Payload>(&events[0], events.Size()));
+		EventProfiler::RecordNotify(*this, subscriber, std::chrono::high_resolution_clock::now() - start);
+	}
+
+
+
+
+	template<typename Payload>
+	template<typename Change>
+	void Event<Payload>::ChangeSubscribers(Change change, const bool waitForDeliveries)
+	{
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+
+			//the published list is only read from here on, so the copy is changed and then swapped in
+			std::shared_ptr<SubscriberList> subscribers = std::make_shared<SubscriberList>(*std::atomic_load(&mSubscriberList));
+			if (!change(*subscribers))
+			{
+				return;
+			}
+			std::atomic_store(&mSubscriberList, std::shared_ptr<const SubscriberList>(std::move(subscribers)));
+		}
+
+		if (waitForDeliveries)
+		{
+			WaitForDeliveries();
+		}
+	}
+
+
+
+
+	template<typename Payload>
+	void Event<Payload>::WaitForDeliveries()
+	{
+		if (IsNotifying())
+		{
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock(mGraceMutex);
+
+		//the deliveries that start after the flip are counted in the other counter, and read the list that was just published
+		std::uint32_t epoch = mDeliveryEpoch.load();
+		mDeliveryEpoch.store(epoch ^ 1);
+		while (mDeliveries[epoch].load() != 0)
+		{
+			std::this_thread::yield();
+		}
+	}
+
+
+
+
+	template<typename Payload>
+	Event<Payload>::DeliveryScope::DeliveryScope()
+	{
+		//a delivery that is counted in after a flip it did not see backs out and is counted in the new epoch
+		for (;;)
+		{
+			mEpoch = mDeliveryEpoch.load();
+			mDeliveries[mEpoch].fetch_add(1);
+			if (mDeliveryEpoch.load() == mEpoch)
+			{
+				break;
+			}
+			mDeliveries[mEpoch].fetch_sub(1);
+		}
+	}
+
+
+
+
+	template<typename Payload>
+	Event<Payload>::DeliveryScope::~DeliveryScope()
+	{
+		mDeliveries[mEpoch].fetch_sub(1);
+	}
+
+
+
+
+	template<typename Payload>
+	void Event<Payload>::Coalesce(const Vector<const Event*>& batch, Vector<const Event*>& coalesced)
+	{
+		//walking the batch backwards, the first event of a key that is seen is the latest one
+		HashMap<std::uint64_t, bool> keys;
+		coalesced.Reserve(batch.Size());
+
+		for (std::uint32_t i = batch.Size(); i > 0; --i)
+		{
+			const Event* event = batch[i - 1];
+
+			std::uint64_t key;
+			bool wasInserted = true;
+			if (EventCoalescing<Payload>::Key(event->Message(), key))
+			{
+				keys.Insert(std::make_pair(key, true), wasInserted);
+			}
+
+			if (wasInserted)
+			{
+				coalesced.PushBack(event);
+			}
+		}
+
+		for (std::uint32_t i = 0; i < (coalesced.Size() / 2); ++i)
+		{
+			std::swap(coalesced[i], coalesced[coalesced.Size() - 1 - i]);
+		}
+	}
+
 }
\ No newline at end of file
@@ -0,0 +1,137 @@
+#pragma once
+
+#include "IEventSubscriber.h"
+
+/**
+*	@brief	The namespace under which the game engine is implemented.
+*/
+namespace FieaGameEngine
+{
+
+	template<typename Payload>
+	class Event;	//forward declaration for the Event class
+
+	/**
+	*	@brief	The EventBatch class is a view over a contiguous array of events of one payload type,
+	*			in the order they were delivered. It does not own the events, which are only valid for
+	*			the duration of the NotifyBatch call that it is passed to.
+	*/
+	template<typename Payload>
+	class EventBatch final
+	{
+
+	public:
+
+		/**
+		*	@brief	Parameterized constructor that takes the array of events.
+		*	@param	events pointer to the first event
+		*	@param	size the number of events
+		*/
+		EventBatch(const Event<Payload>* const* events, const std::uint32_t size);
+
+		/**
+		*	@brief	Method to get the number of events in the batch.
+		*	@return	unsigned int representing the number of events
+		*/
+		std::uint32_t Size() const;
+
+		/**
+		*	@brief	Method to check whether the batch is empty.
+		*	@return	bool indicating whether the batch is empty
+		*/
+		bool IsEmpty() const;
+
+		/**
+		*	@brief	Method to get an event of the batch.
+		*	@param	index the index of the event
+		*	@return	reference to the event
+		*/
+		const Event<Payload>& operator[](const std::uint32_t index) const;
+
+		/**
+		*	@brief	Method to get the start of the array, so that the batch can be walked by a range based loop.
+		*	@return	pointer to the first event
+		*/
+		const Event<Payload>* const* begin() const;
+
+		/**
+		*	@brief	Method to get the end of the array.
+		*	@return	pointer past the last event
+		*/
+		const Event<Payload>* const* end() const;
+
+	private:
+
+		const Event<Payload>* const* mEvents;		/**<	The array of events	*/
+		std::uint32_t mSize;						/**<	The number of events	*/
+
+	};
+
+	/**
+	*	@brief	The IEventBatchSubscriber class is a subscriber that is notified of the events of one
+	*			payload type in batches, so that it can process them in one loop. The event queue hands
+	*			it all the events of its type that are due in an update at once, in the order they
+	*			expire. Events that are sent on their own arrive as a batch of one. It subscribes with
+	*			Event::SubscribeBatch.
+	*/
+	template<typename Payload>
+	class IEventBatchSubscriber : public IEventSubscriber
+	{
+
+	public:
+
+		/**
+		*	@brief	The default constructor is defaulted.
+		*/
+		IEventBatchSubscriber() = default;
+
+		/**
+		*	@brief	The copy constructor is defaulted.
+		*/
+		IEventBatchSubscriber(const IEventBatchSubscriber& other) = default;
+
+		/**
+		*	@brief	The move constructor is defaulted.
+		*/
+		IEventBatchSubscriber(IEventBatchSubscriber&& other) = default;
+
+		/**
+		*	@brief	The copy assignment operator is defaulted.
+		*/
+		IEventBatchSubscriber& operator=(const IEventBatchSubscriber& other) = default;
+
+		/**
+		*	@brief	The move assignment operator is defaulted.
+		*/
+		IEventBatchSubscriber& operator=(IEventBatchSubscriber&& other) = default;
+
+		/**
+		*	@brief	The destructor is defaulted.
+		*/
+		virtual ~IEventBatchSubscriber() = default;
+
+		/**
+		*	@brief	Method that notifies the subscriber of a single event, as a batch of one.
+		*			Overriden from the IEventSubscriber class.
+		*	@param	publisher reference to the event, which must be an Event of the payload type
+		*/
+		virtual void Notify(const IEventPublisher& publisher) override final;
+
+		/**
+		*	@brief	Method that specifies what the subscriber does with a batch of events.
+		*	@param	events the events, in the order they expire
+		*/
+		virtual void NotifyBatch(const EventBatch<Payload>& events) = 0;
+
+		/**
+		*	@brief	Method to check whether the subscriber only wants the latest event of each key, as
+		*			given by EventCoalescing. The default is to get every event.
+		*	@return	bool indicating whether the batches of this subscriber are coalesced
+		*/
+		virtual bool IsCoalescing() const;
+
+	};
+
+}
+
+#include "EventBatch.inl"
\ No newline at end of file
@@ -0,0 +1,81 @@
+#include "pch.h"
+#include "EventBatch.h"
+
+namespace FieaGameEngine
+{
+
+	template<typename Payload>
+	EventBatch<Payload>::EventBatch(const Event<Payload>* const* events, const std::uint32_t size) : mEvents(events), mSize(size)
+	{
+	}
+
+
+
+
+	template<typename Payload>
+	std::uint32_t EventBatch<Payload>::Size() const
+	{
+		return mSize;
+	}
+
+
+
+
+	template<typename Payload>
+	bool EventBatch<Payload>::IsEmpty() const
+	{
+		return (mSize == 0);
+	}
+
+
+
+
+	template<typename Payload>
+	const Event<Payload>& EventBatch<Payload>::operator[](const std::uint32_t index) const
+	{
+		if (index >= mSize)
+		{
+			throw std::exception("Array index out of bounds.");
+		}
+
+		return *mEvents[index];
+	}
+
+
+
+
+	template<typename Payload>
+	const Event<Payload>* const* EventBatch<Payload>::begin() const
+	{
+		return mEvents;
+	}
+
+
+
+
+	template<typename Payload>
+	const Event<Payload>* const* EventBatch<Payload>::end() const
+	{
+		return mEvents + mSize;
+	}
+
+
+
+
+	template<typename Payload>
+	void IEventBatchSubscriber<Payload>::Notify(const IEventPublisher& publisher)
+	{
+		const Event<Payload>* event = static_cast<const Event<Payload>*>(&publisher);
+		NotifyBatch(EventBatch<Payload>(&event, 1));
+	}
+
+
+
+
+	template<typename Payload>
+	bool IEventBatchSubscriber<Payload>::IsCoalescing() const
+	{
+		return false;
+	}
+
+}
\ No newline at end of file
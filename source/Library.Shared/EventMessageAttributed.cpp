@@ -8,7 +8,7 @@ namespace FieaGameEngine
 
 	EventMessageAttributed::EventMessageAttributed(const std::string& subType, World* world) : mSubType(subType), mWorld(world)
 	{
-		InitializeAttributes();
+		InitializePrescribedAttributes();
 	}
 
 
@@ -81,6 +81,7 @@ namespace FieaGameEngine
 	void EventMessageAttributed::SetSubType(const std::string& subType)
 	{
 		mSubType = subType;
+		MarkChanged();
 	}
 
 
@@ -105,17 +106,9 @@ namespace FieaGameEngine
 	void EventMessageAttributed::InitializeAttributes()
 	{
 		AddToPrescribedAttributes("Name");
-		AddExternalPrescribedAttribute("SubType", &mSubType, 1);
+		AddExternalPrescribedAttribute("SubType", &EventMessageAttributed::mSubType);
 		Append("this") = static_cast<RTTI*>(this);
 		AddToPrescribedAttributes("this");
 	}
 
-
-
-
-	void EventMessageAttributed::UpdatePrescribedAttributes()
-	{
-		(*this)["SubType"].SetStorage(&mSubType, 1);
-	}
-
 }
\ No newline at end of file
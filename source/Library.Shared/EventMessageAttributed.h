@@ -95,12 +95,6 @@ namespace FieaGameEngine
 		*/
 		virtual void InitializeAttributes() override;
 
-		/**
-		*	@brief	Method to update the list of prescribed attributes whenever
-		*			the list is reinitialized. Overriden from the Attributed class.
-		*/
-		virtual void UpdatePrescribedAttributes() override;
-
 	private:
 
 		std::string mSubType;		/**<	String representing the subtype	*/
@@ -108,4 +102,22 @@ namespace FieaGameEngine
 
 	};
 
+	/**
+	*	@brief	Messages are routed by their subtype, so that reactions only hear about the subtype
+	*			they react to.
+	*/
+	template<>
+	struct EventRoute<EventMessageAttributed>
+	{
+		/**
+		*	@brief	Static method to get the route of a message.
+		*	@param	payload the message
+		*	@return	pointer to the subtype of the message
+		*/
+		static const std::string* Key(const EventMessageAttributed& payload)
+		{
+			return &payload.GetSubType();
+		}
+	};
+
 }
\ No newline at end of file
@@ -0,0 +1,339 @@
+#include "pch.h"
+#include "EventProfiler.h"
+#include <typeinfo>
+#include <algorithm>
+#include <iomanip>
+#include "IEventPublisher.h"
+
+
+namespace FieaGameEngine
+{
+
+	std::atomic<bool> EventProfiler::mIsEnabled(false);
+	std::atomic<std::uint32_t> EventProfiler::mSampleInterval(1);
+	std::atomic<std::uint64_t> EventProfiler::mEnqueued(0);
+	EventProfiler::AtomicHistogram EventProfiler::mPendingDepth;
+	EventProfiler::AtomicHistogram EventProfiler::mLateness;
+	std::chrono::high_resolution_clock::time_point EventProfiler::mResetTime = std::chrono::high_resolution_clock::now();
+	HashMap<std::uint64_t, EventProfiler::Timing> EventProfiler::mPayloadTypes;
+	HashMap<std::uint64_t, EventProfiler::Timing> EventProfiler::mSubscribers;
+	std::mutex EventProfiler::mMutex;
+
+
+
+
+	double EventProfiler::Histogram::Mean() const
+	{
+		if (mCount == 0)
+		{
+			return 0.0;
+		}
+
+		return static_cast<double>(mSum) / mCount;
+	}
+
+
+
+
+	std::uint64_t EventProfiler::Histogram::Percentile(const double percentile) const
+	{
+		if (mCount == 0)
+		{
+			return 0;
+		}
+
+		std::uint64_t rank = static_cast<std::uint64_t>(percentile * mCount);
+		std::uint64_t count = 0;
+		for (std::uint32_t i = 0; i < BucketCount - 1; ++i)
+		{
+			count += mBuckets[i];
+			if (count > rank)
+			{
+				return (std::min)((std::uint64_t(1) << i) - 1, mMax);
+			}
+		}
+
+		return mMax;
+	}
+
+
+
+
+	void EventProfiler::SetEnabled(const bool isEnabled)
+	{
+		mIsEnabled.store(isEnabled, std::memory_order_relaxed);
+	}
+
+
+
+
+	bool EventProfiler::IsEnabled()
+	{
+		return mIsEnabled.load(std::memory_order_relaxed);
+	}
+
+
+
+
+	void EventProfiler::SetSampleInterval(const std::uint32_t sampleInterval)
+	{
+		if (sampleInterval == 0)
+		{
+			throw std::exception("Sample interval must be at least one.");
+		}
+
+		mSampleInterval.store(sampleInterval, std::memory_order_relaxed);
+	}
+
+
+
+
+	std::uint32_t EventProfiler::GetSampleInterval()
+	{
+		return mSampleInterval.load(std::memory_order_relaxed);
+	}
+
+
+
+
+	void EventProfiler::RecordEnqueue()
+	{
+		if (IsEnabled())
+		{
+			mEnqueued.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+
+
+
+	void EventProfiler::RecordUpdate(const std::uint32_t pendingCount)
+	{
+		if (IsEnabled())
+		{
+			Add(mPendingDepth, pendingCount);
+		}
+	}
+
+
+
+
+	void EventProfiler::RecordDelivery(const IEventPublisher& publisher, const std::chrono::high_resolution_clock::time_point& currentTime)
+	{
+		if (!IsEnabled())
+		{
+			return;
+		}
+
+		//the queue delivers on millisecond boundaries, so an event can be handed out a little before its exact expiry
+		std::chrono::high_resolution_clock::duration lateness = currentTime - (publisher.TimeEnqueued() + publisher.Delay());
+		std::int64_t microseconds = std::chrono::duration_cast<std::chrono::microseconds>(lateness).count();
+		Add(mLateness, static_cast<std::uint64_t>((std::max)(microseconds, std::int64_t(0))));
+	}
+
+
+
+
+	bool EventProfiler::SampleNotify()
+	{
+		if (!IsEnabled())
+		{
+			return false;
+		}
+
+		//each thread counts its own notifications, so that sampling does not contend on a shared counter
+		static thread_local std::uint32_t notifyCount = 0;
+		return ((++notifyCount % mSampleInterval.load(std::memory_order_relaxed)) == 0);
+	}
+
+
+
+
+	void EventProfiler::RecordNotify(const IEventPublisher& publisher, const IEventSubscriber& subscriber, const std::chrono::high_resolution_clock::duration& time)
+	{
+		std::uint64_t nanoseconds = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(time).count());
+
+		std::lock_guard<std::mutex> lock(mMutex);
+
+		HashMap<std::uint64_t, Timing>::Iterator it;
+		if (!mPayloadTypes.ContainsKey(publisher.TypeIdInstance(), it))
+		{
+			it = mPayloadTypes.Insert(std::make_pair(publisher.TypeIdInstance(), Timing{ typeid(publisher).name(), Histogram() }));
+		}
+		Add((*it).second.mNanoseconds, nanoseconds);
+
+		std::uint64_t address = reinterpret_cast<std::uintptr_t>(&subscriber);
+		if (!mSubscribers.ContainsKey(address, it))
+		{
+			std::ostringstream name;
+			name << typeid(subscriber).name() << " @ " << &subscriber;
+			it = mSubscribers.Insert(std::make_pair(address, Timing{ name.str(), Histogram() }));
+		}
+		Add((*it).second.mNanoseconds, nanoseconds);
+	}
+
+
+
+
+	EventProfiler::Statistics EventProfiler::GetStatistics()
+	{
+		Statistics statistics;
+		statistics.mEnqueued = mEnqueued.load(std::memory_order_relaxed);
+		statistics.mSampleInterval = GetSampleInterval();
+		statistics.mPendingDepth = Load(mPendingDepth);
+		statistics.mLateness = Load(mLateness);
+		statistics.mUpdates = statistics.mPendingDepth.mCount;
+
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+
+			statistics.mSeconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - mResetTime).count();
+
+			for (auto& pair : mPayloadTypes)
+			{
+				statistics.mPayloadTypes.push_back(pair.second);
+			}
+
+			for (auto& pair : mSubscribers)
+			{
+				statistics.mSubscribers.push_back(pair.second);
+			}
+		}
+
+		auto slowerFirst = [](const Timing& lhs, const Timing& rhs) { return (lhs.mNanoseconds.mSum > rhs.mNanoseconds.mSum); };
+		std::sort(statistics.mPayloadTypes.begin(), statistics.mPayloadTypes.end(), slowerFirst);
+		std::sort(statistics.mSubscribers.begin(), statistics.mSubscribers.end(), slowerFirst);
+
+		return statistics;
+	}
+
+
+
+
+	void EventProfiler::Dump(std::ostream& stream)
+	{
+		Statistics statistics = GetStatistics();
+
+		stream << "Events: " << statistics.mEnqueued << " enqueued in " << std::fixed << std::setprecision(3) << statistics.mSeconds << " s";
+		if (statistics.mSeconds > 0.0)
+		{
+			stream << " (" << std::setprecision(1) << (statistics.mEnqueued / statistics.mSeconds) << " per second)";
+		}
+		stream << ", " << statistics.mUpdates << " updates, 1 in " << statistics.mSampleInterval << " notifications timed" << std::endl;
+
+		stream << std::left << std::setw(56) << "" << std::right << std::setw(10) << "count" << std::setw(12) << "mean" << std::setw(10) << "p50" << std::setw(10) << "p99" << std::setw(10) << "max" << std::setw(14) << "total" << std::endl;
+		DumpRow(stream, "Pending depth", statistics.mPendingDepth);
+		DumpRow(stream, "Lateness (us)", statistics.mLateness);
+
+		stream << "Notify time by payload type (ns)" << std::endl;
+		for (auto& timing : statistics.mPayloadTypes)
+		{
+			DumpRow(stream, "  " + timing.mName, timing.mNanoseconds);
+		}
+
+		stream << "Notify time by subscriber (ns)" << std::endl;
+		for (auto& timing : statistics.mSubscribers)
+		{
+			DumpRow(stream, "  " + timing.mName, timing.mNanoseconds);
+		}
+	}
+
+
+
+
+	void EventProfiler::Reset()
+	{
+		mEnqueued.store(0, std::memory_order_relaxed);
+		Clear(mPendingDepth);
+		Clear(mLateness);
+
+		std::lock_guard<std::mutex> lock(mMutex);
+
+		mPayloadTypes.Clear();
+		mSubscribers.Clear();
+		mResetTime = std::chrono::high_resolution_clock::now();
+	}
+
+
+
+
+	void EventProfiler::Add(Histogram& histogram, const std::uint64_t value)
+	{
+		++histogram.mBuckets[Bucket(value)];
+		++histogram.mCount;
+		histogram.mSum += value;
+		histogram.mMax = (std::max)(histogram.mMax, value);
+	}
+
+
+
+
+	void EventProfiler::Add(AtomicHistogram& histogram, const std::uint64_t value)
+	{
+		histogram.mBuckets[Bucket(value)].fetch_add(1, std::memory_order_relaxed);
+		histogram.mCount.fetch_add(1, std::memory_order_relaxed);
+		histogram.mSum.fetch_add(value, std::memory_order_relaxed);
+
+		std::uint64_t max = histogram.mMax.load(std::memory_order_relaxed);
+		while ((value > max) && !histogram.mMax.compare_exchange_weak(max, value, std::memory_order_relaxed))
+		{
+		}
+	}
+
+
+
+
+	EventProfiler::Histogram EventProfiler::Load(const AtomicHistogram& histogram)
+	{
+		Histogram copy;
+		for (std::uint32_t i = 0; i < Histogram::BucketCount; ++i)
+		{
+			copy.mBuckets[i] = histogram.mBuckets[i].load(std::memory_order_relaxed);
+		}
+
+		copy.mCount = histogram.mCount.load(std::memory_order_relaxed);
+		copy.mSum = histogram.mSum.load(std::memory_order_relaxed);
+		copy.mMax = histogram.mMax.load(std::memory_order_relaxed);
+		return copy;
+	}
+
+
+
+
+	void EventProfiler::Clear(AtomicHistogram& histogram)
+	{
+		for (auto& bucket : histogram.mBuckets)
+		{
+			bucket.store(0, std::memory_order_relaxed);
+		}
+
+		histogram.mCount.store(0, std::memory_order_relaxed);
+		histogram.mSum.store(0, std::memory_order_relaxed);
+		histogram.mMax.store(0, std::memory_order_relaxed);
+	}
+
+
+
+
+	std::uint32_t EventProfiler::Bucket(const std::uint64_t value)
+	{
+		std::uint32_t bucket = 0;
+		for (std::uint64_t remaining = value; (remaining != 0) && (bucket < Histogram::BucketCount - 1); remaining >>= 1)
+		{
+			++bucket;
+		}
+
+		return bucket;
+	}
+
+
+
+
+	void EventProfiler::DumpRow(std::ostream& stream, const std::string& name, const Histogram& histogram)
+	{
+		stream << std::left << std::setw(56) << name.substr(0, 55) << std::right << std::setw(10) << histogram.mCount
+			<< std::setw(12) << std::setprecision(1) << histogram.Mean() << std::setw(10) << histogram.Percentile(0.5) << std::setw(10) << histogram.Percentile(0.99)
+			<< std::setw(10) << histogram.mMax << std::setw(14) << histogram.mSum << std::endl;
+	}
+
+}
\ No newline at end of file
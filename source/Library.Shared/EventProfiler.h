@@ -0,0 +1,251 @@
+#pragma once
+
+#include <chrono>
+#include <vector>
+#include "HashMap.h"
+
+/**
+*	@brief	The namespace under which the game engine is implemented.
+*/
+namespace FieaGameEngine
+{
+
+	class IEventPublisher;		//forward declaration for the IEventPublisher class
+	class IEventSubscriber;		//forward declaration for the IEventSubscriber class
+
+	/**
+	*	@brief	The EventProfiler class measures the event system: how many events are queued, how many
+	*			are pending when the queues are updated, how late they are delivered relative to when
+	*			they expired, and how long the subscribers take to be notified, by type of event and by
+	*			subscriber. It is off by default, in which case it costs a relaxed load per event. The
+	*			counters are exact, and the notifications are timed one in every sample interval, per
+	*			thread, so that it can be left on in event heavy games.
+	*/
+	class EventProfiler final
+	{
+
+	public:
+
+		/**
+		*	@brief	A histogram with a bucket per power of two, so that bucket i counts the values below
+		*			2^i that are not counted by the buckets before it, and the last bucket counts the rest.
+		*/
+		struct Histogram
+		{
+			static const std::uint32_t BucketCount = 32;		/**<	The number of buckets	*/
+
+			std::uint64_t mBuckets[BucketCount];				/**<	The number of values in each bucket	*/
+			std::uint64_t mCount;								/**<	The number of values	*/
+			std::uint64_t mSum;									/**<	The sum of the values	*/
+			std::uint64_t mMax;									/**<	The largest value	*/
+
+			/**
+			*	@brief	Method to get the mean of the values.
+			*	@return	the mean, or zero if there are none
+			*/
+			double Mean() const;
+
+			/**
+			*	@brief	Method to get an upper bound of a percentile of the values, i.e. the upper bound
+			*			of the bucket that it falls in.
+			*	@param	percentile the percentile, between zero and one
+			*	@return	the upper bound of the percentile
+			*/
+			std::uint64_t Percentile(const double percentile) const;
+		};
+
+		/**
+		*	@brief	The notification times of a type of event or of a subscriber.
+		*/
+		struct Timing
+		{
+			std::string mName;			/**<	The name of the type or subscriber	*/
+			Histogram mNanoseconds;		/**<	The sampled notification times in nanoseconds	*/
+		};
+
+		/**
+		*	@brief	A copy of everything that was measured since the last reset.
+		*/
+		struct Statistics
+		{
+			std::uint64_t mEnqueued;				/**<	The number of events that were queued	*/
+			std::uint64_t mUpdates;					/**<	The number of times a queue was updated	*/
+			double mSeconds;						/**<	The time since the last reset, in seconds	*/
+			std::uint32_t mSampleInterval;			/**<	The sample interval that the notifications were timed at	*/
+			Histogram mPendingDepth;				/**<	The number of events that were pending at each update	*/
+			Histogram mLateness;					/**<	How late each delivered event was, in microseconds	*/
+			std::vector<Timing> mPayloadTypes;		/**<	The notification times by type of event, slowest first	*/
+			std::vector<Timing> mSubscribers;		/**<	The notification times by subscriber, slowest first	*/
+		};
+
+		/**
+		*	@brief	The default constructor is deleted, since the class only has static members.
+		*/
+		EventProfiler() = delete;
+
+		/**
+		*	@brief	The copy constructor for this class is deleted.
+		*/
+		EventProfiler(const EventProfiler& other) = delete;
+
+		/**
+		*	@brief	The move constructor for this class is deleted.
+		*/
+		EventProfiler(EventProfiler&& other) = delete;
+
+		/**
+		*	@brief	The copy assignment operator is deleted.
+		*/
+		EventProfiler& operator=(const EventProfiler& other) = delete;
+
+		/**
+		*	@brief	The move assignment operator is deleted.
+		*/
+		EventProfiler& operator=(EventProfiler&& other) = delete;
+
+		/**
+		*	@brief	The destructor is deleted, since the class only has static members.
+		*/
+		~EventProfiler() = delete;
+
+		/**
+		*	@brief	Static method to turn the profiler on or off.
+		*	@param	isEnabled whether the event system is measured
+		*/
+		static void SetEnabled(const bool isEnabled);
+
+		/**
+		*	@brief	Static method to check whether the profiler is on.
+		*	@return	bool indicating whether the event system is measured
+		*/
+		static bool IsEnabled();
+
+		/**
+		*	@brief	Static method to set how often the notifications are timed.
+		*	@param	sampleInterval one in how many notifications of each thread is timed, one to time all of them
+		*/
+		static void SetSampleInterval(const std::uint32_t sampleInterval);
+
+		/**
+		*	@brief	Static method to get how often the notifications are timed.
+		*	@return	one in how many notifications of each thread is timed
+		*/
+		static std::uint32_t GetSampleInterval();
+
+		/**
+		*	@brief	Static method to count an event that is queued.
+		*/
+		static void RecordEnqueue();
+
+		/**
+		*	@brief	Static method to record the number of events that are pending when a queue is updated.
+		*	@param	pendingCount the number of pending events
+		*/
+		static void RecordUpdate(const std::uint32_t pendingCount);
+
+		/**
+		*	@brief	Static method to record how late an event is delivered.
+		*	@param	publisher the event
+		*	@param	currentTime the time at which the event is delivered
+		*/
+		static void RecordDelivery(const IEventPublisher& publisher, const std::chrono::high_resolution_clock::time_point& currentTime);
+
+		/**
+		*	@brief	Static method that decides whether a notification is timed.
+		*	@return	bool indicating whether the notification should be timed and recorded
+		*/
+		static bool SampleNotify();
+
+		/**
+		*	@brief	Static method to record how long a subscriber took to be notified of an event.
+		*	@param	publisher the event, or the first event of a batch
+		*	@param	subscriber the subscriber
+		*	@param	time the time that the notification took
+		*/
+		static void RecordNotify(const IEventPublisher& publisher, const IEventSubscriber& subscriber, const std::chrono::high_resolution_clock::duration& time);
+
+		/**
+		*	@brief	Static method to get a copy of everything that was measured since the last reset.
+		*	@return	the statistics
+		*/
+		static Statistics GetStatistics();
+
+		/**
+		*	@brief	Static method to write the statistics to a stream, as a table that can be read.
+		*	@param	stream the stream
+		*/
+		static void Dump(std::ostream& stream);
+
+		/**
+		*	@brief	Static method to clear everything that was measured.
+		*/
+		static void Reset();
+
+	private:
+
+		/**
+		*	@brief	A histogram that is added to from several threads without locking.
+		*/
+		struct AtomicHistogram
+		{
+			std::atomic<std::uint64_t> mBuckets[Histogram::BucketCount];		/**<	The number of values in each bucket	*/
+			std::atomic<std::uint64_t> mCount;									/**<	The number of values	*/
+			std::atomic<std::uint64_t> mSum;									/**<	The sum of the values	*/
+			std::atomic<std::uint64_t> mMax;									/**<	The largest value	*/
+		};
+
+		/**
+		*	@brief	Helper method that adds a value to a histogram.
+		*	@param	histogram the histogram
+		*	@param	value the value
+		*/
+		static void Add(Histogram& histogram, const std::uint64_t value);
+
+		/**
+		*	@brief	Helper method that adds a value to a histogram without locking.
+		*	@param	histogram the histogram
+		*	@param	value the value
+		*/
+		static void Add(AtomicHistogram& histogram, const std::uint64_t value);
+
+		/**
+		*	@brief	Helper method that copies a histogram that is added to without locking.
+		*	@param	histogram the histogram
+		*	@return	the copy
+		*/
+		static Histogram Load(const AtomicHistogram& histogram);
+
+		/**
+		*	@brief	Helper method that clears a histogram that is added to without locking.
+		*	@param	histogram the histogram
+		*/
+		static void Clear(AtomicHistogram& histogram);
+
+		/**
+		*	@brief	Helper method that gets the bucket of a value.
+		*	@param	value the value
+		*	@return	the index of the bucket
+		*/
+		static std::uint32_t Bucket(const std::uint64_t value);
+
+		/**
+		*	@brief	Helper method that writes a histogram as a row of a table.
+		*	@param	stream the stream
+		*	@param	name the name of the row
+		*	@param	histogram the histogram
+		*/
+		static void DumpRow(std::ostream& stream, const std::string& name, const Histogram& histogram);
+
+		static std::atomic<bool> mIsEnabled;								/**<	Whether the event system is measured	*/
+		static std::atomic<std::uint32_t> mSampleInterval;					/**<	One in how many notifications of each thread is timed	*/
+		static std::atomic<std::uint64_t> mEnqueued;						/**<	The number of events that were queued	*/
+		static AtomicHistogram mPendingDepth;								/**<	The number of events that were pending at each update	*/
+		static AtomicHistogram mLateness;									/**<	How late each delivered event was, in microseconds	*/
+		static std::chrono::high_resolution_clock::time_point mResetTime;	/**<	The time of the last reset	*/
+		static HashMap<std::uint64_t, Timing> mPayloadTypes;				/**<	The notification times by type id of event	*/
+		static HashMap<std::uint64_t, Timing> mSubscribers;					/**<	The notification times by address of subscriber	*/
+		static std::mutex mMutex;											/**<	The lock for the notification times and the reset time	*/
+
+	};
+
+}
\ No newline at end of file
@@ -1,19 +1,97 @@
 #include "pch.h"
 #include "EventQueue.h"
+#include "JobSystem.h"
+#include "WorldState.h"
+#include "EventProfiler.h"
 
 
 namespace FieaGameEngine
 {
 
+	std::atomic<std::uint64_t> EventQueue::mNextQueueId(1);
+	Vector<EventQueue*> EventQueue::mLiveQueues;
+	std::mutex EventQueue::mLiveQueuesMutex;
+
+
+
+
+	EventQueue::EventQueue() : mStagedEventCount(0), mNextSequence(0), mNextDelivery(0), mJobs(nullptr), mSubscriberGrainSize(IEventPublisher::SubscriberGrainSize), mFrameAllocator(), mIsFrameAllocatorEnabled(false), mDeliveryMode(EDeliveryMode::EBatched), mQueueId(mNextQueueId++)
+	{
+		std::lock_guard<std::mutex> lock(mLiveQueuesMutex);
+		mLiveQueues.PushBack(this);
+	}
+
+
+
+
+	EventQueue::~EventQueue()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mLiveQueuesMutex);
+			mLiveQueues.Remove(this);
+		}
+
+		//threads that still name the queue never match it again, since queue ids are not reused
+		for (std::uint32_t i = 0; i < mStagingBuffers.Size(); ++i)
+		{
+			delete mStagingBuffers[i];
+		}
+	}
+
+
+
+
 	void EventQueue::Enqueue(const std::shared_ptr<IEventPublisher>& eventPublisher, const GameTime& gameTime, std::chrono::milliseconds delay)
+	{
+		//events that are not queued by an entity come after those that are, like the commands that are recorded after the sectors are updated
+		Stage(eventPublisher, gameTime, delay, (std::numeric_limits<std::uint64_t>::max)());
+	}
+
+
+
+
+	void EventQueue::Enqueue(const std::shared_ptr<IEventPublisher>& eventPublisher, const WorldState& worldState, std::chrono::milliseconds delay)
+	{
+		Stage(eventPublisher, worldState.GetGameTime(), delay, worldState.UpdateOrder);
+	}
+
+
+
+
+	void EventQueue::Stage(const std::shared_ptr<IEventPublisher>& eventPublisher, const GameTime& gameTime, std::chrono::milliseconds delay, const std::uint64_t order)
 	{
 		eventPublisher->SetTime(gameTime.CurrentTime(), delay);
 
+		ExpiryTime expiry = std::chrono::time_point_cast<std::chrono::milliseconds>(gameTime.CurrentTime()) + delay;
+		std::uint64_t sequence = mNextSequence.fetch_add(1, std::memory_order_relaxed);
+
+		//a delayed event outlives the frame, so it cannot stay in the frame allocator
+		std::shared_ptr<IEventPublisher> queuedEvent = (eventPublisher->IsTransient() && (delay > std::chrono::milliseconds::zero())) ? eventPublisher->Promote() : eventPublisher;
+
+		//only this thread takes nodes from the buffer, and it takes the nodes that Update handed back all at once
+		StagingBuffer& buffer = GetStagingBuffer();
+		StagedEvent* stagedEvent = buffer.mFree;
+		if (stagedEvent == nullptr)
 		{
-			std::lock_guard<std::mutex> lock(mMutex);
+			stagedEvent = buffer.mReturned.exchange(nullptr, std::memory_order_acquire);
+			if (stagedEvent == nullptr)
+			{
+				stagedEvent = new StagedEvent();
+				stagedEvent->mNext = nullptr;
+			}
+		}
+
+		buffer.mFree = stagedEvent->mNext;
+		stagedEvent->mEvent = { expiry, order, sequence, std::move(queuedEvent) };
 
-			mQueue.push_back(eventPublisher);
+		//the event is counted before Update can take it, so the count never drops below the number of staged events
+		mStagedEventCount.fetch_add(1, std::memory_order_relaxed);
+		stagedEvent->mNext = buffer.mStaged.load(std::memory_order_relaxed);
+		while (!buffer.mStaged.compare_exchange_weak(stagedEvent->mNext, stagedEvent, std::memory_order_release, std::memory_order_relaxed))
+		{
 		}
+
+		EventProfiler::RecordEnqueue();
 	}
 
 
@@ -21,7 +99,8 @@ namespace FieaGameEngine
 
 	void EventQueue::Send(const std::shared_ptr<IEventPublisher>& eventToSend)
 	{
-		eventToSend->Deliver();
+		eventToSend->SetSequence(mNextDelivery.fetch_add(1, std::memory_order_relaxed));
+		eventToSend->Deliver((mDeliveryMode == EDeliveryMode::EOrdered) ? nullptr : mJobs, mSubscriberGrainSize);
 	}
 
 
@@ -29,36 +108,70 @@ namespace FieaGameEngine
 
 	void EventQueue::Update(const GameTime& gameTime)
 	{
-		std::vector<std::shared_ptr<IEventPublisher>>::iterator firstExpiredEvent;
+		ExpiryTime now = std::chrono::time_point_cast<std::chrono::milliseconds>(gameTime.CurrentTime());
 
-		auto expression = [&gameTime](std::shared_ptr<IEventPublisher> eventPublisher)
+		//only the events that are due are popped, the rest of the heap is not touched
 		{
-			return !eventPublisher->IsExpired(gameTime.CurrentTime());
-		};
-
-		firstExpiredEvent = std::partition(mQueue.begin(), mQueue.end(), expression);
+			std::lock_guard<std::mutex> lock(mMutex);
 
-		std::move(firstExpiredEvent, mQueue.end(), std::back_inserter(mExpiredEvents));
+			MergeStagedEvents(now);
+			EventProfiler::RecordUpdate(static_cast<std::uint32_t>(mQueue.size()));
 
-		mQueue.erase(firstExpiredEvent, mQueue.end());
+			while (!mQueue.empty() && (mQueue.front().mExpiry <= now))
+			{
+				std::pop_heap(mQueue.begin(), mQueue.end(), ExpiresLater);
+				EventProfiler::RecordDelivery(*mQueue.back().mEvent, gameTime.CurrentTime());
+
+				//the events come off the heap in the order of the entities that queued them, so this is the same from run to run
+				mQueue.back().mEvent->SetSequence(mNextDelivery.fetch_add(1, std::memory_order_relaxed));
+				mExpiredEvents.push_back(std::move(mQueue.back().mEvent));
+				mQueue.pop_back();
+			}
+		}
 
-		std::vector<std::future<void>> futures;
+		bool isOrdered = (mDeliveryMode != EDeliveryMode::EBatched);
+		GroupExpiredEvents(isOrdered);
 
-		for (auto& expiredEvent : mExpiredEvents)
+		if (isOrdered)
 		{
-			futures.emplace_back(std::async(std::launch::async, [expiredEvent]()
+			JobSystem* jobs = (mDeliveryMode == EDeliveryMode::EOrderedParallel) ? mJobs : nullptr;
+			for (auto& batch : mBatches)
 			{
-				expiredEvent->Deliver();
-			}));
-
+				mBatchedEvents[batch.mBegin]->DeliverBatch(&mBatchedEvents[batch.mBegin], batch.mCount, jobs, mSubscriberGrainSize, true);
+			}
 		}
-
-		for (auto& future : futures)
+		else if (mJobs == nullptr)
+		{
+			for (auto& batch : mBatches)
+			{
+				mBatchedEvents[batch.mBegin]->DeliverBatch(&mBatchedEvents[batch.mBegin], batch.mCount);
+			}
+		}
+		else
 		{
-			future.get();
+			mJobs->ParallelFor(static_cast<std::uint32_t>(mBatches.size()), 1, [this](std::uint32_t begin, std::uint32_t end)
+			{
+				for (std::uint32_t i = begin; i < end; ++i)
+				{
+					const EventBatchRange& batch = mBatches[i];
+					mBatchedEvents[batch.mBegin]->DeliverBatch(&mBatchedEvents[batch.mBegin], batch.mCount, mJobs, mSubscriberGrainSize);
+				}
+			});
 		}
 
-		mExpiredEvents.erase(mExpiredEvents.begin(), mExpiredEvents.end());
+		mBatchedEvents.clear();
+		mBatches.clear();
+
+		if (mIsFrameAllocatorEnabled)
+		{
+			//events queued by the subscribers are delivered next frame, after the allocator is reset
+			{
+				std::lock_guard<std::mutex> lock(mMutex);
+				MergeStagedEvents(ExpiryTime::min());
+			}
+
+			mFrameAllocator.Reset();
+		}
 
 	}
 
@@ -69,7 +182,7 @@ namespace FieaGameEngine
 	{
 		std::lock_guard<std::mutex> lock(mMutex);
 
-		return mQueue.empty();
+		return mQueue.empty() && (mStagedEventCount.load(std::memory_order_relaxed) == 0);
 	}
 
 
@@ -79,7 +192,307 @@ namespace FieaGameEngine
 	{
 		std::lock_guard<std::mutex> lock(mMutex);
 
-		return static_cast<std::uint32_t>(mQueue.size());
+		return static_cast<std::uint32_t>(mQueue.size()) + mStagedEventCount.load(std::memory_order_relaxed);
+	}
+
+
+
+
+	void EventQueue::SetJobSystem(JobSystem* jobs, const std::uint32_t subscriberGrainSize)
+	{
+		if (subscriberGrainSize == 0)
+		{
+			throw std::exception("Grain size must be at least one.");
+		}
+
+		mJobs = jobs;
+		mSubscriberGrainSize = subscriberGrainSize;
+	}
+
+
+
+
+	JobSystem* EventQueue::GetJobSystem() const
+	{
+		return mJobs;
+	}
+
+
+
+
+	void EventQueue::SetFrameAllocatorEnabled(const bool isEnabled)
+	{
+		mIsFrameAllocatorEnabled = isEnabled;
+	}
+
+
+
+
+	bool EventQueue::IsFrameAllocatorEnabled() const
+	{
+		return mIsFrameAllocatorEnabled;
+	}
+
+
+
+
+	FrameAllocator& EventQueue::GetFrameAllocator()
+	{
+		return mFrameAllocator;
+	}
+
+
+
+
+	void EventQueue::SetDeliveryMode(const EDeliveryMode deliveryMode)
+	{
+		mDeliveryMode = deliveryMode;
+	}
+
+
+
+
+	EventQueue::EDeliveryMode EventQueue::GetDeliveryMode() const
+	{
+		return mDeliveryMode;
+	}
+
+
+
+
+	void EventQueue::MergeStagedEvents(const ExpiryTime& dueTime)
+	{
+		std::lock_guard<std::mutex> buffersLock(mStagingBuffersMutex);
+
+		for (std::uint32_t i = 0; i < mStagingBuffers.Size(); ++i)
+		{
+			//the heap orders the events, so it does not matter that the list holds the last one queued first
+			StagingBuffer& buffer = *mStagingBuffers[i];
+			StagedEvent* stagedEvents = buffer.mStaged.exchange(nullptr, std::memory_order_acquire);
+			if (stagedEvents == nullptr)
+			{
+				continue;
+			}
+
+			std::uint32_t count = 0;
+			StagedEvent* last = nullptr;
+			for (StagedEvent* stagedEvent = stagedEvents; stagedEvent != nullptr; stagedEvent = stagedEvent->mNext)
+			{
+				QueuedEvent& queuedEvent = stagedEvent->mEvent;
+				if (queuedEvent.mEvent->IsTransient() && (queuedEvent.mExpiry > dueTime))
+				{
+					queuedEvent.mEvent = queuedEvent.mEvent->Promote();
+				}
+
+				mQueue.push_back(std::move(queuedEvent));
+				std::push_heap(mQueue.begin(), mQueue.end(), ExpiresLater);
+				++count;
+				last = stagedEvent;
+			}
+
+			mStagedEventCount.fetch_sub(count, std::memory_order_relaxed);
+
+			//the nodes are handed back to the thread in one push
+			last->mNext = buffer.mReturned.load(std::memory_order_relaxed);
+			while (!buffer.mReturned.compare_exchange_weak(last->mNext, stagedEvents, std::memory_order_release, std::memory_order_relaxed))
+			{
+			}
+		}
+	}
+
+
+
+
+	EventQueue::StagingBuffer::StagingBuffer() : mStaged(nullptr), mReturned(nullptr), mFree(nullptr), mIsInUse(false)
+	{
+	}
+
+
+
+
+	EventQueue::StagingBuffer::~StagingBuffer()
+	{
+		StagedEvent* lists[] = { mStaged.load(std::memory_order_acquire), mReturned.load(std::memory_order_acquire), mFree };
+		for (StagedEvent* stagedEvent : lists)
+		{
+			while (stagedEvent != nullptr)
+			{
+				StagedEvent* next = stagedEvent->mNext;
+				delete stagedEvent;
+				stagedEvent = next;
+			}
+		}
+	}
+
+
+
+
+	EventQueue::ThreadStagings::~ThreadStagings()
+	{
+		for (ThreadStaging& staging : mSlots)
+		{
+			ReleaseStagingBuffer(staging);
+		}
+	}
+
+
+
+
+	EventQueue::StagingBuffer& EventQueue::GetStagingBuffer()
+	{
+		static thread_local ThreadStagings threadStagings = {};
+		ThreadStaging* slots = threadStagings.mSlots;
+
+		for (std::uint32_t i = 0; i < ThreadStagingSlots; ++i)
+		{
+			if (slots[i].mQueueId == mQueueId)
+			{
+				return *slots[i].mBuffer;
+			}
+		}
+
+		std::uint32_t slot = ThreadStagingSlots;
+		for (std::uint32_t i = 0; i < ThreadStagingSlots; ++i)
+		{
+			if (slots[i].mQueueId == 0)
+			{
+				slot = i;
+				break;
+			}
+		}
+
+		if (slot == ThreadStagingSlots)
+		{
+			slot = threadStagings.mNextVictim;
+			threadStagings.mNextVictim = (threadStagings.mNextVictim + 1) % ThreadStagingSlots;
+			ReleaseStagingBuffer(slots[slot]);
+		}
+
+		StagingBuffer* buffer = nullptr;
+		{
+			std::lock_guard<std::mutex> lock(mStagingBuffersMutex);
+			for (std::uint32_t i = 0; i < mStagingBuffers.Size(); ++i)
+			{
+				if (!mStagingBuffers[i]->mIsInUse)
+				{
+					buffer = mStagingBuffers[i];
+					break;
+				}
+			}
+
+			if (buffer == nullptr)
+			{
+				buffer = new StagingBuffer();
+				mStagingBuffers.PushBack(buffer);
+			}
+
+			buffer->mIsInUse = true;
+		}
+
+		slots[slot].mQueueId = mQueueId;
+		slots[slot].mBuffer = buffer;
+
+		return *buffer;
+	}
+
+
+
+
+	void EventQueue::ReleaseStagingBuffer(ThreadStaging& staging)
+	{
+		if (staging.mBuffer != nullptr)
+		{
+			std::lock_guard<std::mutex> lock(mLiveQueuesMutex);
+			for (std::uint32_t i = 0; i < mLiveQueues.Size(); ++i)
+			{
+				EventQueue& queue = *mLiveQueues[i];
+				if (queue.mQueueId == staging.mQueueId)
+				{
+					std::lock_guard<std::mutex> buffersLock(queue.mStagingBuffersMutex);
+					staging.mBuffer->mIsInUse = false;
+					break;
+				}
+			}
+		}
+
+		staging.mQueueId = 0;
+		staging.mBuffer = nullptr;
+	}
+
+
+
+
+	void EventQueue::GroupExpiredEvents(const bool isOrdered)
+	{
+		if (isOrdered)
+		{
+			for (std::uint32_t i = 0; i < mExpiredEvents.size(); ++i)
+			{
+				std::uint64_t type = mExpiredEvents[i]->TypeIdInstance();
+				if (mBatches.empty() || (mBatches.back().mType != type))
+				{
+					mBatches.push_back({ type, i, 0 });
+				}
+				++mBatches.back().mCount;
+			}
+
+			mBatchedEvents.swap(mExpiredEvents);
+			mExpiredEvents.clear();
+			return;
+		}
+
+		//there are few types of events in a frame, so the groups are searched one by one
+		for (auto& expiredEvent : mExpiredEvents)
+		{
+			std::uint64_t type = expiredEvent->TypeIdInstance();
+
+			auto it = std::find_if(mBatches.begin(), mBatches.end(), [type](const EventBatchRange& batch) { return (batch.mType == type); });
+			if (it == mBatches.end())
+			{
+				mBatches.push_back({ type, 0, 1 });
+			}
+			else
+			{
+				++it->mCount;
+			}
+		}
+
+		std::uint32_t begin = 0;
+		for (auto& batch : mBatches)
+		{
+			batch.mBegin = begin;
+			begin += batch.mCount;
+			batch.mCount = 0;
+		}
+
+		mBatchedEvents.resize(mExpiredEvents.size());
+		for (auto& expiredEvent : mExpiredEvents)
+		{
+			std::uint64_t type = expiredEvent->TypeIdInstance();
+
+			auto it = std::find_if(mBatches.begin(), mBatches.end(), [type](const EventBatchRange& batch) { return (batch.mType == type); });
+			mBatchedEvents[it->mBegin + it->mCount++] = std::move(expiredEvent);
+		}
+
+		mExpiredEvents.clear();
+	}
+
+
+
+
+	bool EventQueue::ExpiresLater(const QueuedEvent& lhs, const QueuedEvent& rhs)
+	{
+		if (lhs.mExpiry != rhs.mExpiry)
+		{
+			return (lhs.mExpiry > rhs.mExpiry);
+		}
+
+		if (lhs.mOrder != rhs.mOrder)
+		{
+			return (lhs.mOrder > rhs.mOrder);
+		}
+
+		return (lhs.mSequence > rhs.mSequence);
 	}
 
 }
\ No newline at end of file
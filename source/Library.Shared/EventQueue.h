@@ -2,60 +2,104 @@
 
 #include "IEventPublisher.h"
 #include "GameTime.h"
+#include "FrameAllocator.h"
 
 /**
 *	@brief	The namespace under which the game engine is implemented.
 */
 namespace FieaGameEngine
 {
+
+	class WorldState;	//forward declaration for the WorldState class
+
 	/**
 	*	@brief	The Event Queue class handles delivering events and thus,
 	*			notifying the subscribers of those events. It maintains a queue
 	*			of events and discards expired events after delivering them.
+	*			The queue is a binary heap ordered by expiry time, so an update
+	*			only looks at the events that are due. Events that expire at the
+	*			same time are delivered in the order of the entities that queued
+	*			them, and then in the order they were queued.
+	*			Events may be queued from any thread. Each thread stages them on a
+	*			lock-free list of its own, which Update takes as a whole to move the
+	*			events into the heap, so threads never contend with each other.
+	*			The events that are due are grouped by type, in the order the
+	*			first event of each type expires, and each group is delivered as
+	*			a batch, so that batch subscribers get all of them in one call.
+	*			Events are delivered on the calling thread unless the queue is
+	*			given a job system, in which case the groups, their events, and the
+	*			subscribers of each event in groups, are delivered as jobs.
+	*			In the ordered delivery modes, events are delivered strictly one
+	*			after the other, so that runs are reproducible, see EDeliveryMode.
+	*			The queue may also own a frame allocator for transient events, which
+	*			is reset at the end of every update. Transient events that are
+	*			delayed, or that are queued while events are delivered, are promoted
+	*			to pooled storage, so only events delivered within the frame stay in it.
 	*/
 	class EventQueue
 	{
 	public:
 
 		/**
-		*	@brief	The default constructor has no special functionality, and hence,
-		*			is defaulted.
+		*	@brief	The ways the queue delivers the events that are due.
+		*/
+		enum class EDeliveryMode
+		{
+			EBatched,			/**<	Events are grouped by type and delivered in batches, as jobs if there is a job system. The default.	*/
+			EOrdered,			/**<	Events are delivered one after the other, by expiry, then by the entity that queued them, then by the order they were queued, and the subscribers of each event are notified on the calling thread in the order they subscribed. Runs of events of the same type still go to batch subscribers together.	*/
+			EOrderedParallel	/**<	Events are delivered in the same order as EOrdered, but the subscribers of each event are notified in groups on the job system, each event being delivered to all of them before the next one.	*/
+		};
+
+		/**
+		*	@brief	The default constructor creates a queue that delivers events on the calling thread.
 		*/
-		EventQueue() = default;
+		EventQueue();
 
 		/**
-		*	@brief	The copy constructor is defaulted.
+		*	@brief	The copy constructor is deleted.
 		*/
-		EventQueue(const EventQueue& other) = default;
+		EventQueue(const EventQueue& other) = delete;
 
 		/**
-		*	@brief	The move constructor is defaulted.
+		*	@brief	The move constructor is deleted.
 		*/
-		EventQueue(EventQueue&& other) = default;
+		EventQueue(EventQueue&& other) = delete;
 
 		/**
-		*	@brief	The copy assignment operator is defaulted.
+		*	@brief	The copy assignment operator is deleted.
 		*/
-		EventQueue& operator=(const EventQueue& other) = default;
+		EventQueue& operator=(const EventQueue& other) = delete;
 
 		/**
-		*	@brief	The move assignment operator is defaulted.
+		*	@brief	The move assignment operator is deleted.
 		*/
-		EventQueue& operator=(EventQueue&& other) = default;
+		EventQueue& operator=(EventQueue&& other) = delete;
 
 		/**
-		*	@brief	The destructor is defaulted.
+		*	@brief	The destructor drops the events that are still staged, along with the staging buffers.
 		*/
-		~EventQueue() = default;
+		~EventQueue();
 
 		/**
-		*	@brief	Method to add an event to the queue.
+		*	@brief	Method to add an event to the queue. It takes no lock once the calling thread has a
+		*			staging buffer for the queue, and may be called from any thread.
 		*	@param	eventPublisher the event to be added
 		*	@param	gameTime the time at which the event is enqueued
 		*	@param	delay the time after being enqueued that the event will expire
 		*/
 		void Enqueue(const std::shared_ptr<IEventPublisher>& eventPublisher, const GameTime& gameTime, std::chrono::milliseconds delay = std::chrono::duration_values<std::chrono::milliseconds>::zero());
 
+		/**
+		*	@brief	Method to add an event to the queue on behalf of the entity that is being updated, so
+		*			that the events that expire together are delivered in the order of the entities that
+		*			queued them, however the entities were spread over the threads. It takes no lock once
+		*			the calling thread has a staging buffer for the queue, and may be called from any thread.
+		*	@param	eventPublisher the event to be added
+		*	@param	worldState the world state of the update that queues the event
+		*	@param	delay the time after being enqueued that the event will expire
+		*/
+		void Enqueue(const std::shared_ptr<IEventPublisher>& eventPublisher, const WorldState& worldState, std::chrono::milliseconds delay = std::chrono::duration_values<std::chrono::milliseconds>::zero());
+
 		/**
 		*	@brief	Method to immediately send an event irrespective of its expiry status
 		*	@param	eventToSend reference to the event to be sent
@@ -81,14 +125,213 @@ namespace FieaGameEngine
 		*/
 		std::uint32_t Size() const;
 
+		/**
+		*	@brief	Method to set the job system that events are delivered on.
+		*	@param	jobs the job system, or nullptr to deliver events on the calling thread, which is the default
+		*	@param	subscriberGrainSize the largest number of subscribers of an event that are notified by one job
+		*/
+		void SetJobSystem(JobSystem* jobs, const std::uint32_t subscriberGrainSize = IEventPublisher::SubscriberGrainSize);
+
+		/**
+		*	@brief	Method to get the job system that events are delivered on.
+		*	@return	pointer to the job system, or nullptr if events are delivered on the calling thread
+		*/
+		JobSystem* GetJobSystem() const;
+
+		/**
+		*	@brief	Method to set how the events that are due are delivered. Events that are queued by
+		*			several threads outside of an update, with the game time alone, are only ordered
+		*			among themselves by the time they were queued.
+		*	@param	deliveryMode the delivery mode
+		*/
+		void SetDeliveryMode(const EDeliveryMode deliveryMode);
+
+		/**
+		*	@brief	Method to get how the events that are due are delivered.
+		*	@return	the delivery mode
+		*/
+		EDeliveryMode GetDeliveryMode() const;
+
+		/**
+		*	@brief	Method to turn the frame allocator on or off. It is off by default. Transient events
+		*			must not be created or queued while the queue is updated, since Update resets the
+		*			allocator when it is done.
+		*	@param	isEnabled whether transient events should be allocated from the frame allocator
+		*/
+		void SetFrameAllocatorEnabled(const bool isEnabled);
+
+		/**
+		*	@brief	Method to check whether the frame allocator is on.
+		*	@return	bool that indicates whether transient events should be allocated from the frame allocator
+		*/
+		bool IsFrameAllocatorEnabled() const;
+
+		/**
+		*	@brief	Method to get the frame allocator that transient events are allocated from, e.g.
+		*			with Event::EmplaceTransient, and whose statistics count the allocations of a frame.
+		*	@return	reference to the frame allocator
+		*/
+		FrameAllocator& GetFrameAllocator();
+
 	private:
 
-		mutable std::mutex mMutex;											/**<	mutex for the event queue	*/
+		typedef std::chrono::time_point<std::chrono::high_resolution_clock, std::chrono::milliseconds> ExpiryTime;	/**<	the expiry time of an event, at the resolution of the delays	*/
+
+		/**
+		*	@brief	An event in the queue, with the time at which it expires.
+		*/
+		struct QueuedEvent
+		{
+			ExpiryTime mExpiry;									/**<	the time at which the event expires	*/
+			std::uint64_t mOrder;								/**<	the update order of the entity that queued the event	*/
+			std::uint64_t mSequence;							/**<	the order in which the event was queued	*/
+			std::shared_ptr<IEventPublisher> mEvent;			/**<	the event	*/
+		};
+
+		/**
+		*	@brief	Helper method that orders the heap, so that the event that expires first, and was
+		*			queued first by the first entity among those, is at the front.
+		*	@param	lhs the first event
+		*	@param	rhs the second event
+		*	@return	bool indicating whether lhs expires after rhs
+		*/
+		static bool ExpiresLater(const QueuedEvent& lhs, const QueuedEvent& rhs);
+
+		/**
+		*	@brief	An event in a staging buffer, linked to the next one in its list.
+		*/
+		struct StagedEvent
+		{
+			QueuedEvent mEvent;						/**<	the staged event	*/
+			StagedEvent* mNext;						/**<	the next node in the list	*/
+		};
+
+		/**
+		*	@brief	The events that a thread queued and that are not in the heap yet. The thread pushes its
+		*			events onto a lock-free list, which Update takes as a whole, and Update hands the nodes
+		*			back on a second list, which the thread also takes as a whole. Each list is only ever
+		*			emptied at once, by the one side that reads it, so neither side waits for the other.
+		*/
+		struct StagingBuffer
+		{
+			StagingBuffer();
+			~StagingBuffer();
+
+			std::atomic<StagedEvent*> mStaged;		/**<	the staged events, the last one queued first	*/
+			std::atomic<StagedEvent*> mReturned;	/**<	the nodes that Update handed back after taking their events	*/
+			StagedEvent* mFree;						/**<	the nodes that the staging thread took back and has not reused yet	*/
+			bool mIsInUse;							/**<	whether a live thread stages into the buffer	*/
+		};
+
+		/**
+		*	@brief	The staging buffer of one queue that a thread uses.
+		*/
+		struct ThreadStaging
+		{
+			std::uint64_t mQueueId;			/**<	the id of the queue that the buffer belongs to	*/
+			StagingBuffer* mBuffer;			/**<	the buffer	*/
+		};
+
+		static const std::uint32_t ThreadStagingSlots = 4;		/**<	the number of queues a thread keeps a staging buffer for	*/
+
+		/**
+		*	@brief	The staging buffers of a thread. When the thread exits, the buffers are handed back
+		*			to the queues that are still alive, for other threads to reuse.
+		*/
+		struct ThreadStagings
+		{
+			~ThreadStagings();
 
-		std::vector<std::shared_ptr<IEventPublisher>> mQueue;				/**<	vector of event publishers that represents the event queue.	*/
+			ThreadStaging mSlots[ThreadStagingSlots];		/**<	the buffers, one for each queue the thread uses	*/
+			std::uint32_t mNextVictim;						/**<	the slot that is claimed next when all of them are in use	*/
+		};
+
+		/**
+		*	@brief	Helper method to get the staging buffer of the calling thread for this queue, taking
+		*			one that no live thread uses, or a new one, if it has none yet.
+		*	@return	reference to the staging buffer
+		*/
+		StagingBuffer& GetStagingBuffer();
+
+		/**
+		*	@brief	Helper method to hand a staging buffer back to its queue, if the queue is still alive,
+		*			and to empty the slot. The events that it holds are still delivered.
+		*	@param	staging the slot of the buffer to be released
+		*/
+		static void ReleaseStagingBuffer(ThreadStaging& staging);
+
+		/**
+		*	@brief	Helper method that moves the staged events into the heap. It must be called with the
+		*			lock of the heap held.
+		*	@param	dueTime the time up to which transient events are delivered in this frame, those that
+		*			expire later are promoted
+		*/
+		void MergeStagedEvents(const ExpiryTime& dueTime);
+
+		/**
+		*	@brief	A group of expired events of the same type.
+		*/
+		struct EventBatchRange
+		{
+			std::uint64_t mType;		/**<	the type id of the events	*/
+			std::uint32_t mBegin;		/**<	the index of the first event of the group in the batched events	*/
+			std::uint32_t mCount;		/**<	the number of events in the group	*/
+		};
+
+		/**
+		*	@brief	Helper method that adds an event to the staged events.
+		*	@param	eventPublisher the event to be added
+		*	@param	gameTime the time at which the event is enqueued
+		*	@param	delay the time after being enqueued that the event will expire
+		*	@param	order the update order of the entity that queues the event
+		*/
+		void Stage(const std::shared_ptr<IEventPublisher>& eventPublisher, const GameTime& gameTime, std::chrono::milliseconds delay, const std::uint64_t order);
+
+		/**
+		*	@brief	Helper method that moves the expired events into the batched events, grouped by type.
+		*	@param	isOrdered whether the events keep their order, in which case only neighbouring
+		*			events of the same type are grouped
+		*/
+		void GroupExpiredEvents(const bool isOrdered);
+
+		mutable std::mutex mMutex;											/**<	mutex for the heap, which is only taken by the thread that updates the queue and by queries	*/
+
+		std::vector<QueuedEvent> mQueue;									/**<	binary heap of the queued events, the next event to expire at the front	*/
+
+		Vector<StagingBuffer*> mStagingBuffers;								/**<	the staging buffers of the threads, which are reused as threads come and go	*/
+
+		std::mutex mStagingBuffersMutex;									/**<	mutex for the list of staging buffers	*/
+
+		std::atomic<std::uint32_t> mStagedEventCount;						/**<	the number of staged events	*/
+
+		std::atomic<std::uint64_t> mNextSequence;							/**<	the sequence of the next event that is queued	*/
+
+		std::atomic<std::uint64_t> mNextDelivery;							/**<	the position of the next event that is delivered, in the order of the heap	*/
 
 		std::vector<std::shared_ptr<IEventPublisher>> mExpiredEvents;		/**<	vector of expired events that need to be delivered	*/
 
+		std::vector<std::shared_ptr<IEventPublisher>> mBatchedEvents;		/**<	the expired events, grouped by type	*/
+
+		std::vector<EventBatchRange> mBatches;								/**<	the groups of the batched events	*/
+
+		JobSystem* mJobs;													/**<	the job system that events are delivered on, if any	*/
+
+		std::uint32_t mSubscriberGrainSize;									/**<	the largest number of subscribers of an event that are notified by one job	*/
+
+		FrameAllocator mFrameAllocator;										/**<	the allocator of the transient events of a frame	*/
+
+		bool mIsFrameAllocatorEnabled;										/**<	whether transient events are allocated from the frame allocator	*/
+
+		EDeliveryMode mDeliveryMode;										/**<	how the events that are due are delivered	*/
+
+		std::uint64_t mQueueId;												/**<	the id of the queue, so that thread slots never mistake a new queue for a destroyed one	*/
+
+		static std::atomic<std::uint64_t> mNextQueueId;						/**<	the id of the next queue	*/
+
+		static Vector<EventQueue*> mLiveQueues;								/**<	the queues that are alive, which threads hand their staging buffers back to	*/
+
+		static std::mutex mLiveQueuesMutex;									/**<	mutex for the list of live queues	*/
+
 	};
 
 }
\ No newline at end of file
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "HashMap.h"
+#include "Vector.h"
+#include "ObjectPool.h"
 
 /**
 *	@brief	The namespace under which the game engine is implemented.
@@ -11,7 +13,10 @@ namespace FieaGameEngine
 	*	@brief	The factory class is a templated class that
 	*			serves as the asbtract factory suitable for use
 	*			with any interface class that has a default
-	*			constructor.
+	*			constructor. Products are Scopes, and the concrete
+	*			factories place them in a pool of their type, so
+	*			deleting a product recycles its memory for the
+	*			next one.
 	*/
 	template<typename AbstractProductType>
 	class Factory
@@ -67,6 +72,39 @@ namespace FieaGameEngine
 		*/
 		static AbstractProductType* Create(const std::string& concreteFactoryName);
 
+		/**
+		*	@brief	Static method to create a product from a concrete factory, placing it in memory that
+		*			is obtained from the given allocator instead of the pool of the factory. The product
+		*			remembers its allocator, so it is deleted like any other product.
+		*	@param	concreteFactoryName name of the concrete factory
+		*	@param	allocator the allocator that provides the memory of the product
+		*	@return	pointer to the product
+		*/
+		static AbstractProductType* Create(const std::string& concreteFactoryName, IAllocator& allocator);
+
+		/**
+		*	@brief	Static method to get the counters of the pool of a concrete factory, e.g. to see how
+		*			often the memory of destroyed products is reused.
+		*	@param	concreteFactoryName name of the concrete factory
+		*	@return	a snapshot of the counters of the pool
+		*/
+		static ObjectPool::Statistics GetPoolStatistics(const std::string& concreteFactoryName);
+
+		/**
+		*	@brief	Static method to freeze the registry once all the concrete factories have been
+		*			added, usually at the end of startup. The factories are then looked up in a table
+		*			that is sorted by the hashes of their class names, so that a lookup hashes the name
+		*			once and does a binary search. Adding or removing a factory thaws the registry, and
+		*			it has to be frozen again to get the faster lookups back.
+		*/
+		static void Freeze();
+
+		/**
+		*	@brief	Static method to check whether the registry is currently frozen.
+		*	@return	bool indicating whether the registry is frozen
+		*/
+		static bool IsFrozen();
+
 		/**
 		*	@brief	Method to get the first concrete factory in the list of factories
 		*	@return	An iterator corresponding to the beginning of the hashmap
@@ -101,6 +139,22 @@ namespace FieaGameEngine
 		*/
 		virtual AbstractProductType* Create() = 0;
 
+		/**
+		*	@brief	This is a non-static method that returns a concrete product placed in memory from
+		*			the given allocator. This method must always be overriden in the derived concrete
+		*			factory classes.
+		*	@param	allocator the allocator that provides the memory of the product
+		*	@return	pointer to the created abstract product type
+		*/
+		virtual AbstractProductType* Create(IAllocator& allocator) = 0;
+
+		/**
+		*	@brief	Non-static method that returns the pool the concrete factory places its products in.
+		*			This method must always be overriden in the derived concrete factory classes.
+		*	@return	reference to the pool of the products
+		*/
+		virtual ObjectPool& Pool() const = 0;
+
 		/**
 		*	@brief	Non-static method that returns the name of the product that the concrete
 		*			factory instantiates
@@ -110,7 +164,26 @@ namespace FieaGameEngine
 
 	private:
 
+		/**
+		*	@brief	An entry of the frozen registry.
+		*/
+		struct FrozenEntry
+		{
+			size_t mHash;									/**<	The hash of the class name	*/
+			std::string mClassName;							/**<	The class name of the products of the factory	*/
+			Factory<AbstractProductType>* mFactory;			/**<	The concrete factory	*/
+		};
+
+		/**
+		*	@brief	Helper method to look a factory up in the frozen registry.
+		*	@param	concreteFactoryName the name of the concrete factory
+		*	@return	pointer to the concrete factory if it was found, nullptr otherwise
+		*/
+		static Factory* FindFrozen(const std::string& concreteFactoryName);
+
 		static HashMap<std::string, Factory<AbstractProductType>*> ConcreteFactories;	/**<	Container for all the concrete factories.	*/
+		static Vector<FrozenEntry> FrozenFactories;			/**<	The frozen registry, sorted by the hashes of the class names.	*/
+		static bool Frozen;									/**<	Whether the registry is currently frozen.	*/
 
 	};
 
@@ -134,7 +207,24 @@ namespace FieaGameEngine
 																										\
 		ConcreteProductType* Create() override															\
 		{																								\
-			return new ConcreteProductType();															\
+			return new (ProductPool()) ConcreteProductType();											\
+		}																								\
+																										\
+		ConcreteProductType* Create(FieaGameEngine::IAllocator& allocator) override						\
+		{																								\
+			return new (allocator) ConcreteProductType();												\
+		}																								\
+																										\
+		FieaGameEngine::ObjectPool& Pool() const override												\
+		{																								\
+			return ProductPool();																		\
+		}																								\
+																										\
+		static FieaGameEngine::ObjectPool& ProductPool()												\
+		{																								\
+			/*the pool is never destroyed, so products may outlive the factory*/						\
+			static FieaGameEngine::ObjectPool* sPool = new FieaGameEngine::ObjectPool();				\
+			return *sPool;																				\
 		}																								\
 																										\
 		const std::string ClassName() const override													\
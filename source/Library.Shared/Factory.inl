@@ -7,12 +7,23 @@ namespace FieaGameEngine
 	template<typename AbstractProductType>
 	HashMap<std::string, Factory<AbstractProductType>*> Factory<AbstractProductType>::ConcreteFactories(20);
 
+	template<typename AbstractProductType>
+	Vector<typename Factory<AbstractProductType>::FrozenEntry> Factory<AbstractProductType>::FrozenFactories;
+
+	template<typename AbstractProductType>
+	bool Factory<AbstractProductType>::Frozen = false;
+
 
 
 
 	template<typename AbstractProductType>
 	Factory<AbstractProductType>* Factory<AbstractProductType>::Find(const std::string& concreteFactoryName)
 	{
+		if (Frozen)
+		{
+			return FindFrozen(concreteFactoryName);
+		}
+
 		auto it = ConcreteFactories.Find(concreteFactoryName);
 
 		if (it == ConcreteFactories.end())
@@ -29,12 +40,122 @@ namespace FieaGameEngine
 	template<typename AbstractProductType>
 	AbstractProductType* Factory<AbstractProductType>::Create(const std::string& concreteFactoryName)
 	{
+		if (Frozen)
+		{
+			Factory* concreteFactory = FindFrozen(concreteFactoryName);
+			if (concreteFactory == nullptr)
+			{
+				throw std::exception("Invalid key.");
+			}
+			return concreteFactory->Create();
+		}
+
 		return ConcreteFactories.At(concreteFactoryName)->Create();
 	}
 
 
 
 
+	template<typename AbstractProductType>
+	AbstractProductType* Factory<AbstractProductType>::Create(const std::string& concreteFactoryName, IAllocator& allocator)
+	{
+		Factory* concreteFactory = Find(concreteFactoryName);
+		if (concreteFactory == nullptr)
+		{
+			throw std::exception("Invalid key.");
+		}
+
+		return concreteFactory->Create(allocator);
+	}
+
+
+
+
+	template<typename AbstractProductType>
+	ObjectPool::Statistics Factory<AbstractProductType>::GetPoolStatistics(const std::string& concreteFactoryName)
+	{
+		Factory* concreteFactory = Find(concreteFactoryName);
+		if (concreteFactory == nullptr)
+		{
+			throw std::exception("Invalid key.");
+		}
+
+		return concreteFactory->Pool().GetStatistics();
+	}
+
+
+
+
+	template<typename AbstractProductType>
+	void Factory<AbstractProductType>::Freeze()
+	{
+		FrozenFactories.Clear();
+		FrozenFactories.Reserve(ConcreteFactories.Size());
+
+		//the registry is small, so the entries are kept sorted by insertion as they are added
+		for (auto& concreteFactory : ConcreteFactories)
+		{
+			FrozenEntry entry;
+			entry.mHash = FieaGameEngine::Hash(concreteFactory.first);
+			entry.mClassName = concreteFactory.first;
+			entry.mFactory = concreteFactory.second;
+			FrozenFactories.PushBack(entry);
+
+			for (std::uint32_t i = FrozenFactories.Size() - 1; (i > 0) && (FrozenFactories[i - 1].mHash > FrozenFactories[i].mHash); --i)
+			{
+				std::swap(FrozenFactories[i - 1], FrozenFactories[i]);
+			}
+		}
+
+		Frozen = true;
+	}
+
+
+
+
+	template<typename AbstractProductType>
+	bool Factory<AbstractProductType>::IsFrozen()
+	{
+		return Frozen;
+	}
+
+
+
+
+	template<typename AbstractProductType>
+	Factory<AbstractProductType>* Factory<AbstractProductType>::FindFrozen(const std::string& concreteFactoryName)
+	{
+		size_t hash = FieaGameEngine::Hash(concreteFactoryName);
+
+		std::uint32_t first = 0;
+		std::uint32_t last = FrozenFactories.Size();
+		while (first < last)
+		{
+			std::uint32_t middle = first + ((last - first) / 2);
+			if (FrozenFactories[middle].mHash < hash)
+			{
+				first = middle + 1;
+			}
+			else
+			{
+				last = middle;
+			}
+		}
+
+		for (std::uint32_t i = first; (i < FrozenFactories.Size()) && (FrozenFactories[i].mHash == hash); ++i)
+		{
+			if (FrozenFactories[i].mClassName == concreteFactoryName)
+			{
+				return FrozenFactories[i].mFactory;
+			}
+		}
+
+		return nullptr;
+	}
+
+
+
+
 	template<typename AbstractProductType>
 	typename HashMap<std::string, Factory<AbstractProductType>*>::Iterator Factory<AbstractProductType>::begin()
 	{
@@ -56,6 +177,7 @@ namespace FieaGameEngine
 	template<typename AbstractProductType>
 	void Factory<AbstractProductType>::Add(Factory<AbstractProductType>& concreteFactory)
 	{
+		Frozen = false;
 		ConcreteFactories.Insert(std::make_pair(concreteFactory.ClassName(), &concreteFactory));
 	}
 
@@ -65,6 +187,7 @@ namespace FieaGameEngine
 	template<typename AbstractProductType>
 	void Factory<AbstractProductType>::Remove(const Factory<AbstractProductType>& concreteFactory)
 	{
+		Frozen = false;
 		ConcreteFactories.Remove(concreteFactory.ClassName());
 	}
 
@@ -0,0 +1,177 @@
+#include "pch.h"
+#include "FrameAllocator.h"
+
+
+namespace FieaGameEngine
+{
+
+	FrameAllocator::FrameAllocator(const size_t chunkSize) : mChunkSize(chunkSize), mChunks(), mCurrentChunk(nullptr), mAllocationCount(0), mByteCount(0), mLiveAllocationCount(0), mLastFrameStatistics()
+	{
+		if (chunkSize == 0)
+		{
+			throw std::exception("Chunk size must be greater than zero.");
+		}
+
+		mChunks.PushBack(CreateChunk(chunkSize));
+		mCurrentChunk = mChunks.Back();
+	}
+
+
+
+
+	FrameAllocator::~FrameAllocator()
+	{
+		for (std::uint32_t i = 0; i < mChunks.Size(); ++i)
+		{
+			DestroyChunk(mChunks[i]);
+		}
+	}
+
+
+
+
+	void* FrameAllocator::Allocate(const size_t size, const size_t alignment)
+	{
+		Chunk* chunk = mCurrentChunk.load(std::memory_order_acquire);
+		void* memory = AllocateFrom(*chunk, size, alignment);
+
+		while (memory == nullptr)
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+
+			//another thread may have added a chunk while this one was waiting for the lock
+			if (mCurrentChunk.load(std::memory_order_relaxed) == chunk)
+			{
+				mChunks.PushBack(CreateChunk((std::max)(mChunkSize, size + alignment)));
+				mCurrentChunk.store(mChunks.Back(), std::memory_order_release);
+			}
+
+			chunk = mCurrentChunk.load(std::memory_order_relaxed);
+			memory = AllocateFrom(*chunk, size, alignment);
+		}
+
+		mAllocationCount.fetch_add(1, std::memory_order_relaxed);
+		mByteCount.fetch_add(size, std::memory_order_relaxed);
+		mLiveAllocationCount.fetch_add(1, std::memory_order_relaxed);
+		return memory;
+	}
+
+
+
+
+	void FrameAllocator::Deallocate(void* memory)
+	{
+		if (memory != nullptr)
+		{
+			mLiveAllocationCount.fetch_sub(1, std::memory_order_release);
+		}
+	}
+
+
+
+
+	bool FrameAllocator::Reset()
+	{
+		if (mLiveAllocationCount.load(std::memory_order_acquire) != 0)
+		{
+			return false;
+		}
+
+		mLastFrameStatistics = GetStatistics();
+
+		//a frame that spilled into several chunks gets a single chunk that fits it from now on
+		if (mChunks.Size() > 1)
+		{
+			size_t size = 0;
+			for (std::uint32_t i = 0; i < mChunks.Size(); ++i)
+			{
+				size += mChunks[i]->mSize;
+				DestroyChunk(mChunks[i]);
+			}
+
+			mChunks.Clear();
+			mChunkSize = size;
+			mChunks.PushBack(CreateChunk(size));
+		}
+
+		mChunks.Back()->mOffset.store(0, std::memory_order_relaxed);
+		mCurrentChunk.store(mChunks.Back(), std::memory_order_release);
+		mAllocationCount.store(0, std::memory_order_relaxed);
+		mByteCount.store(0, std::memory_order_relaxed);
+		return true;
+	}
+
+
+
+
+	FrameAllocator::Statistics FrameAllocator::GetStatistics() const
+	{
+		Statistics statistics;
+		statistics.mAllocations = mAllocationCount.load(std::memory_order_relaxed);
+		statistics.mBytes = mByteCount.load(std::memory_order_relaxed);
+		statistics.mChunks = mChunks.Size();
+		return statistics;
+	}
+
+
+
+
+	const FrameAllocator::Statistics& FrameAllocator::GetLastFrameStatistics() const
+	{
+		return mLastFrameStatistics;
+	}
+
+
+
+
+	std::uint32_t FrameAllocator::LiveAllocationCount() const
+	{
+		return mLiveAllocationCount.load(std::memory_order_relaxed);
+	}
+
+
+
+
+	void* FrameAllocator::AllocateFrom(Chunk& chunk, const size_t size, const size_t alignment)
+	{
+		std::uintptr_t base = reinterpret_cast<std::uintptr_t>(chunk.mData);
+		size_t offset = chunk.mOffset.load(std::memory_order_relaxed);
+
+		for (;;)
+		{
+			size_t alignedOffset = ((base + offset + alignment - 1) & ~(static_cast<std::uintptr_t>(alignment) - 1)) - base;
+			size_t end = alignedOffset + size;
+			if (end > chunk.mSize)
+			{
+				return nullptr;
+			}
+
+			if (chunk.mOffset.compare_exchange_weak(offset, end, std::memory_order_relaxed))
+			{
+				return chunk.mData + alignedOffset;
+			}
+		}
+	}
+
+
+
+
+	FrameAllocator::Chunk* FrameAllocator::CreateChunk(const size_t size)
+	{
+		Chunk* chunk = new Chunk();
+		chunk->mData = static_cast<char*>(::operator new(size));
+		chunk->mSize = size;
+		chunk->mOffset.store(0, std::memory_order_relaxed);
+		return chunk;
+	}
+
+
+
+
+	void FrameAllocator::DestroyChunk(Chunk* chunk)
+	{
+		::operator delete(chunk->mData);
+		delete chunk;
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,221 @@
+#pragma once
+
+#include <mutex>
+#include <atomic>
+#include "Vector.h"
+#include "IAllocator.h"
+
+/**
+*	@brief	The namespace under which the game engine is implemented.
+*/
+namespace FieaGameEngine
+{
+	/**
+	*	@brief	The FrameAllocator class is a linear allocator for objects that only live for one
+	*			frame, such as immediate events. Allocations bump an offset into a chunk, which takes
+	*			no lock unless the chunk is full, and deallocations only count the blocks that are
+	*			still alive. Everything is released at once by Reset at the end of the frame, and the
+	*			chunks are kept for the next frame, merged into one that fits the busiest frame so far.
+	*/
+	class FrameAllocator final : public IAllocator
+	{
+
+	public:
+
+		/**
+		*	@brief	The counters of a frame, used to verify what the frame allocated.
+		*/
+		struct Statistics
+		{
+			std::uint64_t mAllocations;		/**<	The number of blocks that were handed out	*/
+			std::uint64_t mBytes;			/**<	The number of bytes that were handed out, including padding	*/
+			std::uint32_t mChunks;			/**<	The number of chunks that were in use	*/
+		};
+
+		/**
+		*	@brief	Parameterized constructor for the allocator.
+		*	@param	chunkSize the size in bytes of the first chunk, and of every chunk that is added
+		*			during a frame unless an allocation needs a bigger one
+		*/
+		explicit FrameAllocator(const size_t chunkSize = DefaultChunkSize);
+
+		/**
+		*	@brief	The copy constructor is deleted.
+		*/
+		FrameAllocator(const FrameAllocator& other) = delete;
+
+		/**
+		*	@brief	The move constructor is deleted.
+		*/
+		FrameAllocator(FrameAllocator&& other) = delete;
+
+		/**
+		*	@brief	The copy assignment operator is deleted.
+		*/
+		FrameAllocator& operator=(const FrameAllocator& other) = delete;
+
+		/**
+		*	@brief	The move assignment operator is deleted.
+		*/
+		FrameAllocator& operator=(FrameAllocator&& other) = delete;
+
+		/**
+		*	@brief	The destructor frees the chunks.
+		*/
+		~FrameAllocator();
+
+		/**
+		*	@brief	Method to allocate a block of memory that lives until the end of the frame.
+		*			Overriden from the IAllocator class.
+		*	@param	size the size of the block in bytes
+		*	@param	alignment the alignment that the block must have
+		*	@return	pointer to the allocated block
+		*/
+		virtual void* Allocate(const size_t size, const size_t alignment) override;
+
+		/**
+		*	@brief	Method to give back a block. The memory is only reclaimed by Reset.
+		*			Overriden from the IAllocator class.
+		*	@param	memory pointer to the block
+		*/
+		virtual void Deallocate(void* memory) override;
+
+		/**
+		*	@brief	Method to release everything that was allocated during the frame. It must not run
+		*			concurrently with an allocation. Nothing is released while blocks are still alive,
+		*			in which case the frame carries on into the next one.
+		*	@return	bool indicating whether the memory was released
+		*/
+		bool Reset();
+
+		/**
+		*	@brief	Method to get the counters of the current frame.
+		*	@return	the counters since the last reset
+		*/
+		Statistics GetStatistics() const;
+
+		/**
+		*	@brief	Method to get the counters of the last frame that was reset.
+		*	@return	the counters of the last frame
+		*/
+		const Statistics& GetLastFrameStatistics() const;
+
+		/**
+		*	@brief	Method to get the number of blocks that have not been given back.
+		*	@return	unsigned int representing the number of live blocks
+		*/
+		std::uint32_t LiveAllocationCount() const;
+
+		static const size_t DefaultChunkSize = 64 * 1024;		/**<	The default size of a chunk in bytes	*/
+
+	private:
+
+		/**
+		*	@brief	A chunk of memory that blocks are carved out of.
+		*/
+		struct Chunk
+		{
+			char* mData;						/**<	The memory of the chunk	*/
+			size_t mSize;						/**<	The size of the chunk in bytes	*/
+			std::atomic<size_t> mOffset;		/**<	The offset of the first free byte	*/
+		};
+
+		/**
+		*	@brief	Helper method to carve a block out of a chunk without locking.
+		*	@param	chunk the chunk
+		*	@param	size the size of the block in bytes
+		*	@param	alignment the alignment that the block must have
+		*	@return	pointer to the block, or nullptr if the chunk is full
+		*/
+		static void* AllocateFrom(Chunk& chunk, const size_t size, const size_t alignment);
+
+		/**
+		*	@brief	Helper method to allocate a chunk.
+		*	@param	size the size of the chunk in bytes
+		*	@return	pointer to the chunk
+		*/
+		static Chunk* CreateChunk(const size_t size);
+
+		/**
+		*	@brief	Helper method to free a chunk.
+		*	@param	chunk the chunk
+		*/
+		static void DestroyChunk(Chunk* chunk);
+
+		size_t mChunkSize;									/**<	The size of the chunks that are added during a frame	*/
+		Vector<Chunk*> mChunks;								/**<	The chunks of the frame, the current one last	*/
+		std::atomic<Chunk*> mCurrentChunk;					/**<	The chunk that blocks are carved out of	*/
+		std::mutex mMutex;									/**<	The lock for adding chunks	*/
+		std::atomic<std::uint64_t> mAllocationCount;		/**<	The number of blocks handed out during the frame	*/
+		std::atomic<std::uint64_t> mByteCount;				/**<	The number of bytes handed out during the frame	*/
+		std::atomic<std::uint32_t> mLiveAllocationCount;	/**<	The number of blocks that have not been given back	*/
+		Statistics mLastFrameStatistics;					/**<	The counters of the last frame that was reset	*/
+
+	};
+
+	/**
+	*	@brief	The FrameAllocatorAdapter class is a standard library allocator that takes memory from
+	*			a FrameAllocator, e.g. for std::allocate_shared.
+	*/
+	template <typename T>
+	class FrameAllocatorAdapter final
+	{
+
+	public:
+
+		typedef T value_type;		/**<	The type of the allocated objects	*/
+
+		/**
+		*	@brief	Parameterized constructor that takes the frame allocator to allocate from.
+		*	@param	allocator the frame allocator
+		*/
+		explicit FrameAllocatorAdapter(FrameAllocator& allocator);
+
+		/**
+		*	@brief	Converting constructor, which allocators of the standard library rely on to rebind.
+		*	@param	other the allocator of another type
+		*/
+		template <typename U>
+		FrameAllocatorAdapter(const FrameAllocatorAdapter<U>& other);
+
+		/**
+		*	@brief	Method to allocate memory for objects.
+		*	@param	count the number of objects
+		*	@return	pointer to the memory
+		*/
+		T* allocate(const size_t count);
+
+		/**
+		*	@brief	Method to give back memory that was allocated by allocate.
+		*	@param	memory pointer to the memory
+		*	@param	count the number of objects that were allocated
+		*/
+		void deallocate(T* memory, const size_t count);
+
+		/**
+		*	@brief	Method to get the frame allocator.
+		*	@return	reference to the frame allocator
+		*/
+		FrameAllocator& Allocator() const;
+
+		/**
+		*	@brief	Allocators are equal when they allocate from the same frame allocator.
+		*/
+		template <typename U>
+		bool operator==(const FrameAllocatorAdapter<U>& other) const;
+
+		/**
+		*	@brief	Allocators are equal when they allocate from the same frame allocator.
+		*/
+		template <typename U>
+		bool operator!=(const FrameAllocatorAdapter<U>& other) const;
+
+	private:
+
+		FrameAllocator* mAllocator;		/**<	The frame allocator	*/
+
+	};
+
+}
+
+#include "FrameAllocator.inl"
\ No newline at end of file
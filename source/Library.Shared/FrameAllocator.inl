@@ -0,0 +1,69 @@
+#include "pch.h"
+#include "FrameAllocator.h"
+
+namespace FieaGameEngine
+{
+
+	template <typename T>
+	FrameAllocatorAdapter<T>::FrameAllocatorAdapter(FrameAllocator& allocator) : mAllocator(&allocator)
+	{
+	}
+
+
+
+
+	template <typename T>
+	template <typename U>
+	FrameAllocatorAdapter<T>::FrameAllocatorAdapter(const FrameAllocatorAdapter<U>& other) : mAllocator(&other.Allocator())
+	{
+	}
+
+
+
+
+	template <typename T>
+	T* FrameAllocatorAdapter<T>::allocate(const size_t count)
+	{
+		return static_cast<T*>(mAllocator->Allocate(count * sizeof(T), alignof(T)));
+	}
+
+
+
+
+	template <typename T>
+	void FrameAllocatorAdapter<T>::deallocate(T* memory, const size_t count)
+	{
+		UNREFERENCED_PARAMETER(count);
+		mAllocator->Deallocate(memory);
+	}
+
+
+
+
+	template <typename T>
+	FrameAllocator& FrameAllocatorAdapter<T>::Allocator() const
+	{
+		return *mAllocator;
+	}
+
+
+
+
+	template <typename T>
+	template <typename U>
+	bool FrameAllocatorAdapter<T>::operator==(const FrameAllocatorAdapter<U>& other) const
+	{
+		return (mAllocator == &other.Allocator());
+	}
+
+
+
+
+	template <typename T>
+	template <typename U>
+	bool FrameAllocatorAdapter<T>::operator!=(const FrameAllocatorAdapter<U>& other) const
+	{
+		return !(*this == other);
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,158 @@
+#include "pch.h"
+#include "HandleTable.h"
+
+
+namespace FieaGameEngine
+{
+
+	const std::uint32_t HandleTable::NoFreeSlot = std::numeric_limits<std::uint32_t>::max();
+	std::atomic<HandleTable::Slot*> HandleTable::mPages[HandleTable::MaxPages];
+	std::uint32_t HandleTable::mSlotCount = 0;
+	std::uint32_t HandleTable::mFreeSlot = HandleTable::NoFreeSlot;
+	std::mutex HandleTable::mMutex;
+
+
+
+
+	void HandleTable::Register(Attributed& object, Handle& handle)
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+
+		if (handle.IsValid())
+		{
+			return;
+		}
+
+		std::uint32_t index;
+		Slot* slot;
+		if (mFreeSlot != NoFreeSlot)
+		{
+			index = mFreeSlot;
+			slot = GetSlot(index);
+			mFreeSlot = slot->mNextFree;
+		}
+		else
+		{
+			if (mSlotCount == (SlotsPerPage * MaxPages))
+			{
+				throw std::exception("Handle table is full.");
+			}
+
+			index = mSlotCount++;
+			std::uint32_t page = index / SlotsPerPage;
+			if (mPages[page].load(std::memory_order_relaxed) == nullptr)
+			{
+				Slot* slots = new Slot[SlotsPerPage];
+				for (std::uint32_t i = 0; i < SlotsPerPage; ++i)
+				{
+					slots[i].mObject.store(nullptr, std::memory_order_relaxed);
+					slots[i].mGeneration.store(1, std::memory_order_relaxed);
+					slots[i].mMarkedGeneration.store(0, std::memory_order_relaxed);
+					slots[i].mNextFree = NoFreeSlot;
+				}
+				mPages[page].store(slots, std::memory_order_release);
+			}
+			slot = GetSlot(index);
+		}
+
+		slot->mObject.store(&object, std::memory_order_release);
+
+		handle.mIndex = index;
+		handle.mGeneration = slot->mGeneration.load(std::memory_order_relaxed);
+	}
+
+
+
+
+	void HandleTable::Release(const Handle& handle)
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+
+		Slot* slot = GetSlot(handle.mIndex);
+		if ((slot == nullptr) || (slot->mGeneration.load(std::memory_order_relaxed) != handle.mGeneration))
+		{
+			return;
+		}
+
+		//the object is cleared before the generation moves on, so a reader that still sees the old generation gets no object
+		slot->mObject.store(nullptr, std::memory_order_release);
+		std::uint32_t generation = handle.mGeneration + 1;
+		slot->mGeneration.store((generation == 0) ? 1 : generation, std::memory_order_release);
+
+		slot->mNextFree = mFreeSlot;
+		mFreeSlot = handle.mIndex;
+	}
+
+
+
+
+	Attributed* HandleTable::Resolve(const Handle& handle)
+	{
+		Slot* slot = GetSlot(handle.mIndex);
+		if ((slot == nullptr) || (slot->mGeneration.load(std::memory_order_acquire) != handle.mGeneration))
+		{
+			return nullptr;
+		}
+
+		//the slot may have been released and given to a new object since the generation was checked
+		Attributed* object = slot->mObject.load(std::memory_order_acquire);
+		if (slot->mGeneration.load(std::memory_order_acquire) != handle.mGeneration)
+		{
+			return nullptr;
+		}
+
+		return object;
+	}
+
+
+
+
+	bool HandleTable::IsAlive(const Handle& handle)
+	{
+		return Resolve(handle) != nullptr;
+	}
+
+
+
+
+	bool HandleTable::MarkForDestruction(const Handle& handle)
+	{
+		Slot* slot = GetSlot(handle.mIndex);
+		if (slot == nullptr)
+		{
+			return false;
+		}
+
+		//a mark left by an earlier generation of the slot does not count, so a stale handle can never block the current object
+		std::uint32_t marked = slot->mMarkedGeneration.load(std::memory_order_acquire);
+		do
+		{
+			if ((marked == handle.mGeneration) || (Resolve(handle) == nullptr))
+			{
+				return false;
+			}
+		} while (!slot->mMarkedGeneration.compare_exchange_weak(marked, handle.mGeneration, std::memory_order_acq_rel));
+
+		return true;
+	}
+
+
+
+
+	HandleTable::Slot* HandleTable::GetSlot(const std::uint32_t index)
+	{
+		if (index >= (SlotsPerPage * MaxPages))
+		{
+			return nullptr;
+		}
+
+		Slot* page = mPages[index / SlotsPerPage].load(std::memory_order_acquire);
+		if (page == nullptr)
+		{
+			return nullptr;
+		}
+
+		return &page[index % SlotsPerPage];
+	}
+
+}
\ No newline at end of file
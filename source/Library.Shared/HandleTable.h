@@ -0,0 +1,159 @@
+#pragma once
+
+#include <mutex>
+#include <atomic>
+
+/**
+*	@brief	The namespace under which the game engine is implemented.
+*/
+namespace FieaGameEngine
+{
+	class Attributed;		//forward declaration for the Attributed class
+
+	/**
+	*	@brief	A Handle refers to an Attributed without owning it. Unlike a pointer, a handle can be
+	*			checked in constant time to find out whether the object it refers to is still alive,
+	*			since the slot of the object gets a new generation when the object is destroyed.
+	*/
+	struct Handle
+	{
+		/**
+		*	@brief	The default constructor creates a handle that refers to nothing.
+		*/
+		Handle() : mIndex(0), mGeneration(0)
+		{
+		}
+
+		/**
+		*	@brief	Method to check whether the handle was ever given out for an object.
+		*	@return	bool indicating whether the handle is not the null handle
+		*/
+		bool IsValid() const
+		{
+			return mGeneration != 0;
+		}
+
+		bool operator==(const Handle& other) const
+		{
+			return (mIndex == other.mIndex) && (mGeneration == other.mGeneration);
+		}
+
+		bool operator!=(const Handle& other) const
+		{
+			return !(*this == other);
+		}
+
+		std::uint32_t mIndex;				/**<	The index of the slot of the object in the handle table	*/
+		std::uint32_t mGeneration;			/**<	The generation of the slot when the handle was given out, 0 for the null handle	*/
+	};
+
+	/**
+	*	@brief	The HandleTable class keeps the slots that handles refer to. Attributeds register
+	*			themselves the first time a handle to them is asked for, and release their slot when
+	*			they are destroyed. Slots live in pages that are never moved, so handles are resolved
+	*			without taking a lock.
+	*/
+	class HandleTable final
+	{
+
+	public:
+
+		/**
+		*	@brief	The default constructor is deleted, since the class only has static members.
+		*/
+		HandleTable() = delete;
+
+		/**
+		*	@brief	The copy constructor is deleted.
+		*/
+		HandleTable(const HandleTable& other) = delete;
+
+		/**
+		*	@brief	The move constructor is deleted.
+		*/
+		HandleTable(HandleTable&& other) = delete;
+
+		/**
+		*	@brief	The copy assignment operator is deleted.
+		*/
+		HandleTable& operator=(const HandleTable& other) = delete;
+
+		/**
+		*	@brief	The move assignment operator is deleted.
+		*/
+		HandleTable& operator=(HandleTable&& other) = delete;
+
+		/**
+		*	@brief	The destructor is deleted, since the class only has static members.
+		*/
+		~HandleTable() = delete;
+
+		/**
+		*	@brief	Static method to give an object a slot, unless the handle of the object already
+		*			refers to one. The check is made under the lock of the table, so that an object
+		*			never gets two slots.
+		*	@param	object the object to be registered
+		*	@param	handle the handle of the object, which is set to the new slot
+		*/
+		static void Register(Attributed& object, Handle& handle);
+
+		/**
+		*	@brief	Static method to free the slot of an object, after which all of its handles are dead.
+		*	@param	handle the handle of the object
+		*/
+		static void Release(const Handle& handle);
+
+		/**
+		*	@brief	Static method to get the object that a handle refers to. The generation is checked
+		*			again after the object is read, so a slot reused by another object is never returned.
+		*	@param	handle the handle of the object
+		*	@return	pointer to the object if it is alive, nullptr otherwise
+		*/
+		static Attributed* Resolve(const Handle& handle);
+
+		/**
+		*	@brief	Static method to check whether the object that a handle refers to is alive.
+		*	@param	handle the handle of the object
+		*	@return	bool indicating whether the object is alive
+		*/
+		static bool IsAlive(const Handle& handle);
+
+		/**
+		*	@brief	Static method to mark an object to be destroyed, so that it is only queued once.
+		*	@param	handle the handle of the object
+		*	@return	bool indicating whether the object is alive and was not marked before
+		*/
+		static bool MarkForDestruction(const Handle& handle);
+
+	private:
+
+		/**
+		*	@brief	The slot of an object.
+		*/
+		struct Slot
+		{
+			std::atomic<Attributed*> mObject;				/**<	The object in the slot, nullptr if the slot is free	*/
+			std::atomic<std::uint32_t> mGeneration;			/**<	The generation of the slot, which changes every time the slot is freed	*/
+			std::atomic<std::uint32_t> mMarkedGeneration;	/**<	The generation whose object is queued to be destroyed, 0 if none	*/
+			std::uint32_t mNextFree;						/**<	The next free slot, if the slot is free	*/
+		};
+
+		/**
+		*	@brief	Helper method to get a slot.
+		*	@param	index the index of the slot
+		*	@return	pointer to the slot, nullptr if it was never allocated
+		*/
+		static Slot* GetSlot(const std::uint32_t index);
+
+		static const std::uint32_t SlotsPerPage = 1024;		/**<	The number of slots in a page	*/
+		static const std::uint32_t MaxPages = 1024;			/**<	The number of pages the table can have	*/
+		static const std::uint32_t NoFreeSlot;				/**<	Marks the end of the list of free slots	*/
+
+		static std::atomic<Slot*> mPages[MaxPages];			/**<	The pages of slots, which are allocated as they are needed and never freed	*/
+		static std::uint32_t mSlotCount;					/**<	The number of slots that were ever used	*/
+		static std::uint32_t mFreeSlot;						/**<	The first free slot	*/
+		static std::mutex mMutex;							/**<	The lock for registering and releasing	*/
+
+	};
+
+}
\ No newline at end of file
@@ -285,10 +285,11 @@ namespace FieaGameEngine
 		HashMap(const HashMap<TKey, TData, HashFunctor, ComparisonFunctor>& other) = default;
 
 		/**
-		*	@brief	Move constructor for the HashMap
+		*	@brief	Move constructor for the HashMap. The moved HashMap is left with no buckets
+		*			and a size of zero, so that it reports being empty.
 		*	@param	other the HashMap whose data is to be moved
 		*/
-		HashMap(HashMap<TKey, TData, HashFunctor, ComparisonFunctor>&& other) = default;
+		HashMap(HashMap<TKey, TData, HashFunctor, ComparisonFunctor>&& other);
 
 		/**
 		*	@brief	The copy assignment operator is overloaded for HashMap
@@ -298,11 +299,11 @@ namespace FieaGameEngine
 		HashMap<TKey, TData, HashFunctor, ComparisonFunctor>& operator=(const HashMap<TKey, TData, HashFunctor, ComparisonFunctor>& other) = default;
 
 		/**
-		*	@brief	The move assignment operator is overloaded for HashMap
-		*			and is defaulted
+		*	@brief	The move assignment operator is overloaded for HashMap. The moved
+		*			HashMap is left with no buckets and a size of zero.
 		*	@param	other the HashMap whose data is to be moved
 		*/
-		HashMap<TKey, TData, HashFunctor, ComparisonFunctor>& operator=(HashMap<TKey, TData, HashFunctor, ComparisonFunctor>&& other) = default;
+		HashMap<TKey, TData, HashFunctor, ComparisonFunctor>& operator=(HashMap<TKey, TData, HashFunctor, ComparisonFunctor>&& other);
 
 		/**
 		*	@brief	The comparison operator for the hashmap is overloaded to use the custom comparison functor provided as a template parameter
@@ -355,6 +356,16 @@ namespace FieaGameEngine
 		*/
 		Iterator Insert(const PairType& keyValuePair, bool& wasInserted);
 
+		/**
+		*	@brief	Method to insert a key value pair in the HashMap without first checking
+		*			whether the key already exists. This skips the lookup that Insert performs,
+		*			so the caller must guarantee that the key is not already in the HashMap.
+		*	@param	keyValuePair a const reference to the PairType that is to be added to the
+		*			HashMap
+		*	@return	Iterator pointing to the newly inserted PairType
+		*/
+		Iterator InsertUnique(const PairType& keyValuePair);
+
 		/**
 		*	@brief	Method to remove a PairType from the HashMap, unless it doesn't
 		*			exist in the first place, in which case it does nothing
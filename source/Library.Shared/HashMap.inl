@@ -124,6 +124,27 @@ FieaGameEngine::HashMap<TKey, TData, HashFunctor, ComparisonFunctor>::HashMap(co
 }
 
 
+template<typename TKey, typename TData, typename HashFunctor, typename ComparisonFunctor>
+FieaGameEngine::HashMap<TKey, TData, HashFunctor, ComparisonFunctor>::HashMap(HashMap<TKey, TData, HashFunctor, ComparisonFunctor>&& other) : mBuckets(std::move(other.mBuckets)), mSize(other.mSize)
+{
+	other.mSize = 0;
+}
+
+
+template<typename TKey, typename TData, typename HashFunctor, typename ComparisonFunctor>
+FieaGameEngine::HashMap<TKey, TData, HashFunctor, ComparisonFunctor>& FieaGameEngine::HashMap<TKey, TData, HashFunctor, ComparisonFunctor>::operator=(HashMap<TKey, TData, HashFunctor, ComparisonFunctor>&& other)
+{
+	if (this != &other)
+	{
+		mBuckets = std::move(other.mBuckets);
+		mSize = other.mSize;
+		other.mSize = 0;
+	}
+
+	return *this;
+}
+
+
 template<typename TKey, typename TData, typename HashFunctor, typename ComparisonFunctor>
 bool FieaGameEngine::HashMap<TKey, TData, HashFunctor, ComparisonFunctor>::operator==(const HashMap<TKey, TData, HashFunctor, ComparisonFunctor>& other) const
 {
@@ -222,6 +243,19 @@ typename FieaGameEngine::HashMap<TKey, TData, HashFunctor, ComparisonFunctor>::I
 }
 
 
+template<typename TKey, typename TData, typename HashFunctor, typename ComparisonFunctor>
+typename FieaGameEngine::HashMap<TKey, TData, HashFunctor, ComparisonFunctor>::Iterator FieaGameEngine::HashMap<TKey, TData, HashFunctor, ComparisonFunctor>::InsertUnique(const PairType& keyValuePair)
+{
+	HashFunctor hashFunction;
+	std::uint32_t index = hashFunction(keyValuePair.first) % mBuckets.Size();
+
+	Iterator it(*this, index, mBuckets[index].PushBack(keyValuePair));
+	++mSize;
+
+	return it;
+}
+
+
 template<typename TKey, typename TData, typename HashFunctor, typename ComparisonFunctor>
 bool FieaGameEngine::HashMap<TKey, TData, HashFunctor, ComparisonFunctor>::Remove(const TKey& key)
 {
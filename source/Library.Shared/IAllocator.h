@@ -0,0 +1,65 @@
+#pragma once
+
+/**
+*	@brief	The namespace under which the game engine is implemented.
+*/
+namespace FieaGameEngine
+{
+	/**
+	*	@brief	The Allocator interface lets the engine place objects in memory that it does not
+	*			get from the global heap, such as pools or arenas. This is the abstract base class
+	*			that actual allocators will derive from.
+	*/
+	class IAllocator
+	{
+
+	public:
+
+		/**
+		*	@brief The default constructor is defaulted.
+		*/
+		IAllocator() = default;
+
+		/**
+		*	@brief The copy constructor is deleted.
+		*/
+		IAllocator(const IAllocator& other) = delete;
+
+		/**
+		*	@brief The move constructor is deleted.
+		*/
+		IAllocator(IAllocator&& other) = delete;
+
+		/**
+		*	@brief The copy assignment operator is deleted.
+		*/
+		IAllocator& operator=(const IAllocator& other) = delete;
+
+		/**
+		*	@brief The move assignment operator is deleted.
+		*/
+		IAllocator& operator=(IAllocator&& other) = delete;
+
+		/**
+		*	@brief The destructor is defaulted.
+		*/
+		virtual ~IAllocator() = default;
+
+		/**
+		*	@brief	Method to allocate a block of memory. Allocators throw an exception when they
+		*			are unable to allocate, instead of returning nullptr.
+		*	@param	size the size of the block in bytes
+		*	@param	alignment the alignment that the block must have
+		*	@return	pointer to the allocated block
+		*/
+		virtual void* Allocate(const size_t size, const size_t alignment) = 0;
+
+		/**
+		*	@brief	Method to give back a block that was allocated by this allocator.
+		*	@param	memory pointer to the block
+		*/
+		virtual void Deallocate(void* memory) = 0;
+
+	};
+
+}
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include "pch.h"
 #include "IEventPublisher.h"
+#include "JobSystem.h"
+#include "EventProfiler.h"
 
 
 namespace FieaGameEngine
@@ -8,7 +10,7 @@ namespace FieaGameEngine
 	RTTI_DEFINITIONS(IEventPublisher)
 
 
-	IEventPublisher::IEventPublisher(Vector<IEventSubscriber*>& subscriberList, std::mutex& mutex) : mReferenceToSubscriberList(&subscriberList), mMutexPointer(&mutex)
+	IEventPublisher::IEventPublisher() : mIsTransient(false), mSequence(0)
 	{
 
 	}
@@ -18,8 +20,6 @@ namespace FieaGameEngine
 		
 	void IEventPublisher::SetTime(const std::chrono::high_resolution_clock::time_point& timeEnqueued, const std::chrono::milliseconds& delay)
 	{
-		std::lock_guard<std::mutex> lock(*mMutexPointer);
-
 		mTimeEnqueued = timeEnqueued;
 		mDelay = delay;
 	}
@@ -29,8 +29,6 @@ namespace FieaGameEngine
 
 	const std::chrono::high_resolution_clock::time_point& IEventPublisher::TimeEnqueued() const
 	{
-		std::lock_guard<std::mutex> lock(*mMutexPointer);
-
 		return mTimeEnqueued;
 	}
 
@@ -39,8 +37,6 @@ namespace FieaGameEngine
 
 	const std::chrono::milliseconds& IEventPublisher::Delay() const
 	{
-		std::lock_guard<std::mutex> lock(*mMutexPointer);
-
 		return mDelay;
 	}
 
@@ -49,8 +45,6 @@ namespace FieaGameEngine
 
 	bool IEventPublisher::IsExpired(const std::chrono::high_resolution_clock::time_point& currentTime) const
 	{
-		std::lock_guard<std::mutex> lock(*mMutexPointer);
-
 		if (std::chrono::time_point_cast<std::chrono::milliseconds>(currentTime) >= (std::chrono::time_point_cast<std::chrono::milliseconds>(mTimeEnqueued) + mDelay))
 		{
 			return true;
@@ -62,34 +56,107 @@ namespace FieaGameEngine
 
 
 
-	void IEventPublisher::Deliver()
+	bool IEventPublisher::IsTransient() const
+	{
+		return mIsTransient;
+	}
+
+
+
+
+	void IEventPublisher::SetSequence(const std::uint64_t sequence)
+	{
+		mSequence = sequence;
+	}
+
+
+
+
+	std::uint64_t IEventPublisher::Sequence() const
+	{
+		return mSequence;
+	}
+
+
+
+
+	void IEventPublisher::Deliver(JobSystem* jobs, const std::uint32_t grainSize)
+	{
+		NotifySubscribers(true, jobs, grainSize);
+	}
+
+
+
+
+	void IEventPublisher::Notify(const Vector<IEventSubscriber*>& subscribers, JobSystem* jobs, const std::uint32_t grainSize, const std::uint32_t firstIndex) const
 	{
-		std::vector<std::future<void>> futures;
+		if ((jobs == nullptr) || (subscribers.Size() <= grainSize))
 		{
-			std::lock_guard<std::mutex> lock(*mMutexPointer);
+			for (std::uint32_t i = 0; i < subscribers.Size(); ++i)
+			{
+				NotifySubscriber(*subscribers[i], firstIndex + i);
+			}
+			return;
+		}
 
-			for (auto& subscriber : *mReferenceToSubscriberList)
+		jobs->ParallelFor(subscribers.Size(), grainSize, [this, &subscribers, firstIndex](std::uint32_t begin, std::uint32_t end)
+		{
+			for (std::uint32_t i = begin; i < end; ++i)
 			{
-				futures.emplace_back(std::async(std::launch::async, [subscriber, this]()
-				{
-					subscriber->Notify(*this);
-				}));
+				NotifySubscriber(*subscribers[i], firstIndex + i);
 			}
+		});
+	}
+
 
-		}
 
-		for (auto& future : futures)
+
+	void IEventPublisher::NotifySubscriber(IEventSubscriber& subscriber, const std::uint32_t subscriberIndex) const
+	{
+		NotifyScope notifyScope;
+		if (!EventProfiler::SampleNotify())
 		{
-			future.get();
+			subscriber.Notify(*this, subscriberIndex);
+			return;
 		}
+
+		std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+		subscriber.Notify(*this, subscriberIndex);
+		EventProfiler::RecordNotify(*this, subscriber, std::chrono::high_resolution_clock::now() - start);
+	}
+
+
+
+
+	bool IEventPublisher::IsNotifying()
+	{
+		return NotifyDepth() != 0;
+	}
+
+
+
+
+	IEventPublisher::NotifyScope::NotifyScope()
+	{
+		++NotifyDepth();
+	}
+
+
+
+
+	IEventPublisher::NotifyScope::~NotifyScope()
+	{
+		--NotifyDepth();
 	}
 
 
 
 
-	std::mutex* IEventPublisher::Mutex() const
+	std::uint32_t& IEventPublisher::NotifyDepth()
 	{
-		return mMutexPointer;
+		//subscribers may be notified from inside the notification of another one, e.g. by Send
+		static thread_local std::uint32_t notifyDepth = 0;
+		return notifyDepth;
 	}
 
 }
\ No newline at end of file
@@ -10,6 +10,8 @@
 namespace FieaGameEngine
 {
 
+	class JobSystem;	//forward declaration for the JobSystem class
+
 	/**
 	*	@brief	The EventPublisher is an interface that the templated Event class derives
 	*			from. It is used to implement the observer pattern.
@@ -22,10 +24,9 @@ namespace FieaGameEngine
 	public:
 
 		/**
-		*	@brief	Parameterized constructor that takes in a reference to a vector of event subscribers
-		*	@param	subscriberList reference to a vector of pointers to event subscribers.
+		*	@brief	The default constructor. The subscribers are kept by the event type.
 		*/
-		explicit IEventPublisher(Vector<IEventSubscriber*>& subscriberList, std::mutex& mutex);
+		IEventPublisher();
 		
 		/**
 		*	@brief	The copy constructor is defaulted
@@ -53,7 +54,9 @@ namespace FieaGameEngine
 		virtual ~IEventPublisher() = default;
 
 		/**
-		*	@brief	Method to set the time this event is enqueued and the delay after which it expires
+		*	@brief	Method to set the time this event is enqueued and the delay after which it expires.
+		*			The time belongs to this event alone, so it is not locked, and an event must not be
+		*			queued by two threads at once.
 		*	@param	timeEnqueued the time at which this event is enqueued
 		*	@param	delay the time after which this event expires
 		*/
@@ -79,25 +82,121 @@ namespace FieaGameEngine
 		bool IsExpired(const std::chrono::high_resolution_clock::time_point& currentTime) const;
 
 		/**
-		*	@brief	Method that basically notifies all the subscribers of this event
+		*	@brief	Method to check whether this event lives in a frame allocator, in which case it must
+		*			not be kept past the end of the frame.
+		*	@return	bool that indicates whether this event is transient
 		*/
-		void Deliver();
+		bool IsTransient() const;
 
 		/**
-		*	@brief	Method to obtain the pointer to the mutex
-		*	@return	mutex pointer
+		*	@brief	Method to set the position of this event in the order that its queue delivers events,
+		*			which is the same from run to run, unlike the threads that the events are queued from.
+		*	@param	sequence the position of this event in the delivery
 		*/
-		std::mutex* Mutex() const;
+		void SetSequence(const std::uint64_t sequence);
+
+		/**
+		*	@brief	Method to get the position of this event in the order that its queue delivers events.
+		*	@return	the position of this event in the delivery
+		*/
+		std::uint64_t Sequence() const;
+
+		/**
+		*	@brief	Method that copies this event, along with its time, into storage that outlives the
+		*			frame, e.g. when a transient event is delayed.
+		*	@return	shared pointer to the copy
+		*/
+		virtual std::shared_ptr<IEventPublisher> Promote() const = 0;
+
+		/**
+		*	@brief	Method that notifies all the subscribers of this event. The subscribers are taken
+		*			from the list as it is when delivery starts, without locking, so they may subscribe
+		*			and unsubscribe at any time, including while they are notified.
+		*	@param	jobs the job system that notifies the subscribers in groups, one job per group, or
+		*			nullptr to notify them one after the other on the calling thread
+		*	@param	grainSize the largest number of subscribers in one group
+		*/
+		void Deliver(JobSystem* jobs = nullptr, const std::uint32_t grainSize = SubscriberGrainSize);
+
+		/**
+		*	@brief	Method that delivers a batch of events of the same type as this one, e.g. the events
+		*			of that type that are due in an update. The subscribers of single events are notified
+		*			of each event in turn, and the batch subscribers of the type are notified once.
+		*	@param	events pointer to the first of the events, which are all of the type of this event
+		*	@param	count the number of events
+		*	@param	jobs the job system that notifies the subscribers in groups, or nullptr to notify them
+		*			one after the other on the calling thread
+		*	@param	grainSize the largest number of subscribers in one group
+		*	@param	isOrdered whether the events are delivered one after the other, each to all of its
+		*			subscribers before the next, rather than as jobs of their own
+		*/
+		virtual void DeliverBatch(const std::shared_ptr<IEventPublisher>* events, const std::uint32_t count, JobSystem* jobs = nullptr, const std::uint32_t grainSize = SubscriberGrainSize, const bool isOrdered = false) = 0;
+
+		static const std::uint32_t SubscriberGrainSize = 16;		/**<	The default number of subscribers that are notified by one job	*/
 
 	protected:
 
-		std::mutex* mMutexPointer;											/**<	mutex pointer for the event publisher class	*/
+		/**
+		*	@brief	Method that notifies the subscribers of the type of this event, taken from the list
+		*			as it is when it is called.
+		*	@param	includeBatchSubscribers whether the batch subscribers are notified as well, which they
+		*			are not when the event is delivered as part of a batch
+		*	@param	jobs the job system that notifies the subscribers in groups, or nullptr
+		*	@param	grainSize the largest number of subscribers in one group
+		*/
+		virtual void NotifySubscribers(const bool includeBatchSubscribers, JobSystem* jobs, const std::uint32_t grainSize) const = 0;
+
+		/**
+		*	@brief	Helper method that notifies a list of subscribers of this event, in groups on the job
+		*			system if there is one and the list is longer than a group.
+		*	@param	subscribers the subscribers to be notified
+		*	@param	jobs the job system that notifies the subscribers in groups, or nullptr
+		*	@param	grainSize the largest number of subscribers in one group
+		*	@param	firstIndex the position of the first subscriber of the list in the delivery of this event
+		*/
+		void Notify(const Vector<IEventSubscriber*>& subscribers, JobSystem* jobs, const std::uint32_t grainSize, const std::uint32_t firstIndex = 0) const;
+
+		/**
+		*	@brief	Helper method that notifies a single subscriber of this event, timing the call when
+		*			the EventProfiler samples it.
+		*	@param	subscriber the subscriber to be notified
+		*	@param	subscriberIndex the position of the subscriber in the delivery of this event
+		*/
+		void NotifySubscriber(IEventSubscriber& subscriber, const std::uint32_t subscriberIndex) const;
+
+		/**
+		*	@brief	Static helper method to check whether the calling thread is inside the notification
+		*			of a subscriber. A change to the subscribers made from there cannot wait for the
+		*			deliveries that are in flight, since one of them is the caller's own.
+		*	@return	bool indicating whether the calling thread is notifying a subscriber
+		*/
+		static bool IsNotifying();
+
+		/**
+		*	@brief	Marks the calling thread as notifying a subscriber for as long as it lives, so that
+		*			an exception thrown by the subscriber does not leave the thread marked.
+		*/
+		struct NotifyScope
+		{
+			NotifyScope();
+			~NotifyScope();
+		};
 
 		std::chrono::high_resolution_clock::time_point mTimeEnqueued;		/**<	the time point at which this event is enqueued	*/
 
 		std::chrono::milliseconds mDelay;									/**<	the delay after which this event expires	*/
 
-		Vector<IEventSubscriber*>* mReferenceToSubscriberList;				/**<	reference to the vector of pointers to subscribers of this event	*/
+		bool mIsTransient;													/**<	whether this event lives in a frame allocator	*/
+
+		std::uint64_t mSequence;											/**<	the position of this event in the order that its queue delivers events	*/
+
+	private:
+
+		/**
+		*	@brief	Static helper method to get the number of notifications the calling thread is inside of.
+		*	@return	reference to the counter of the calling thread
+		*/
+		static std::uint32_t& NotifyDepth();
 
 	};
 
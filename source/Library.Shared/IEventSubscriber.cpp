@@ -1,2 +1,14 @@
 #include "pch.h"
-#include "IEventSubscriber.h"
\ No newline at end of file
+#include "IEventSubscriber.h"
+
+
+namespace FieaGameEngine
+{
+
+	void IEventSubscriber::Notify(const IEventPublisher& publisher, const std::uint32_t subscriberIndex)
+	{
+		UNREFERENCED_PARAMETER(subscriberIndex);
+		Notify(publisher);
+	}
+
+}
\ No newline at end of file
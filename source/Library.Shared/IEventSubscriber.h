@@ -55,6 +55,16 @@ namespace FieaGameEngine
 		*/
 		virtual void Notify(const IEventPublisher& publisher) = 0;
 
+		/**
+		*	@brief	Method that is called instead of Notify by the event system, with the position of
+		*			this subscriber among those that the event is delivered to, so that subscribers whose
+		*			work has to be ordered do not depend on which thread notified them. By default it
+		*			just calls Notify.
+		*	@param	publisher reference to the event being published
+		*	@param	subscriberIndex the position of this subscriber in the delivery of the event
+		*/
+		virtual void Notify(const IEventPublisher& publisher, const std::uint32_t subscriberIndex);
+
 	};
 
 }
\ No newline at end of file
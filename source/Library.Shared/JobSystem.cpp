@@ -0,0 +1,398 @@
+#include "pch.h"
+#include "JobSystem.h"
+
+
+namespace FieaGameEngine
+{
+
+	namespace
+	{
+		/**
+		*	@brief	The job system that the calling thread works for, and its index in that system.
+		*/
+		struct WorkerIdentity
+		{
+			const JobSystem* mSystem;
+			std::uint32_t mIndex;
+		};
+
+		thread_local WorkerIdentity CurrentWorker = { nullptr, 0 };
+	}
+
+
+
+
+	JobCounter::JobCounter() : mCount(0), mException()
+	{
+	}
+
+
+
+
+	bool JobCounter::IsDone() const
+	{
+		return mCount.load(std::memory_order_acquire) == 0;
+	}
+
+
+
+
+	JobSystem::JobSystem(const std::uint32_t workerCount) : mQueuedJobCount(0), mNextWorker(0), mIsStopping(false)
+	{
+		if (workerCount == 0)
+		{
+			throw std::exception("A job system needs at least one worker.");
+		}
+
+		mWorkers.Reserve(workerCount);
+		for (std::uint32_t i = 0; i < workerCount; ++i)
+		{
+			mWorkers.PushBack(new Worker());
+		}
+
+		//the workers are started once all of them exist, since they steal from each other
+		for (std::uint32_t i = 0; i < workerCount; ++i)
+		{
+			mWorkers[i]->mThread = std::thread(&JobSystem::WorkerLoop, this, i);
+		}
+	}
+
+
+
+
+	JobSystem::~JobSystem()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mWakeMutex);
+			mIsStopping = true;
+		}
+		mWake.notify_all();
+
+		for (std::uint32_t i = 0; i < mWorkers.Size(); ++i)
+		{
+			mWorkers[i]->mThread.join();
+		}
+
+		for (std::uint32_t i = 0; i < mWorkers.Size(); ++i)
+		{
+			delete mWorkers[i];
+		}
+	}
+
+
+
+
+	void JobSystem::Run(const Job& job, JobCounter* counter)
+	{
+		if (counter != nullptr)
+		{
+			counter->mCount.fetch_add(JobCounter::JobCount, std::memory_order_relaxed);
+		}
+
+		Queue({ job, counter });
+	}
+
+
+
+
+	void JobSystem::Run(const Job& job, JobCounter* counter, JobCounter& dependsOn)
+	{
+		if (counter == &dependsOn)
+		{
+			throw std::exception("A job cannot depend on its own group.");
+		}
+
+		if (counter != nullptr)
+		{
+			counter->mCount.fetch_add(JobCounter::JobCount, std::memory_order_relaxed);
+		}
+
+		//the flag is set under the lock that the last job of the dependency takes its dependents under, so the job is either held or queued here
+		{
+			std::lock_guard<std::mutex> lock(dependsOn.mDependentsMutex);
+			std::uint32_t count = dependsOn.mCount.load(std::memory_order_acquire);
+			while ((count >= JobCounter::JobCount) && !dependsOn.mCount.compare_exchange_weak(count, count | JobCounter::DependentsFlag, std::memory_order_acq_rel))
+			{
+			}
+
+			if (count >= JobCounter::JobCount)
+			{
+				dependsOn.mDependents.push_back(std::make_pair(job, counter));
+				return;
+			}
+		}
+
+		Queue({ job, counter });
+	}
+
+
+
+
+	void JobSystem::Queue(const QueuedJob& job)
+	{
+		std::uint32_t index = CurrentWorkerIndex();
+		if (index == mWorkers.Size())
+		{
+			index = mNextWorker.fetch_add(1, std::memory_order_relaxed) % mWorkers.Size();
+		}
+
+		//the job is counted before it is pushed, so that the count never drops below the jobs in the deques
+		{
+			std::lock_guard<std::mutex> lock(mWakeMutex);
+			++mQueuedJobCount;
+		}
+
+		Worker& worker = *mWorkers[index];
+		{
+			std::lock_guard<std::mutex> lock(worker.mMutex);
+			worker.mJobs.push_back(job);
+		}
+		mWake.notify_one();
+	}
+
+
+
+
+	void JobSystem::Wait(JobCounter& counter)
+	{
+		std::uint32_t index = CurrentWorkerIndex();
+
+		while (!counter.IsDone())
+		{
+			QueuedJob job;
+			if (TakeJob(index, job))
+			{
+				Execute(job);
+				continue;
+			}
+
+			//the jobs of the group are running elsewhere, so the thread sleeps instead of spinning against them
+			std::unique_lock<std::mutex> lock(mWakeMutex);
+			mWake.wait(lock, [this, &counter]()
+			{
+				return (mQueuedJobCount > 0) || counter.IsDone();
+			});
+		}
+
+		if (counter.mException != nullptr)
+		{
+			std::exception_ptr exception = counter.mException;
+			counter.mException = nullptr;
+			std::rethrow_exception(exception);
+		}
+	}
+
+
+
+
+	void JobSystem::ParallelFor(const std::uint32_t count, const std::uint32_t grainSize, const RangeJob& job)
+	{
+		if (grainSize == 0)
+		{
+			throw std::exception("Grain size must be at least one.");
+		}
+
+		if (count <= grainSize)
+		{
+			job(0, count);
+			return;
+		}
+
+		JobCounter counter;
+		for (std::uint32_t begin = 0; begin < count; begin += grainSize)
+		{
+			std::uint32_t end = ((count - begin) > grainSize) ? (begin + grainSize) : count;
+			Run([&job, begin, end]()
+			{
+				job(begin, end);
+			}, &counter);
+		}
+
+		Wait(counter);
+	}
+
+
+
+
+	std::uint32_t JobSystem::WorkerCount() const
+	{
+		return mWorkers.Size();
+	}
+
+
+
+
+	std::uint32_t JobSystem::DefaultWorkerCount()
+	{
+		std::uint32_t hardwareThreads = std::thread::hardware_concurrency();
+		return (hardwareThreads > 1) ? (hardwareThreads - 1) : 1;
+	}
+
+
+
+
+	void JobSystem::WorkerLoop(const std::uint32_t index)
+	{
+		CurrentWorker.mSystem = this;
+		CurrentWorker.mIndex = index;
+
+		for (;;)
+		{
+			QueuedJob job;
+			if (TakeJob(index, job))
+			{
+				Execute(job);
+				continue;
+			}
+
+			std::unique_lock<std::mutex> lock(mWakeMutex);
+			mWake.wait(lock, [this]()
+			{
+				return (mQueuedJobCount > 0) || mIsStopping;
+			});
+
+			if (mIsStopping && (mQueuedJobCount == 0))
+			{
+				break;
+			}
+		}
+	}
+
+
+
+
+	bool JobSystem::TakeJob(const std::uint32_t index, QueuedJob& job)
+	{
+		std::uint32_t workerCount = mWorkers.Size();
+
+		if (index < workerCount)
+		{
+			Worker& worker = *mWorkers[index];
+			std::lock_guard<std::mutex> lock(worker.mMutex);
+			if (!worker.mJobs.empty())
+			{
+				job = std::move(worker.mJobs.back());
+				worker.mJobs.pop_back();
+				--mQueuedJobCount;
+				return true;
+			}
+		}
+
+		//steal the oldest job of another worker, starting after the calling one so that thieves spread out
+		std::uint32_t first = (index < workerCount) ? (index + 1) : 0;
+		for (std::uint32_t i = 0; i < workerCount; ++i)
+		{
+			Worker& victim = *mWorkers[(first + i) % workerCount];
+			std::lock_guard<std::mutex> lock(victim.mMutex);
+			if (!victim.mJobs.empty())
+			{
+				job = std::move(victim.mJobs.front());
+				victim.mJobs.pop_front();
+				--mQueuedJobCount;
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+
+
+
+	void JobSystem::Execute(QueuedJob& job)
+	{
+		try
+		{
+			job.mJob();
+		}
+		catch (...)
+		{
+			//rethrowing would end the worker thread, and with it the program
+			if (job.mCounter == nullptr)
+			{
+				std::lock_guard<std::mutex> lock(mUnhandledExceptionMutex);
+				if (mUnhandledException == nullptr)
+				{
+					mUnhandledException = std::current_exception();
+				}
+				return;
+			}
+
+			std::lock_guard<std::mutex> lock(job.mCounter->mExceptionMutex);
+			if (job.mCounter->mException == nullptr)
+			{
+				job.mCounter->mException = std::current_exception();
+			}
+		}
+
+		if (job.mCounter != nullptr)
+		{
+			Finish(*job.mCounter);
+		}
+	}
+
+
+
+
+	void JobSystem::Finish(JobCounter& counter)
+	{
+		std::uint32_t count = counter.mCount.fetch_sub(JobCounter::JobCount, std::memory_order_acq_rel);
+		if (count == JobCounter::JobCount)
+		{
+			WakeWaiters();
+			return;
+		}
+
+		if (count != (JobCounter::JobCount | JobCounter::DependentsFlag))
+		{
+			return;
+		}
+
+		std::vector<std::pair<Job, JobCounter*>> dependents;
+		{
+			std::lock_guard<std::mutex> lock(counter.mDependentsMutex);
+			dependents = std::move(counter.mDependents);
+		}
+
+		//clearing the flag is the last use of the counter, since whoever waits on it may destroy it right after
+		counter.mCount.fetch_sub(JobCounter::DependentsFlag, std::memory_order_release);
+		WakeWaiters();
+
+		for (auto& dependent : dependents)
+		{
+			Queue({ dependent.first, dependent.second });
+		}
+	}
+
+
+
+
+	void JobSystem::WakeWaiters()
+	{
+		//the lock orders the wake after the check of a thread that is about to sleep
+		{
+			std::lock_guard<std::mutex> lock(mWakeMutex);
+		}
+		mWake.notify_all();
+	}
+
+
+
+
+	std::exception_ptr JobSystem::TakeUnhandledException()
+	{
+		std::lock_guard<std::mutex> lock(mUnhandledExceptionMutex);
+		std::exception_ptr exception = mUnhandledException;
+		mUnhandledException = nullptr;
+		return exception;
+	}
+
+
+
+
+	std::uint32_t JobSystem::CurrentWorkerIndex() const
+	{
+		return (CurrentWorker.mSystem == this) ? CurrentWorker.mIndex : mWorkers.Size();
+	}
+
+}
\ No newline at end of file
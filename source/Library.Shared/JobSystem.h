@@ -0,0 +1,259 @@
+#pragma once
+
+#include <deque>
+#include <vector>
+#include <functional>
+#include <condition_variable>
+#include "Vector.h"
+
+/**
+*	@brief	The namespace under which the game engine is implemented.
+*/
+namespace FieaGameEngine
+{
+	/**
+	*	@brief	A JobCounter counts the jobs of a group that have not finished yet, so that the group
+	*			can be waited on, or used as a dependency of the jobs that come after it. It also keeps
+	*			the first exception thrown by a job of the group, which is rethrown by Wait. The jobs
+	*			that depend on the group are held by the counter until the group finishes.
+	*/
+	class JobCounter final
+	{
+
+	public:
+
+		/**
+		*	@brief	The default constructor creates a counter with no jobs.
+		*/
+		JobCounter();
+
+		/**
+		*	@brief	The copy constructor is deleted.
+		*/
+		JobCounter(const JobCounter& other) = delete;
+
+		/**
+		*	@brief	The move constructor is deleted.
+		*/
+		JobCounter(JobCounter&& other) = delete;
+
+		/**
+		*	@brief	The copy assignment operator is deleted.
+		*/
+		JobCounter& operator=(const JobCounter& other) = delete;
+
+		/**
+		*	@brief	The move assignment operator is deleted.
+		*/
+		JobCounter& operator=(JobCounter&& other) = delete;
+
+		/**
+		*	@brief	The destructor is defaulted.
+		*/
+		~JobCounter() = default;
+
+		/**
+		*	@brief	Method to check whether all the jobs of the group have finished.
+		*	@return	bool indicating whether the group is done
+		*/
+		bool IsDone() const;
+
+	private:
+
+		friend class JobSystem;		//JobSystem is allowed to count the jobs and record their exceptions
+
+		static const std::uint32_t JobCount = 2;			/**<	What a job adds to the count	*/
+		static const std::uint32_t DependentsFlag = 1;		/**<	The bit of the count that is set while jobs depend on the group	*/
+
+		std::atomic<std::uint32_t> mCount;		/**<	JobCount times the number of jobs that have not finished, plus DependentsFlag while jobs depend on the group	*/
+		std::exception_ptr mException;			/**<	The first exception thrown by a job of the group	*/
+		std::mutex mExceptionMutex;				/**<	The lock for the exception	*/
+		std::vector<std::pair<std::function<void()>, JobCounter*>> mDependents;	/**<	The jobs that wait for the group to finish, with the counters of their own groups	*/
+		std::mutex mDependentsMutex;			/**<	The lock for the dependents	*/
+
+	};
+
+	/**
+	*	@brief	The JobSystem class runs jobs on a fixed set of worker threads. Every worker has its
+	*			own deque of jobs. A worker takes its newest job from the back of its own deque, and
+	*			when that is empty it steals the oldest job from the front of the deque of another
+	*			worker, so that the work spreads out without a single shared queue. A thread that
+	*			waits on a counter runs queued jobs too, which lets jobs wait on the jobs they spawn,
+	*			and only sleeps while there is nothing to run.
+	*/
+	class JobSystem final
+	{
+
+	public:
+
+		typedef std::function<void()> Job;											/**<	A job to be run	*/
+		typedef std::function<void(std::uint32_t, std::uint32_t)> RangeJob;		/**<	A job that works on the range [begin, end) of a loop	*/
+
+		/**
+		*	@brief	Parameterized constructor that starts the workers.
+		*	@param	workerCount the number of worker threads, which defaults to one less than the number
+		*			of hardware threads, since the thread that waits on the jobs helps run them
+		*/
+		explicit JobSystem(const std::uint32_t workerCount = DefaultWorkerCount());
+
+		/**
+		*	@brief	The copy constructor is deleted.
+		*/
+		JobSystem(const JobSystem& other) = delete;
+
+		/**
+		*	@brief	The move constructor is deleted.
+		*/
+		JobSystem(JobSystem&& other) = delete;
+
+		/**
+		*	@brief	The copy assignment operator is deleted.
+		*/
+		JobSystem& operator=(const JobSystem& other) = delete;
+
+		/**
+		*	@brief	The move assignment operator is deleted.
+		*/
+		JobSystem& operator=(JobSystem&& other) = delete;
+
+		/**
+		*	@brief	The destructor finishes the jobs that are queued and stops the workers.
+		*/
+		~JobSystem();
+
+		/**
+		*	@brief	Method to queue a job. A job queued from a worker goes to the deque of that worker,
+		*			other jobs are spread over the workers.
+		*	@param	job the job to be run
+		*	@param	counter the counter of the group that the job belongs to, if any
+		*/
+		void Run(const Job& job, JobCounter* counter = nullptr);
+
+		/**
+		*	@brief	Method to queue a job once all the jobs of another group have finished. The job is
+		*			counted in its own group right away, so waiting on that group also waits for the
+		*			dependency. It still runs if a job of the dependency throws.
+		*	@param	job the job to be run
+		*	@param	counter the counter of the group that the job belongs to, if any
+		*	@param	dependsOn the counter of the group that has to finish first
+		*/
+		void Run(const Job& job, JobCounter* counter, JobCounter& dependsOn);
+
+		/**
+		*	@brief	Method to wait until all the jobs of a group have finished, running queued jobs in
+		*			the meantime. When there is nothing to run, the thread sleeps until a job is queued
+		*			or a group finishes. The first exception thrown by a job of the group is rethrown.
+		*	@param	counter the counter of the group
+		*/
+		void Wait(JobCounter& counter);
+
+		/**
+		*	@brief	Method to run a loop in parallel and wait for it. The loop is cut into ranges of at
+		*			most grainSize iterations, and each range is run as one job.
+		*	@param	count the number of iterations
+		*	@param	grainSize the largest number of iterations in one job
+		*	@param	job the job that runs a range of the loop
+		*/
+		void ParallelFor(const std::uint32_t count, const std::uint32_t grainSize, const RangeJob& job);
+
+		/**
+		*	@brief	Method to take the first exception thrown by a job that belongs to no group since the
+		*			last call. Such a job has no one to rethrow its exception, so it is kept here instead
+		*			of ending the worker thread.
+		*	@return	the exception, or nullptr if no such job threw
+		*/
+		std::exception_ptr TakeUnhandledException();
+
+		/**
+		*	@brief	Method to get the number of worker threads.
+		*	@return	unsigned int representing the number of workers
+		*/
+		std::uint32_t WorkerCount() const;
+
+		/**
+		*	@brief	Static method to get the default number of workers.
+		*	@return	one less than the number of hardware threads, and at least one
+		*/
+		static std::uint32_t DefaultWorkerCount();
+
+	private:
+
+		/**
+		*	@brief	A job in a deque, with the counter of its group.
+		*/
+		struct QueuedJob
+		{
+			Job mJob;					/**<	The job to be run	*/
+			JobCounter* mCounter;		/**<	The counter of the group of the job, if any	*/
+		};
+
+		/**
+		*	@brief	A worker thread and its deque.
+		*/
+		struct Worker
+		{
+			std::deque<QueuedJob> mJobs;		/**<	The jobs of the worker	*/
+			std::mutex mMutex;					/**<	The lock for the deque	*/
+			std::thread mThread;				/**<	The worker thread	*/
+		};
+
+		/**
+		*	@brief	Helper method to push a job that is already counted in its group to a deque.
+		*	@param	job the job to be queued
+		*/
+		void Queue(const QueuedJob& job);
+
+		/**
+		*	@brief	Helper method that a worker thread runs until the system is stopped.
+		*	@param	index the index of the worker
+		*/
+		void WorkerLoop(const std::uint32_t index);
+
+		/**
+		*	@brief	Helper method to take a job, from the back of the deque of the calling worker, or
+		*			from the front of the deque of another worker.
+		*	@param	index the index of the calling worker, or the number of workers for other threads
+		*	@param	job the job that was taken
+		*	@return	bool indicating whether a job was taken
+		*/
+		bool TakeJob(const std::uint32_t index, QueuedJob& job);
+
+		/**
+		*	@brief	Helper method to run a job and count it as finished.
+		*	@param	job the job to be run
+		*/
+		void Execute(QueuedJob& job);
+
+		/**
+		*	@brief	Helper method to count a job of a group as finished. The last job of the group queues
+		*			the jobs that depend on it, and the group is only done once they are taken from it,
+		*			so the counter is not touched after it is done.
+		*	@param	counter the counter of the group
+		*/
+		void Finish(JobCounter& counter);
+
+		/**
+		*	@brief	Helper method to wake the threads that wait on a group, once a group has finished.
+		*/
+		void WakeWaiters();
+
+		/**
+		*	@brief	Helper method to get the index of the calling thread among the workers of this system.
+		*	@return	the index of the worker, or the number of workers if the thread is not one of them
+		*/
+		std::uint32_t CurrentWorkerIndex() const;
+
+		Vector<Worker*> mWorkers;						/**<	The workers	*/
+		std::atomic<std::uint32_t> mQueuedJobCount;		/**<	The number of jobs in all the deques	*/
+		std::atomic<std::uint32_t> mNextWorker;			/**<	The worker that the next job from another thread goes to	*/
+		std::atomic<bool> mIsStopping;					/**<	Whether the workers have been asked to stop	*/
+		std::mutex mWakeMutex;							/**<	The lock that idle workers sleep on	*/
+		std::condition_variable mWake;					/**<	Wakes the idle workers when jobs are queued, and the waiting threads when a group finishes	*/
+
+		std::exception_ptr mUnhandledException;			/**<	The first exception thrown by a job without a group, until it is taken	*/
+
+		std::mutex mUnhandledExceptionMutex;			/**<	The lock for the unhandled exception	*/
+
+	};
+
+}
\ No newline at end of file
@@ -0,0 +1,263 @@
+#include "pch.h"
+#include "ObjectPool.h"
+
+
+namespace FieaGameEngine
+{
+
+	std::atomic<std::uint64_t> ObjectPool::mNextPoolId(1);
+	Vector<ObjectPool*> ObjectPool::mLivePools;
+	std::mutex ObjectPool::mLivePoolsMutex;
+
+
+
+
+	float ObjectPool::Statistics::HitRate() const
+	{
+		if (mAllocations == 0)
+		{
+			return 0.0f;
+		}
+
+		return static_cast<float>(mHits) / static_cast<float>(mAllocations);
+	}
+
+
+
+
+	ObjectPool::ObjectPool(const std::uint32_t blocksPerChunk) : mPoolId(mNextPoolId++), mBlocksPerChunk(blocksPerChunk), mBlockSize(0), mFreeList(nullptr), mUnusedBlocks(nullptr), mUnusedBlockCount(0), mAllocations(0), mHits(0), mDeallocations(0)
+	{
+		if (blocksPerChunk == 0)
+		{
+			throw std::exception("A chunk must have at least one block.");
+		}
+
+		std::lock_guard<std::mutex> lock(mLivePoolsMutex);
+		mLivePools.PushBack(this);
+	}
+
+
+
+
+	ObjectPool::~ObjectPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mLivePoolsMutex);
+			mLivePools.Remove(this);
+		}
+
+		//thread caches that still name the pool are never matched again, since pool ids are not reused
+		for (std::uint32_t i = 0; i < mChunks.Size(); ++i)
+		{
+			::operator delete(mChunks[i]);
+		}
+	}
+
+
+
+
+	void* ObjectPool::Allocate(const size_t size, const size_t alignment)
+	{
+		if (alignment > MaxAlignment)
+		{
+			throw std::exception("Alignment is not supported by the pool.");
+		}
+
+		++mAllocations;
+
+		ThreadCache& cache = GetThreadCache();
+		if (cache.mHead != nullptr)
+		{
+			if (size > mBlockSize)
+			{
+				throw std::exception("Block is too large for the pool.");
+			}
+
+			FreeBlock* block = cache.mHead;
+			cache.mHead = block->mNext;
+			--cache.mCount;
+			++mHits;
+			return block;
+		}
+
+		std::lock_guard<std::mutex> lock(mMutex);
+
+		if (mBlockSize == 0)
+		{
+			//blocks are kept aligned to the largest supported alignment, and big enough to hold the free list link
+			mBlockSize = (std::max)(((size + MaxAlignment - 1) / MaxAlignment) * MaxAlignment, sizeof(FreeBlock));
+		}
+		else if (size > mBlockSize)
+		{
+			throw std::exception("Block is too large for the pool.");
+		}
+
+		if (mFreeList != nullptr)
+		{
+			++mHits;
+			FreeBlock* block = mFreeList;
+			mFreeList = block->mNext;
+			return block;
+		}
+
+		if (mUnusedBlockCount == 0)
+		{
+			AllocateChunk();
+		}
+
+		void* block = mUnusedBlocks;
+		mUnusedBlocks += mBlockSize;
+		--mUnusedBlockCount;
+		return block;
+	}
+
+
+
+
+	void ObjectPool::Deallocate(void* memory)
+	{
+		if (memory == nullptr)
+		{
+			return;
+		}
+
+		++mDeallocations;
+
+		FreeBlock* block = static_cast<FreeBlock*>(memory);
+		ThreadCache& cache = GetThreadCache();
+
+		if (cache.mCount < ThreadCacheCapacity)
+		{
+			block->mNext = cache.mHead;
+			cache.mHead = block;
+			++cache.mCount;
+			return;
+		}
+
+		//the cache is full, so the block and half of the cache go back to the pool for other threads to use
+		FreeBlock* first = block;
+		FreeBlock* last = block;
+		for (std::uint32_t i = 0; i < ThreadCacheCapacity / 2; ++i)
+		{
+			last->mNext = cache.mHead;
+			last = cache.mHead;
+			cache.mHead = cache.mHead->mNext;
+			--cache.mCount;
+		}
+
+		std::lock_guard<std::mutex> lock(mMutex);
+		last->mNext = mFreeList;
+		mFreeList = first;
+	}
+
+
+
+
+	ObjectPool::Statistics ObjectPool::GetStatistics() const
+	{
+		Statistics statistics;
+		statistics.mAllocations = mAllocations;
+		statistics.mHits = mHits;
+		statistics.mDeallocations = mDeallocations;
+
+		std::lock_guard<std::mutex> lock(mMutex);
+		statistics.mChunks = mChunks.Size();
+		statistics.mBlockSize = mBlockSize;
+
+		return statistics;
+	}
+
+
+
+
+	ObjectPool::ThreadCaches::~ThreadCaches()
+	{
+		for (ThreadCache& cache : mCaches)
+		{
+			ReleaseThreadCache(cache);
+		}
+	}
+
+
+
+
+	ObjectPool::ThreadCache& ObjectPool::GetThreadCache() const
+	{
+		static thread_local ThreadCaches threadCaches = {};
+		ThreadCache* caches = threadCaches.mCaches;
+
+		for (std::uint32_t i = 0; i < ThreadCacheSlots; ++i)
+		{
+			if (caches[i].mPoolId == mPoolId)
+			{
+				return caches[i];
+			}
+		}
+
+		std::uint32_t slot = ThreadCacheSlots;
+		for (std::uint32_t i = 0; i < ThreadCacheSlots; ++i)
+		{
+			if (caches[i].mPoolId == 0)
+			{
+				slot = i;
+				break;
+			}
+		}
+
+		if (slot == ThreadCacheSlots)
+		{
+			slot = threadCaches.mNextVictim;
+			threadCaches.mNextVictim = (threadCaches.mNextVictim + 1) % ThreadCacheSlots;
+			ReleaseThreadCache(caches[slot]);
+		}
+
+		caches[slot].mPoolId = mPoolId;
+
+		return caches[slot];
+	}
+
+
+
+
+	void ObjectPool::ReleaseThreadCache(ThreadCache& cache)
+	{
+		if (cache.mHead != nullptr)
+		{
+			std::lock_guard<std::mutex> lock(mLivePoolsMutex);
+			for (std::uint32_t i = 0; i < mLivePools.Size(); ++i)
+			{
+				ObjectPool& pool = *mLivePools[i];
+				if (pool.mPoolId == cache.mPoolId)
+				{
+					FreeBlock* last = cache.mHead;
+					while (last->mNext != nullptr)
+					{
+						last = last->mNext;
+					}
+
+					std::lock_guard<std::mutex> poolLock(pool.mMutex);
+					last->mNext = pool.mFreeList;
+					pool.mFreeList = cache.mHead;
+					break;
+				}
+			}
+		}
+
+		cache.mPoolId = 0;
+		cache.mHead = nullptr;
+		cache.mCount = 0;
+	}
+
+
+
+
+	void ObjectPool::AllocateChunk()
+	{
+		char* chunk = static_cast<char*>(::operator new(mBlockSize * mBlocksPerChunk));
+		mChunks.PushBack(chunk);
+
+		mUnusedBlocks = chunk;
+		mUnusedBlockCount = mBlocksPerChunk;
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,237 @@
+#pragma once
+
+#include <mutex>
+#include <atomic>
+#include "Vector.h"
+#include "IAllocator.h"
+
+/**
+*	@brief	The namespace under which the game engine is implemented.
+*/
+namespace FieaGameEngine
+{
+	/**
+	*	@brief	The ObjectPool class is an allocator that hands out blocks of a single size, which
+	*			makes it a pool for one type of object. The size of the blocks is taken from the
+	*			first allocation. Blocks are carved out of chunks that are only freed with the pool,
+	*			and a block that is given back is put on a free list to be reused by the next
+	*			allocation. Every thread keeps a small cache of free blocks for each pool it uses,
+	*			so that most allocations and deallocations do not have to take the lock of the pool.
+	*/
+	class ObjectPool final : public IAllocator
+	{
+
+	public:
+
+		/**
+		*	@brief	The counters of a pool, used to see how well a pool is recycling its blocks.
+		*/
+		struct Statistics
+		{
+			std::uint64_t mAllocations;			/**<	The number of blocks that were handed out	*/
+			std::uint64_t mHits;				/**<	The number of blocks that were handed out again after being given back	*/
+			std::uint64_t mDeallocations;		/**<	The number of blocks that were given back	*/
+			std::uint32_t mChunks;				/**<	The number of chunks that were allocated	*/
+			size_t mBlockSize;					/**<	The size of the blocks of the pool in bytes	*/
+
+			/**
+			*	@brief	Method to get the fraction of allocations that reused a block.
+			*	@return	float between 0 and 1, 0 if nothing has been allocated
+			*/
+			float HitRate() const;
+		};
+
+		/**
+		*	@brief	Parameterized constructor for the pool.
+		*	@param	blocksPerChunk the number of blocks that are allocated at once when the pool runs out
+		*/
+		explicit ObjectPool(const std::uint32_t blocksPerChunk = 64);
+
+		/**
+		*	@brief	The copy constructor is deleted.
+		*/
+		ObjectPool(const ObjectPool& other) = delete;
+
+		/**
+		*	@brief	The move constructor is deleted.
+		*/
+		ObjectPool(ObjectPool&& other) = delete;
+
+		/**
+		*	@brief	The copy assignment operator is deleted.
+		*/
+		ObjectPool& operator=(const ObjectPool& other) = delete;
+
+		/**
+		*	@brief	The move assignment operator is deleted.
+		*/
+		ObjectPool& operator=(ObjectPool&& other) = delete;
+
+		/**
+		*	@brief	The destructor frees all the chunks. Blocks that are still in use become invalid.
+		*/
+		~ObjectPool();
+
+		/**
+		*	@brief	Method to allocate a block, reusing a free one when there is one.
+		*	@param	size the size of the block in bytes, which must not be larger than the blocks of the pool
+		*	@param	alignment the alignment that the block must have
+		*	@return	pointer to the allocated block
+		*/
+		virtual void* Allocate(const size_t size, const size_t alignment) override;
+
+		/**
+		*	@brief	Method to give a block back to the pool.
+		*	@param	memory pointer to the block
+		*/
+		virtual void Deallocate(void* memory) override;
+
+		/**
+		*	@brief	Method to get the counters of the pool.
+		*	@return	a snapshot of the counters
+		*/
+		Statistics GetStatistics() const;
+
+	private:
+
+		/**
+		*	@brief	A free block, which stores the link to the next free block in itself.
+		*/
+		struct FreeBlock
+		{
+			FreeBlock* mNext;		/**<	The next free block	*/
+		};
+
+		/**
+		*	@brief	The free blocks of one pool that are cached by a thread.
+		*/
+		struct ThreadCache
+		{
+			std::uint64_t mPoolId;		/**<	The id of the pool that the blocks belong to	*/
+			FreeBlock* mHead;			/**<	The first cached block	*/
+			std::uint32_t mCount;		/**<	The number of cached blocks	*/
+		};
+
+		static const std::uint32_t ThreadCacheSlots = 8;			/**<	The number of pools a thread caches blocks for	*/
+
+		/**
+		*	@brief	The caches of a thread. When the thread exits, the cached blocks are given back to
+		*			the pools that are still alive.
+		*/
+		struct ThreadCaches
+		{
+			~ThreadCaches();
+
+			ThreadCache mCaches[ThreadCacheSlots];			/**<	The caches, one for each pool the thread uses	*/
+			std::uint32_t mNextVictim;		/**<	The slot that is claimed next when all of them are in use	*/
+		};
+
+		/**
+		*	@brief	Helper method to get the cache of the calling thread for this pool. A thread only
+		*			caches blocks for a few pools, and claiming a slot for another pool gives the blocks
+		*			that the slot held back to their pool.
+		*	@return	reference to the cache
+		*/
+		ThreadCache& GetThreadCache() const;
+
+		/**
+		*	@brief	Helper method to give the blocks of a thread cache back to its pool, if the pool is
+		*			still alive, and to empty the cache.
+		*	@param	cache the cache to be released
+		*/
+		static void ReleaseThreadCache(ThreadCache& cache);
+
+		/**
+		*	@brief	Helper method to allocate a new chunk, whose blocks are handed out in order before
+		*			the next chunk is allocated. It must be called with the lock of the pool held.
+		*/
+		void AllocateChunk();
+
+		static const std::uint32_t ThreadCacheCapacity = 32;		/**<	The number of blocks a thread caches for one pool	*/
+		static const size_t MaxAlignment = 16;						/**<	The largest alignment the pool supports	*/
+
+		static std::atomic<std::uint64_t> mNextPoolId;		/**<	The id of the next pool, so that thread caches never mistake a new pool for a destroyed one	*/
+		static Vector<ObjectPool*> mLivePools;				/**<	The pools that are alive, which thread caches give their blocks back to	*/
+		static std::mutex mLivePoolsMutex;					/**<	The lock for the list of live pools	*/
+
+		std::uint64_t mPoolId;								/**<	The id of the pool	*/
+		std::uint32_t mBlocksPerChunk;						/**<	The number of blocks in a chunk	*/
+		size_t mBlockSize;									/**<	The size of the blocks, 0 until the first allocation	*/
+		FreeBlock* mFreeList;								/**<	The given back blocks that no thread has cached	*/
+		char* mUnusedBlocks;								/**<	The first block of the last chunk that was never handed out	*/
+		std::uint32_t mUnusedBlockCount;					/**<	The number of blocks of the last chunk that were never handed out	*/
+		Vector<void*> mChunks;								/**<	The chunks that the blocks are carved out of	*/
+		mutable std::mutex mMutex;							/**<	The lock for the free list and the chunks	*/
+
+		std::atomic<std::uint64_t> mAllocations;			/**<	The number of blocks that were handed out	*/
+		std::atomic<std::uint64_t> mHits;					/**<	The number of blocks that were handed out again after being given back	*/
+		std::atomic<std::uint64_t> mDeallocations;			/**<	The number of blocks that were given back	*/
+
+	};
+
+
+
+	/**
+	*	@brief	The PooledAllocator class is a standard library allocator that takes single objects of
+	*			type T from an ObjectPool that is shared by all allocators of T. It lets containers and
+	*			std::allocate_shared recycle their nodes, e.g. the events that are created every frame.
+	*/
+	template <typename T>
+	class PooledAllocator final
+	{
+
+	public:
+
+		typedef T value_type;		/**<	The type of the allocated objects	*/
+
+		/**
+		*	@brief	The default constructor is defaulted.
+		*/
+		PooledAllocator() = default;
+
+		/**
+		*	@brief	Converting constructor, which allocators of the standard library rely on to rebind.
+		*	@param	other the allocator of another type
+		*/
+		template <typename U>
+		PooledAllocator(const PooledAllocator<U>& other);
+
+		/**
+		*	@brief	Method to allocate memory for objects. Single objects come from the pool, arrays
+		*			from the global heap.
+		*	@param	count the number of objects
+		*	@return	pointer to the memory
+		*/
+		T* allocate(const size_t count);
+
+		/**
+		*	@brief	Method to give back memory that was allocated by allocate.
+		*	@param	memory pointer to the memory
+		*	@param	count the number of objects that were allocated
+		*/
+		void deallocate(T* memory, const size_t count);
+
+		/**
+		*	@brief	Method to get the pool that the allocators of T share. The pool is never destroyed,
+		*			so memory may be given back during shutdown.
+		*	@return	reference to the pool
+		*/
+		static ObjectPool& Pool();
+
+		/**
+		*	@brief	All allocators of T share the pool, so they are all equal.
+		*/
+		template <typename U>
+		bool operator==(const PooledAllocator<U>& other) const;
+
+		/**
+		*	@brief	All allocators of T share the pool, so they are all equal.
+		*/
+		template <typename U>
+		bool operator!=(const PooledAllocator<U>& other) const;
+
+	};
+
+}
+
+#include "ObjectPool.inl"
\ No newline at end of file
@@ -0,0 +1,76 @@
+#include "pch.h"
+#include "ObjectPool.h"
+
+namespace FieaGameEngine
+{
+
+	template <typename T>
+	template <typename U>
+	PooledAllocator<T>::PooledAllocator(const PooledAllocator<U>& other)
+	{
+		UNREFERENCED_PARAMETER(other);
+	}
+
+
+
+
+	template <typename T>
+	T* PooledAllocator<T>::allocate(const size_t count)
+	{
+		if (count == 1)
+		{
+			return static_cast<T*>(Pool().Allocate(sizeof(T), alignof(T)));
+		}
+
+		return static_cast<T*>(::operator new(count * sizeof(T)));
+	}
+
+
+
+
+	template <typename T>
+	void PooledAllocator<T>::deallocate(T* memory, const size_t count)
+	{
+		if (count == 1)
+		{
+			Pool().Deallocate(memory);
+		}
+		else
+		{
+			::operator delete(memory);
+		}
+	}
+
+
+
+
+	template <typename T>
+	ObjectPool& PooledAllocator<T>::Pool()
+	{
+		static ObjectPool* sPool = new ObjectPool();
+		return *sPool;
+	}
+
+
+
+
+	template <typename T>
+	template <typename U>
+	bool PooledAllocator<T>::operator==(const PooledAllocator<U>& other) const
+	{
+		UNREFERENCED_PARAMETER(other);
+		return true;
+	}
+
+
+
+
+	template <typename T>
+	template <typename U>
+	bool PooledAllocator<T>::operator!=(const PooledAllocator<U>& other) const
+	{
+		UNREFERENCED_PARAMETER(other);
+		return false;
+	}
+
+}
\ No newline at end of file
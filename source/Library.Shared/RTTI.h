@@ -16,9 +16,83 @@ namespace FieaGameEngine
 	class RTTI
 	{
 	public:
+
+		/**
+		*	@brief	The maximum depth of a type hierarchy that the Ancestry of a type can describe.
+		*/
+		static const std::uint32_t MaxTypeDepth = 16;
+
+		/**
+		*	@brief	The Ancestry of a type lists the ids and names of all the types it derives from,
+		*			ordered from the root of the hierarchy down to the type itself. Every type builds
+		*			its Ancestry once, so that type checks do not have to walk up the hierarchy one
+		*			virtual call at a time.
+		*/
+		struct Ancestry
+		{
+			Ancestry() : mDepth(0)
+			{
+			}
+
+			Ancestry(const Ancestry& parent, const std::uint64_t id, const std::string& name) : Ancestry(parent)
+			{
+				if (mDepth >= MaxTypeDepth)
+				{
+					throw std::exception("Type hierarchy is too deep.");
+				}
+
+				mIds[mDepth] = id;
+				mNames[mDepth] = name;
+				++mDepth;
+			}
+
+			bool Contains(const std::uint64_t id) const
+			{
+				for (std::uint32_t i = mDepth; i > 0; --i)
+				{
+					if (mIds[i - 1] == id)
+					{
+						return true;
+					}
+				}
+
+				return false;
+			}
+
+			bool Contains(const std::string& name) const
+			{
+				for (std::uint32_t i = mDepth; i > 0; --i)
+				{
+					if (mNames[i - 1] == name)
+					{
+						return true;
+					}
+				}
+
+				return false;
+			}
+
+			std::uint64_t mIds[MaxTypeDepth];			/**<	The ids of the types in the hierarchy, the root first	*/
+			std::string mNames[MaxTypeDepth];			/**<	The names of the types in the hierarchy, the root first	*/
+			std::uint32_t mDepth;						/**<	The number of types in the hierarchy	*/
+		};
+
+		static const std::uint32_t sTypeDepth = 0;
+
 		virtual ~RTTI() = default;
 		
 		virtual std::uint64_t TypeIdInstance() const = 0;
+
+		static const Ancestry& ClassAncestry()
+		{
+			static const Ancestry sAncestry;
+			return sAncestry;
+		}
+
+		virtual const Ancestry& InstanceAncestry() const
+		{
+			return ClassAncestry();
+		}
 		
 		virtual RTTI* QueryInterface(const std::uint64_t id) const
 		{
@@ -38,10 +112,27 @@ namespace FieaGameEngine
 			return false;
 		}
 
+		/**
+		*	@brief	Constant time type check. Prefer it to Is(id) when the type is known at compile time,
+		*			since Is(id) has to search the hierarchy for an id whose depth it does not know.
+		*/
+		template <typename T>
+		bool Is() const
+		{
+			return (As<T>() != nullptr);
+		}
+
+		/**
+		*	@brief	Constant time checked cast. The depth of T in its hierarchy is known at compile time,
+		*			so the check takes a single virtual call and a compare.
+		*/
 		template <typename T>
 		T* As() const
 		{
-			if (Is(T::TypeIdClass()))
+			static_assert(T::sTypeDepth > 0, "As needs a type that is declared with RTTI_DECLARATIONS.");
+
+			const Ancestry& ancestry = InstanceAncestry();
+			if ((ancestry.mDepth >= T::sTypeDepth) && (ancestry.mIds[T::sTypeDepth - 1] == T::TypeIdClass()))
 			{
 				return (T*)this;
 			}
@@ -63,29 +154,31 @@ namespace FieaGameEngine
 #define RTTI_DECLARATIONS(Type, ParentType)																	 \
 		public:                                                                                              \
 			typedef ParentType Parent;                                                                       \
+			static const std::uint32_t sTypeDepth = Parent::sTypeDepth + 1;                                  \
 			static std::string TypeName() { return std::string(#Type); }                                     \
-			static std::uint64_t TypeIdClass() { return sRunTimeTypeId; }                                    \
+			static std::uint64_t TypeIdClass() { return reinterpret_cast<std::uint64_t>(&sRunTimeTypeId); }  \
 			virtual std::uint64_t TypeIdInstance() const override { return Type::TypeIdClass(); }            \
+			static const FieaGameEngine::RTTI::Ancestry& ClassAncestry()                                     \
+			{                                                                                                \
+				static const FieaGameEngine::RTTI::Ancestry sAncestry(Parent::ClassAncestry(), TypeIdClass(), TypeName()); \
+				return sAncestry;                                                                            \
+			}                                                                                                \
+			virtual const FieaGameEngine::RTTI::Ancestry& InstanceAncestry() const override                  \
+			{                                                                                                \
+				return ClassAncestry();                                                                      \
+			}                                                                                                \
 			virtual FieaGameEngine::RTTI* QueryInterface(const std::uint64_t id) const override                     \
             {                                                                                                \
-                if (id == sRunTimeTypeId)                                                                    \
-					{ return (RTTI*)this; }                                                                  \
-                else                                                                                         \
-					{ return Parent::QueryInterface(id); }                                                   \
+				return (ClassAncestry().Contains(id) ? (RTTI*)this : nullptr);                               \
             }                                                                                                \
+			using FieaGameEngine::RTTI::Is;                                                                  \
 			virtual bool Is(std::uint64_t id) const override                                                 \
 			{                                                                                                \
-				if (id == sRunTimeTypeId)                                                                    \
-					{ return true; }                                                                         \
-				else                                                                                         \
-					{ return Parent::Is(id); }                                                               \
+				return ClassAncestry().Contains(id);                                                         \
 			}                                                                                                \
 			virtual bool Is(const std::string& name) const override                                          \
 			{                                                                                                \
-				if (name == TypeName())                                                                      \
-					{ return true; }                                                                         \
-				else                                                                                         \
-					{ return Parent::Is(name); }                                                             \
+				return ClassAncestry().Contains(name);                                                       \
 			}                                                                                                \
 			private:                                                                                         \
 				static std::uint64_t sRunTimeTypeId;
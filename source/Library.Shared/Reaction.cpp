@@ -54,4 +54,11 @@ namespace FieaGameEngine
 		return *this;
 	}
 
+
+
+
+	void Reaction::Resubscribe()
+	{
+	}
+
 }
\ No newline at end of file
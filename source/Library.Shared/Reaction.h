@@ -61,6 +61,14 @@ namespace FieaGameEngine
 		*/
 		~Reaction() = default;
 
+		/**
+		*	@brief	Method that moves the subscriptions of the reaction over to what its attributes say,
+		*			in case the attributes were written to directly rather than through the reaction.
+		*			The world calls it on its reactions before it delivers events. By default it does
+		*			nothing.
+		*/
+		virtual void Resubscribe();
+
 	private:
 
 	};
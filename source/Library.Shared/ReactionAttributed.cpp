@@ -8,26 +8,28 @@ namespace FieaGameEngine
 
 	RTTI_DEFINITIONS(ReactionAttributed)
 
-	ReactionAttributed::ReactionAttributed(const std::string& name, const std::string& subType) : Reaction::Reaction(name), mSubType(subType)
+	ReactionAttributed::ReactionAttributed(const std::string& name, const std::string& subType) : Reaction::Reaction(name), mSubType(subType), mRoute(subType)
 	{
-		InitializeAttributes();
-		Event<EventMessageAttributed>::Subscribe(*this);
+		InitializePrescribedAttributes();
+		Event<EventMessageAttributed>::Subscribe(*this, mRoute);
 	}
 
 
 
 
-	ReactionAttributed::ReactionAttributed(const ReactionAttributed& other) : Reaction::Reaction(other), mSubType(other.mSubType)
+	ReactionAttributed::ReactionAttributed(const ReactionAttributed& other) : Reaction::Reaction(other), mSubType(other.mSubType), mRoute(other.mSubType)
 	{
 		UpdatePrescribedAttributes();
+		Event<EventMessageAttributed>::Subscribe(*this, mRoute);
 	}
 
 
 
 
-	ReactionAttributed::ReactionAttributed(ReactionAttributed&& other) : Reaction::Reaction(std::move(other)), mSubType(std::move(other.mSubType))
+	ReactionAttributed::ReactionAttributed(ReactionAttributed&& other) : Reaction::Reaction(std::move(other)), mSubType(std::move(other.mSubType)), mRoute(mSubType)
 	{
 		UpdatePrescribedAttributes();
+		Event<EventMessageAttributed>::Subscribe(*this, mRoute);
 	}
 
 
@@ -40,6 +42,7 @@ namespace FieaGameEngine
 			Reaction::operator=(other);
 			mSubType = other.mSubType;
 			UpdatePrescribedAttributes();
+			Resubscribe();
 		}
 
 		return *this;
@@ -53,6 +56,7 @@ namespace FieaGameEngine
 			Reaction::operator=(std::move(other));
 			mSubType = std::move(other.mSubType);
 			UpdatePrescribedAttributes();
+			Resubscribe();
 		}
 
 		return *this;
@@ -63,7 +67,7 @@ namespace FieaGameEngine
 
 	ReactionAttributed::~ReactionAttributed()
 	{
-		Event<EventMessageAttributed>::Unsubscribe(*this);
+		Event<EventMessageAttributed>::Unsubscribe(*this, mRoute);
 	}
 
 
@@ -81,6 +85,7 @@ namespace FieaGameEngine
 	{
 		mSubType = subType;
 		UpdatePrescribedAttributes();
+		Resubscribe();
 	}
 
 
@@ -104,43 +109,56 @@ namespace FieaGameEngine
 
 	void ReactionAttributed::Notify(const IEventPublisher& publisher)
 	{
-		assert(publisher.Is(FieaGameEngine::Event<EventMessageAttributed>::TypeIdClass()));
-		auto& mMessage = (&publisher)->As<Event<EventMessageAttributed>>()->Message();
+		Notify(publisher, 0);
+	}
+
 
-		auto Attributes = mMessage.GetAttributes();
 
-		for (auto& attribute : Attributes)
+
+	void ReactionAttributed::Notify(const IEventPublisher& publisher, const std::uint32_t subscriberIndex)
+	{
+		assert(publisher.Is<FieaGameEngine::Event<EventMessageAttributed>>());
+		auto& mMessage = (&publisher)->As<Event<EventMessageAttributed>>()->Message();
+
+		//the arguments are only copied for a reaction that runs
+		if (mMessage.GetSubType() == mSubType)
 		{
-			if (!mMessage.IsPrescribedAttribute(attribute->first))
+			for (auto& attribute : mMessage.GetAuxiliaryAttributes())
 			{
 				auto& datum = Append(attribute->first);
 				datum = attribute->second;
 			}
-		}
 
-		if (mMessage.GetSubType() == mSubType)
-		{
-			Update(mMessage.GetWorld()->GetWorldState());
+			//the reactions to an event may run on several threads at once, so each gets its own world state
+			WorldState worldState = mMessage.GetWorld()->GetWorldState().Fork();
+			worldState.EventSequence = publisher.Sequence();
+			worldState.SubscriberIndex = subscriberIndex;
+			Update(worldState);
 		}
 	}
 
 
 
 
-	void ReactionAttributed::InitializeAttributes()
+	void ReactionAttributed::Resubscribe()
 	{
-		AddToPrescribedAttributes("Name");
-		AddExternalPrescribedAttribute("SubType", &mSubType, 1);
-		Append("this") = static_cast<RTTI*>(this);
-		AddToPrescribedAttributes("this");
+		if (mRoute != mSubType)
+		{
+			Event<EventMessageAttributed>::Unsubscribe(*this, mRoute);
+			mRoute = mSubType;
+			Event<EventMessageAttributed>::Subscribe(*this, mRoute);
+		}
 	}
 
 
 
 
-	void ReactionAttributed::UpdatePrescribedAttributes()
+	void ReactionAttributed::InitializeAttributes()
 	{
-		(*this)["SubType"].SetStorage(&mSubType, 1);
+		AddToPrescribedAttributes("Name");
+		AddExternalPrescribedAttribute("SubType", &ReactionAttributed::mSubType);
+		Append("this") = static_cast<RTTI*>(this);
+		AddToPrescribedAttributes("this");
 	}
 
 }
\ No newline at end of file
@@ -11,8 +11,9 @@ namespace FieaGameEngine
 {
 	/**
 	*	@brief	The ReactionAttributed class derives from the Reaction interface. It is used
-	*			to register to events of type EventMessageAttributed. It has its own associated
-	*			factory.
+	*			to register to events of type EventMessageAttributed. It subscribes under its
+	*			subtype, so it is only notified of messages of that subtype. It has its own
+	*			associated factory.
 	*/
 	class ReactionAttributed : public Reaction
 	{
@@ -23,7 +24,7 @@ namespace FieaGameEngine
 
 		/**
 		*	@brief	Parameterized constructor for the ReactionAttributed class. It also
-		*			subscribes to events of type eventMessageAttributed.
+		*			subscribes to events of type eventMessageAttributed with its subtype.
 		*	@param	name the name of the reaction
 		*	@param	subType the subType that this ReactionAttributed can subscribe to
 		*/
@@ -70,7 +71,10 @@ namespace FieaGameEngine
 		std::string GetSubType() const;
 
 		/**
-		*	@brief	Method that sets the subtype that this reaction subscribes to.
+		*	@brief	Method that sets the subtype that this reaction subscribes to, and moves the
+		*			subscription over to it. When the subtype is written through its attribute instead,
+		*			e.g. by a command, the subscription moves when Resubscribe is called, which the
+		*			world does before it delivers events.
 		*	@param	subType string that represents the subtype
 		*/
 		void SetSubType(const std::string& subType);
@@ -88,13 +92,23 @@ namespace FieaGameEngine
 		virtual Scope* Clone() override;
 
 		/**
-		*	@brief	Method that is called when the corresponding event is raised.
-		*			Copies over all auxiliary attributes from the payload of the event
-		*			and then calls Update.
+		*	@brief	Method that is called when the corresponding event is raised. If the
+		*			subtype of the message matches, copies over all auxiliary attributes
+		*			from the payload of the event and then calls Update.
 		*	@param	publisher the event that was raised.
 		*/
 		virtual void Notify(const IEventPublisher& publisher) override;
 
+		/**
+		*	@brief	Method that is called when the corresponding event is delivered. It does what Notify
+		*			does, in a world state of its own that records the event and the position of this
+		*			reaction among its subscribers, so that the commands it records are applied in the
+		*			same order whichever thread it runs on.
+		*	@param	publisher the event that was raised.
+		*	@param	subscriberIndex the position of this reaction in the delivery of the event
+		*/
+		virtual void Notify(const IEventPublisher& publisher, const std::uint32_t subscriberIndex) override;
+
 		/**
 		*	@brief	Method to initialize the attributes of the class.
 		*			Overriden from the Attributed class.
@@ -102,14 +116,15 @@ namespace FieaGameEngine
 		virtual void InitializeAttributes() override;
 
 		/**
-		*	@brief	Method to update the list of prescribed attributes whenever
-		*			the list is reinitialized. Overriden from the Attributed class.
+		*	@brief	Method that moves the subscription over to the subtype, if the subtype attribute
+		*			was written to since the reaction last subscribed. Overriden from the Reaction class.
 		*/
-		virtual void UpdatePrescribedAttributes() override;
+		virtual void Resubscribe() override;
 
 	private:
 
 		std::string mSubType;		/**<	String that represents the SubType	*/
+		std::string mRoute;			/**<	The subtype that the reaction is subscribed under	*/
 
 	};
 
@@ -1,20 +1,31 @@
 #include "pch.h"
 #include "Scope.h"
+#include "Writer.h"
 
 namespace FieaGameEngine
 {
 	RTTI_DEFINITIONS(Scope);
 
+	std::atomic<std::uint64_t> Scope::mChangeClock(1);
+
 
 	std::string Scope::ToString() const
 	{
-		std::string tempString;
+		Writer writer;
+		Write(writer);
+		return writer.Buffer();
+	}
+
+	void Scope::Write(Writer& writer) const
+	{
 		for (std::uint32_t i = 0; i < mPointersToLookupTable.Size(); ++i)
 		{
-			tempString.append(mPointersToLookupTable[i]->second.ToString());
+			const Datum& datum = mPointersToLookupTable[i]->second;
+			if (datum.Size() > 0)
+			{
+				datum.Write(writer);
+			}
 		}
-
-		return tempString;
 	}
 
 	bool Scope::Equals(const RTTI* rhs) const
@@ -42,14 +53,14 @@ namespace FieaGameEngine
 
 
 
-	Scope::Scope() : mParent(nullptr), mLookupTable(), mPointersToLookupTable()
+	Scope::Scope() : mParent(nullptr), mLookupTable(), mPointersToLookupTable(), mHash(0), mHashState(0), mChangeStamp(mChangeClock.load(std::memory_order_relaxed))
 	{
 	}
 
 
 
 
-	Scope::Scope(const Scope& other) : mParent(nullptr), mLookupTable(other.mLookupTable.NumberOfBuckets()), mPointersToLookupTable()
+	Scope::Scope(const Scope& other) : mParent(nullptr), mLookupTable(other.mLookupTable.NumberOfBuckets()), mPointersToLookupTable(), mHash(0), mHashState(0), mChangeStamp(mChangeClock.load(std::memory_order_relaxed))
 	{
 		DeepCopy(other);
 	}
@@ -57,7 +68,7 @@ namespace FieaGameEngine
 
 
 
-	Scope::Scope(Scope&& other) : mParent(nullptr), mLookupTable(std::move(other.mLookupTable)), mPointersToLookupTable(std::move(other.mPointersToLookupTable))
+	Scope::Scope(Scope&& other) : mParent(nullptr), mLookupTable(std::move(other.mLookupTable)), mPointersToLookupTable(std::move(other.mPointersToLookupTable)), mHash(0), mHashState(0), mChangeStamp(mChangeClock.load(std::memory_order_relaxed))
 	{
 		std::string name;
 
@@ -72,7 +83,7 @@ namespace FieaGameEngine
 
 
 
-	Scope::Scope(const std::uint32_t& capacity) : mParent(nullptr), mLookupTable(capacity), mPointersToLookupTable(capacity)
+	Scope::Scope(const std::uint32_t& capacity) : mParent(nullptr), mLookupTable(capacity), mPointersToLookupTable(capacity), mHash(0), mHashState(0), mChangeStamp(mChangeClock.load(std::memory_order_relaxed))
 	{
 	}
 
@@ -130,20 +141,26 @@ namespace FieaGameEngine
 
 	void Scope::DeepCopy(const Scope& other)
 	{
+		//the keys in other are already unique and this scope is empty, so the lookup in Insert can be skipped
 		mPointersToLookupTable.Reserve(other.mPointersToLookupTable.Size());
 		for (std::uint32_t i = 0; i < other.mPointersToLookupTable.Size(); ++i)
 		{
-			if (other.mPointersToLookupTable[i]->second.Type() == EDatumType::ETable)
+			const Datum& otherDatum = other.mPointersToLookupTable[i]->second;
+
+			if (otherDatum.Type() == EDatumType::ETable)
 			{
-				for (std::uint32_t j = 0; j < other.mPointersToLookupTable[i]->second.Size(); ++j)
+				LookupTableEntry& entry = AppendUnique(other.mPointersToLookupTable[i]->first, Datum());
+
+				entry.second.SetType(EDatumType::ETable);
+				entry.second.Reserve(otherDatum.Size());
+				for (std::uint32_t j = 0; j < otherDatum.Size(); ++j)
 				{
-					Scope* scope = other.mPointersToLookupTable[i]->second[j].Clone();
-					Adopt(*scope, other.mPointersToLookupTable[i]->first);
+					Adopt(*otherDatum[j].Clone(), entry.first);
 				}
 			}
 			else
 			{
-				mPointersToLookupTable.PushBack(&(*mLookupTable.Insert(std::make_pair(other.mPointersToLookupTable[i]->first, other.mPointersToLookupTable[i]->second))));
+				AppendUnique(other.mPointersToLookupTable[i]->first, otherDatum);
 			}
 		}
 	}
@@ -156,6 +173,7 @@ namespace FieaGameEngine
 		for (std::uint32_t i = 0; i < mPointersToLookupTable.Size(); ++i)
 		{
 			auto& pointerToLookupTableElement = mPointersToLookupTable[i];
+			pointerToLookupTableElement->second.mOwner = this;
 
 			if (pointerToLookupTableElement->second.Type() == EDatumType::ETable)
 			{
@@ -174,6 +192,7 @@ namespace FieaGameEngine
 		}
 
 		other.Clear();
+		MarkChanged();
 	}
 
 
@@ -289,6 +308,8 @@ namespace FieaGameEngine
 		if (wasInserted)
 		{
 			mPointersToLookupTable.PushBack(&(*it));
+			(*it).second.mOwner = this;
+			MarkChanged();
 		}
 
 		return (*it).second;
@@ -333,6 +354,7 @@ namespace FieaGameEngine
 		datum.PushBack(&childToAdopt);
 
 		childToAdopt.mParent = this;
+		OnChildAdopted(childToAdopt, key);
 	}
 
 
@@ -369,7 +391,35 @@ namespace FieaGameEngine
 
 	bool Scope::operator==(const Scope& other) const
 	{
-		return (mLookupTable == other.mLookupTable);
+		if (mPointersToLookupTable.Size() != other.mPointersToLookupTable.Size())
+		{
+			return false;
+		}
+
+		//the Datums whose hash is not cached are only hashed on the outermost level, since hashing it again for every nested Scope whose contents are compared would make the comparison quadratic in the depth
+		static thread_local std::uint32_t depth = 0;
+
+		bool hasUncachedDatums;
+		bool otherHasUncachedDatums;
+		std::uint64_t hash = CachedHash(hasUncachedDatums);
+		std::uint64_t otherHash = other.CachedHash(otherHasUncachedDatums);
+		if (!hasUncachedDatums && !otherHasUncachedDatums)
+		{
+			if (hash != otherHash)
+			{
+				return false;
+			}
+		}
+		else if ((depth == 0) && (Hash() != other.Hash()))
+		{
+			return false;
+		}
+
+		++depth;
+		bool isEqual = (mLookupTable == other.mLookupTable);
+		--depth;
+
+		return isEqual;
 	}
 
 
@@ -385,7 +435,7 @@ namespace FieaGameEngine
 
 	bool Scope::CompareStructure(const Scope& other) const
 	{
-		if (mPointersToLookupTable.Size() == other.mPointersToLookupTable.Size())
+		if ((mPointersToLookupTable.Size() == other.mPointersToLookupTable.Size()) && (Hash() == other.Hash()))
 		{
 			auto i = mPointersToLookupTable.begin();
 			auto j = other.mPointersToLookupTable.begin();
@@ -491,6 +541,7 @@ namespace FieaGameEngine
 		name = FindContainedScope(child, datum, index);
 		datum->RemoveByIndex(index);
 		child.mParent = nullptr;
+		OnChildOrphaned(child);
 	}
 
 
@@ -511,6 +562,7 @@ namespace FieaGameEngine
 				for (std::uint32_t j = 0; j < datum.Size(); ++j)
 				{
 					datum.Get<Scope*>(j)->mParent = nullptr;
+					OnChildOrphaned(*datum.Get<Scope*>(j));
 					delete datum.Get<Scope*>(j);
 
 				}
@@ -519,6 +571,218 @@ namespace FieaGameEngine
 		
 		mLookupTable.Clear();
 		mPointersToLookupTable.Clear();
+		MarkChanged();
+	}
+
+
+
+
+	std::uint64_t Scope::Hash() const
+	{
+		//the entries are summed up, so the hash does not depend on the order of insertion, just like operator==
+		bool hasUncachedDatums;
+		std::uint64_t hash = CachedHash(hasUncachedDatums);
+		if (hasUncachedDatums)
+		{
+			hash += UncachedHash();
+		}
+
+		return Datum::MixHash(hash + mPointersToLookupTable.Size());
+	}
+
+
+
+
+	void Scope::MarkChanged()
+	{
+		std::uint64_t stamp = mChangeClock.load(std::memory_order_relaxed);
+
+		//once an ancestor is already stale with the current stamp, everything above it is too, unless a thread is hashing it right now
+		for (Scope* scope = this; scope != nullptr; scope = scope->mParent)
+		{
+			std::uint64_t state = scope->mHashState.load(std::memory_order_relaxed);
+			if (((state & (HashValidFlag | HashWritingFlag)) == 0) && (scope->mChangeStamp.load(std::memory_order_relaxed) == stamp))
+			{
+				break;
+			}
+
+			//advancing the generation keeps a thread that is hashing the Scope from marking its result valid
+			while (!scope->mHashState.compare_exchange_weak(state, (((state & ~(HashGenerationStep - 1)) + HashGenerationStep) | (state & HashWritingFlag)), std::memory_order_release, std::memory_order_relaxed))
+			{
+			}
+
+			scope->mChangeStamp.store(stamp, std::memory_order_relaxed);
+		}
+	}
+
+
+
+
+	std::uint64_t Scope::CachedHash(bool& hasUncachedDatums) const
+	{
+		std::uint64_t state = mHashState.load(std::memory_order_acquire);
+		if ((state & HashValidFlag) != 0)
+		{
+			std::uint64_t hash = mHash.load(std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (mHashState.load(std::memory_order_relaxed) == state)
+			{
+				hasUncachedDatums = ((state & HashUncachedFlag) != 0);
+				return hash;
+			}
+
+			state = mHashState.load(std::memory_order_acquire);
+		}
+
+		//only one thread writes mHash at a time, and the others hash without caching the result
+		bool isWriter = (((state & (HashValidFlag | HashWritingFlag)) == 0) && mHashState.compare_exchange_strong(state, (state | HashWritingFlag), std::memory_order_acquire, std::memory_order_relaxed));
+
+		std::uint64_t hash = 0;
+		hasUncachedDatums = false;
+		for (std::uint32_t i = 0; i < mPointersToLookupTable.Size(); ++i)
+		{
+			const LookupTableEntry& entry = *mPointersToLookupTable[i];
+			if (entry.second.Type() == EDatumType::ETable)
+			{
+				std::uint64_t factor = NestedHashFactor(entry.first);
+				hash += Datum::MixHash(factor ^ entry.second.Size());
+				for (std::uint32_t j = 0; j < entry.second.Size(); ++j)
+				{
+					const Scope* scope = entry.second.Get<Scope*>(j);
+					if (scope != nullptr)
+					{
+						bool nestedHasUncachedDatums;
+						hash += factor * (scope->CachedHash(nestedHasUncachedDatums) + scope->mPointersToLookupTable.Size());
+						hasUncachedDatums = (hasUncachedDatums || nestedHasUncachedDatums);
+					}
+				}
+			}
+			else if (!IsHashCached(entry.second))
+			{
+				hasUncachedDatums = true;
+			}
+			else
+			{
+				hash += EntryHash(entry);
+			}
+		}
+
+		if (isWriter)
+		{
+			std::atomic_thread_fence(std::memory_order_release);
+			mHash.store(hash, std::memory_order_relaxed);
+
+			//a change made while hashing advanced the generation, in which case the result is not marked valid
+			std::uint64_t writing = (state | HashWritingFlag);
+			std::uint64_t valid = (state | HashValidFlag | (hasUncachedDatums ? HashUncachedFlag : 0));
+			std::uint64_t current = writing;
+			while (!mHashState.compare_exchange_weak(current, ((current == writing) ? valid : (current & ~HashWritingFlag)), std::memory_order_release, std::memory_order_relaxed))
+			{
+			}
+		}
+
+		return hash;
+	}
+
+
+
+
+	std::uint64_t Scope::UncachedHash() const
+	{
+		std::uint64_t hash = 0;
+		for (std::uint32_t i = 0; i < mPointersToLookupTable.Size(); ++i)
+		{
+			const LookupTableEntry& entry = *mPointersToLookupTable[i];
+			if (entry.second.Type() == EDatumType::ETable)
+			{
+				std::uint64_t factor = 0;
+				for (std::uint32_t j = 0; j < entry.second.Size(); ++j)
+				{
+					const Scope* scope = entry.second.Get<Scope*>(j);
+					bool nestedHasUncachedDatums = false;
+					if (scope != nullptr)
+					{
+						scope->CachedHash(nestedHasUncachedDatums);
+					}
+
+					if (nestedHasUncachedDatums)
+					{
+						if (factor == 0)
+						{
+							factor = NestedHashFactor(entry.first);
+						}
+
+						hash += factor * scope->UncachedHash();
+					}
+				}
+			}
+			else if (!IsHashCached(entry.second))
+			{
+				hash += EntryHash(entry);
+			}
+		}
+
+		return hash;
+	}
+
+
+
+
+	std::uint64_t Scope::EntryHash(const LookupTableEntry& entry)
+	{
+		return Datum::MixHash(Datum::HashBytes(entry.first.c_str(), entry.first.size()) ^ entry.second.Hash());
+	}
+
+
+
+
+	bool Scope::IsHashCached(const Datum& datum)
+	{
+		return (!datum.IsExternalStorage() && !datum.mIsExposed);
+	}
+
+
+
+
+	std::uint64_t Scope::NestedHashFactor(const std::string& key)
+	{
+		return (Datum::MixHash(Datum::HashBytes(key.c_str(), key.size())) | 1);
+	}
+
+
+
+
+	std::uint64_t Scope::ChangeStamp() const
+	{
+		return mChangeStamp.load(std::memory_order_relaxed);
+	}
+
+
+
+
+	bool Scope::HasChangedSince(const std::uint64_t stamp) const
+	{
+		return (mChangeStamp.load(std::memory_order_relaxed) > stamp);
+	}
+
+
+
+
+	std::uint64_t Scope::TakeChangeStamp()
+	{
+		return mChangeClock.fetch_add(1, std::memory_order_relaxed);
+	}
+
+
+
+
+	Scope::LookupTableEntry& Scope::AppendUnique(const std::string& key, const Datum& datum)
+	{
+		LookupTableEntry& entry = *mLookupTable.InsertUnique(std::make_pair(key, datum));
+		mPointersToLookupTable.PushBack(&entry);
+		entry.second.mOwner = this;
+		MarkChanged();
+		return entry;
 	}
 
 
@@ -529,4 +793,89 @@ namespace FieaGameEngine
 		Clear();
 	}
 
+
+
+
+	void Scope::OnChildAdopted(Scope& child, const std::string& key)
+	{
+		UNREFERENCED_PARAMETER(child);
+		UNREFERENCED_PARAMETER(key);
+	}
+
+
+
+
+	void Scope::OnChildOrphaned(Scope& child)
+	{
+		UNREFERENCED_PARAMETER(child);
+	}
+
+
+
+
+	void* Scope::operator new(size_t size)
+	{
+		char* block = static_cast<char*>(::operator new(AllocationHeaderSize + size));
+		*reinterpret_cast<IAllocator**>(block) = nullptr;
+		return block + AllocationHeaderSize;
+	}
+
+
+
+
+	void* Scope::operator new(size_t size, IAllocator& allocator)
+	{
+		char* block = static_cast<char*>(allocator.Allocate(AllocationHeaderSize + size, AllocationHeaderSize));
+		*reinterpret_cast<IAllocator**>(block) = &allocator;
+		return block + AllocationHeaderSize;
+	}
+
+
+
+
+	void* Scope::operator new(size_t size, void* memory)
+	{
+		UNREFERENCED_PARAMETER(size);
+		return memory;
+	}
+
+
+
+
+	void Scope::operator delete(void* memory)
+	{
+		if (memory == nullptr)
+		{
+			return;
+		}
+
+		char* block = static_cast<char*>(memory) - AllocationHeaderSize;
+		IAllocator* allocator = *reinterpret_cast<IAllocator**>(block);
+		if (allocator != nullptr)
+		{
+			allocator->Deallocate(block);
+		}
+		else
+		{
+			::operator delete(block);
+		}
+	}
+
+
+
+
+	void Scope::operator delete(void* memory, IAllocator& allocator)
+	{
+		allocator.Deallocate(static_cast<char*>(memory) - AllocationHeaderSize);
+	}
+
+
+
+
+	void Scope::operator delete(void* memory, void* place)
+	{
+		UNREFERENCED_PARAMETER(memory);
+		UNREFERENCED_PARAMETER(place);
+	}
+
 }
\ No newline at end of file
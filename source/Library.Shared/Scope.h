@@ -4,12 +4,16 @@
 #include "Vector.h"
 #include "HashMap.h"
 #include "Datum.h"
+#include "IAllocator.h"
 
 /**
 *	@brief	The namespace under which the game engine is implemented.
 */
 namespace FieaGameEngine
 {
+	class ScopePrototype;		//forward declaration for the ScopePrototype class.
+	class Writer;				//forward declaration for the Writer class.
+
 	/**
 	*	@brief	The class is implementation of a Scope, which is a
 	*			table that creates a dictionary of name-value pairs
@@ -23,6 +27,8 @@ namespace FieaGameEngine
 	{
 		RTTI_DECLARATIONS(Scope, RTTI)
 
+		friend class ScopePrototype;		//ScopePrototype is allowed to build Scopes directly from its compiled layout
+
 	public:
 
 		typedef std::pair<std::string, Datum> LookupTableEntry;			/**<	the string-Datum pair is typedef'd for more readability	*/
@@ -33,6 +39,15 @@ namespace FieaGameEngine
 		*/
 		virtual std::string ToString() const override;
 
+		/**
+		*	@brief	Method that writes the contents of the Scope, including nested Scopes, to a Writer.
+		*			This is what ToString uses, and writing to a reusable Writer or straight to a stream
+		*			avoids building a string for every Datum. Like ToString, the first element of every
+		*			Datum is written, in order of insertion, and empty Datums are skipped.
+		*	@param	writer the Writer to write to
+		*/
+		virtual void Write(Writer& writer) const;
+
 		/**
 		*	@brief	Method to compare two Scopes by overriding the method
 		*			defined in RTTI, which Scope inherits from.
@@ -205,6 +220,9 @@ namespace FieaGameEngine
 		/**
 		*	@brief	The comparison operator is overloaded to compare the contents of two Scopes. It is important to
 		*			note that the structure is not compared. Only the contents are. (returns true if equal)
+		*			Scopes of different sizes or hashes are rejected without comparing their contents. The
+		*			Datums whose hash is not cached are only hashed for the outermost pair of Scopes, the nested
+		*			ones are compared by their cached hashes whenever those cover all of their contents.
 		*	@param	other const reference to the Scope to be compared
 		*	@return	bool indicating whether the two Scopes are equal
 		*/
@@ -225,6 +243,45 @@ namespace FieaGameEngine
 		*/
 		bool CompareStructure(const Scope& other) const;
 
+		/**
+		*	@brief	Method to get a 64-bit hash of the contents of the Scope and everything nested in it. Equal
+		*			Scopes always have equal hashes. The hash of the Datums with internal storage, including
+		*			those of the nested Scopes, is cached, and any change made through them marks it stale
+		*			along with the caches of all ancestors. Datums with external storage, such as the members
+		*			that an Attributed type binds, and Datums whose elements Get handed out references to can
+		*			be written without going through the Datum, so they are the only part that is hashed on
+		*			every call.
+		*	@return	unsigned 64-bit integer representing the contents of the Scope
+		*/
+		std::uint64_t Hash() const;
+
+		/**
+		*	@brief	Method that marks this Scope and all of its ancestors as changed, which makes their hashes
+		*			stale and stamps them with the current change stamp.
+		*/
+		void MarkChanged();
+
+		/**
+		*	@brief	Method to get the stamp of the last change made to this Scope or to anything nested in it.
+		*	@return	unsigned 64-bit integer representing the stamp of the last change
+		*/
+		std::uint64_t ChangeStamp() const;
+
+		/**
+		*	@brief	Method to check whether this Scope or anything nested in it has changed after a given stamp
+		*			was taken. This is meant for checks like "has this subtree changed since frame N".
+		*	@param	stamp the stamp returned by TakeChangeStamp at the point of interest
+		*	@return	bool indicating whether there was a change after the stamp was taken
+		*/
+		bool HasChangedSince(const std::uint64_t stamp) const;
+
+		/**
+		*	@brief	Method to take a stamp of the current point in time, such as the start of a frame. Changes
+		*			made after this call get a later stamp than the one returned.
+		*	@return	unsigned 64-bit integer representing the stamp
+		*/
+		static std::uint64_t TakeChangeStamp();
+
 		/**
 		*	@brief	Method that takes a reference to a scope and finds the key associated with the Datum that contains the
 		*			passed in scope. Returns a default constructed string if the scope is not found
@@ -275,14 +332,139 @@ namespace FieaGameEngine
 		*/
 		virtual ~Scope();
 
+		/**
+		*	@brief	Allocation function for Scopes on the heap. Every Scope is preceded by a small header
+		*			that names the allocator it came from, so that delete gives the memory back to the
+		*			right place no matter how the Scope was created. Scopes created with plain new get
+		*			their memory from the global heap.
+		*	@param	size the size of the Scope in bytes
+		*	@return	pointer to the memory for the Scope
+		*/
+		static void* operator new(size_t size);
+
+		/**
+		*	@brief	Allocation function that places a Scope in memory from the given allocator, e.g. a pool.
+		*			Such a Scope is still destroyed with delete.
+		*	@param	size the size of the Scope in bytes
+		*	@param	allocator the allocator that provides the memory
+		*	@return	pointer to the memory for the Scope
+		*/
+		static void* operator new(size_t size, IAllocator& allocator);
+
+		/**
+		*	@brief	Placement allocation function, which has to be declared since the ones above hide the global one.
+		*	@param	size the size of the Scope in bytes
+		*	@param	memory the memory the Scope is constructed in
+		*	@return	the given memory
+		*/
+		static void* operator new(size_t size, void* memory);
+
+		/**
+		*	@brief	Deallocation function that gives the memory of a Scope back to the allocator named in its header.
+		*	@param	memory pointer to the memory of the Scope
+		*/
+		static void operator delete(void* memory);
+
+		/**
+		*	@brief	Deallocation function that is called when the constructor of a Scope placed with an allocator throws.
+		*	@param	memory pointer to the memory of the Scope
+		*	@param	allocator the allocator that provided the memory
+		*/
+		static void operator delete(void* memory, IAllocator& allocator);
+
+		/**
+		*	@brief	Placement deallocation function, matching the placement allocation function.
+		*	@param	memory pointer to the memory of the Scope
+		*	@param	place the memory the Scope was constructed in
+		*/
+		static void operator delete(void* memory, void* place);
+
 	protected:
 
+		/**
+		*	@brief	Method that is called after a Scope adopted a child, so that derived classes can keep
+		*			track of their children. The default does nothing. The children that a copy constructor
+		*			clones are adopted while the derived part is not constructed yet, so only the default runs
+		*			for them, whereas copy assignment reaches the override.
+		*	@param	child the adopted child
+		*	@param	key the key that the child was adopted under
+		*/
+		virtual void OnChildAdopted(Scope& child, const std::string& key);
+
+		/**
+		*	@brief	Method that is called after a child left a Scope, by being orphaned, destroyed or
+		*			cleared. The default does nothing.
+		*	@param	child the child that left
+		*/
+		virtual void OnChildOrphaned(Scope& child);
+
 		Vector<LookupTableEntry*> mPointersToLookupTable;				/**<	Ordered list of pointers to the string-Datum pairs in the Scope	*/
 		HashMap<std::string, Datum> mLookupTable;						/**<	Unordered list of string-Datum pairs in the Scope.	*/
 
 	private:
 
 		Scope* mParent;													/**<	Pointer to a Scope's parent.	*/
+		mutable std::atomic<std::uint64_t> mHash;						/**<	Cached hash of the Datums with internal storage in the Scope and in the nested Scopes	*/
+		mutable std::atomic<std::uint64_t> mHashState;					/**<	Flags that tell whether mHash is valid, being written or leaves Datums out, and the generation above them	*/
+		std::atomic<std::uint64_t> mChangeStamp;						/**<	Stamp of the last change made to the Scope or anything nested in it	*/
+
+		/**
+		*	@brief	Helper method to get the cached part of the hash, which covers the Datums with internal
+		*			storage in the Scope and in the nested Scopes. It is recomputed if it is stale.
+		*	@param	hasUncachedDatums set to whether the Scope or a nested Scope holds Datums whose hash is
+		*			not cached, which the cached part leaves out
+		*	@return	unsigned 64-bit integer representing the Datums with internal storage
+		*/
+		std::uint64_t CachedHash(bool& hasUncachedDatums) const;
+
+		/**
+		*	@brief	Helper method that hashes the Datums whose hash is not cached in the Scope and in the
+		*			nested Scopes that hold any, which is the part of the hash that has to be recomputed.
+		*	@return	unsigned 64-bit integer representing the Datums whose hash is not cached
+		*/
+		std::uint64_t UncachedHash() const;
+
+		/**
+		*	@brief	Static helper method that checks whether the hash of a Datum can be cached, which it
+		*			can unless the Datum has external storage or Get handed out a reference to its elements.
+		*	@param	datum the Datum
+		*	@return	bool indicating whether the hash of the Datum can be cached
+		*/
+		static bool IsHashCached(const Datum& datum);
+
+		/**
+		*	@brief	Static helper method that hashes an entry of the Scope, i.e. its key and its Datum.
+		*	@param	entry the entry
+		*	@return	unsigned 64-bit integer representing the entry
+		*/
+		static std::uint64_t EntryHash(const LookupTableEntry& entry);
+
+		/**
+		*	@brief	Static helper method to get the odd factor that the hashes of the Scopes nested under a key
+		*			are multiplied with. Multiplying keeps the cached and the uncached parts of a nested hash
+		*			additive, so a Datum hashes the same whether its hash is cached or not.
+		*	@param	key the key the nested Scopes are stored under
+		*	@return	unsigned 64-bit odd integer representing the key
+		*/
+		static std::uint64_t NestedHashFactor(const std::string& key);
+
+		/**
+		*	@brief	Helper method that appends a key that is known not to be in the Scope yet, which skips the
+		*			lookup that Append does.
+		*	@param	key the key to be appended
+		*	@param	datum the value of the new Datum
+		*	@return	reference to the new string-Datum pair
+		*/
+		LookupTableEntry& AppendUnique(const std::string& key, const Datum& datum);
+
+		static std::atomic<std::uint64_t> mChangeClock;					/**<	The current change stamp, which is advanced by TakeChangeStamp	*/
+
+		static const std::uint64_t HashValidFlag = 1;					/**<	Flag of mHashState that is set while mHash is up to date	*/
+		static const std::uint64_t HashWritingFlag = 2;					/**<	Flag of mHashState that is set while a thread writes mHash	*/
+		static const std::uint64_t HashUncachedFlag = 4;				/**<	Flag of mHashState that is set when the Scope or a nested Scope holds Datums whose hash is not cached	*/
+		static const std::uint64_t HashGenerationStep = 8;				/**<	The amount mHashState is advanced by whenever the Scope changes	*/
+
+		static const size_t AllocationHeaderSize = 16;					/**<	The size of the header in front of a Scope on the heap, which keeps the Scope aligned	*/
 
 	};
 }
\ No newline at end of file
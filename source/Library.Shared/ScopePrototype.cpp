@@ -0,0 +1,311 @@
+#include "pch.h"
+#include "ScopePrototype.h"
+
+
+namespace FieaGameEngine
+{
+
+	ScopePrototype::ScopePrototype(const Scope& source) : mPlainScopeCount(0)
+	{
+		Compile(source);
+	}
+
+
+
+
+	ScopePrototype::~ScopePrototype()
+	{
+		for (std::uint32_t i = 0; i < mNodes.Size(); ++i)
+		{
+			delete mNodes[i].mShell;
+		}
+	}
+
+
+
+
+	Scope* ScopePrototype::Instantiate() const
+	{
+		if (mNodes.IsEmpty())
+		{
+			throw std::exception("Prototype has not been compiled.");
+		}
+
+		Arena* arena = Arena::Create(ArenaCapacity(1));
+		Scope* scope;
+		try
+		{
+			scope = Build(0, *arena);
+		}
+		catch (...)
+		{
+			arena->Release();
+			throw;
+		}
+
+		arena->Release();
+		return scope;
+	}
+
+
+
+
+	void ScopePrototype::Instantiate(const std::uint32_t count, Vector<Scope*>& instances) const
+	{
+		if (mNodes.IsEmpty())
+		{
+			throw std::exception("Prototype has not been compiled.");
+		}
+
+		instances.Reserve(instances.Size() + count);
+
+		//the plain Scopes of all the instances are placed in one block
+		Arena* arena = Arena::Create(ArenaCapacity(count));
+		try
+		{
+			for (std::uint32_t i = 0; i < count; ++i)
+			{
+				instances.PushBack(Build(0, *arena));
+			}
+		}
+		catch (...)
+		{
+			arena->Release();
+			throw;
+		}
+
+		arena->Release();
+	}
+
+
+
+
+	std::uint32_t ScopePrototype::NumberOfScopes() const
+	{
+		return mNodes.Size();
+	}
+
+
+
+
+	std::uint32_t ScopePrototype::Compile(const Scope& source)
+	{
+		std::uint32_t nodeIndex = mNodes.Size();
+
+		Node node;
+		node.mShell = nullptr;
+		node.mBucketCount = source.mLookupTable.NumberOfBuckets();
+		node.mFirstEntry = static_cast<std::uint32_t>(mEntries.size());
+		node.mEntryCount = 0;
+
+		bool isPlainScope = (source.TypeIdInstance() == Scope::TypeIdClass());
+
+		if (isPlainScope)
+		{
+			++mPlainScopeCount;
+		}
+		else
+		{
+			//derived types are cloned once here, and their nested scopes are stripped since they are built from the layout
+			node.mShell = const_cast<Scope&>(source).Clone();
+
+			for (std::uint32_t i = 0; i < node.mShell->mPointersToLookupTable.Size(); ++i)
+			{
+				Datum& datum = node.mShell->mPointersToLookupTable[i]->second;
+				if (datum.Type() == EDatumType::ETable)
+				{
+					while (datum.Size() > 0)
+					{
+						Scope* child = datum.Get<Scope*>(datum.Size() - 1);
+						child->mParent = nullptr;
+						datum.RemoveByIndex(datum.Size() - 1);
+						delete child;
+					}
+				}
+			}
+		}
+
+		mNodes.PushBack(node);
+
+		//the entries of a node are laid out contiguously before any of its nested scopes are compiled
+		for (std::uint32_t i = 0; i < source.mPointersToLookupTable.Size(); ++i)
+		{
+			const Scope::LookupTableEntry& sourceEntry = *source.mPointersToLookupTable[i];
+			bool isTable = (sourceEntry.second.Type() == EDatumType::ETable);
+
+			if (isPlainScope || isTable)
+			{
+				Entry entry;
+				entry.mKey = sourceEntry.first;
+				entry.mFirstChild = 0;
+				entry.mChildCount = 0;
+
+				if (isTable)
+				{
+					entry.mDefaultValue.SetType(EDatumType::ETable);
+					entry.mChildCount = sourceEntry.second.Size();
+				}
+				else
+				{
+					entry.mDefaultValue = Datum(sourceEntry.second);
+				}
+
+				mEntries.push_back(std::move(entry));
+				++mNodes[nodeIndex].mEntryCount;
+			}
+		}
+
+		std::uint32_t entryIndex = mNodes[nodeIndex].mFirstEntry;
+		for (std::uint32_t i = 0; i < source.mPointersToLookupTable.Size(); ++i)
+		{
+			const Datum& sourceDatum = source.mPointersToLookupTable[i]->second;
+			bool isTable = (sourceDatum.Type() == EDatumType::ETable);
+
+			if (isTable)
+			{
+				std::uint32_t firstChild = mChildren.Size();
+				mEntries[entryIndex].mFirstChild = firstChild;
+
+				for (std::uint32_t j = 0; j < sourceDatum.Size(); ++j)
+				{
+					mChildren.PushBack(0);
+				}
+
+				for (std::uint32_t j = 0; j < sourceDatum.Size(); ++j)
+				{
+					std::uint32_t childIndex = Compile(sourceDatum[j]);
+					mChildren[firstChild + j] = childIndex;
+				}
+			}
+
+			if (isPlainScope || isTable)
+			{
+				++entryIndex;
+			}
+		}
+
+		return nodeIndex;
+	}
+
+
+
+
+	Scope* ScopePrototype::Build(const std::uint32_t nodeIndex, Arena& arena) const
+	{
+		const Node& node = mNodes[nodeIndex];
+		Scope* scope;
+
+		if (node.mShell != nullptr)
+		{
+			scope = node.mShell->Clone();
+		}
+		else
+		{
+			scope = new (arena) Scope(node.mBucketCount);
+			scope->mPointersToLookupTable.Reserve(node.mEntryCount);
+		}
+
+		for (std::uint32_t i = node.mFirstEntry; i < (node.mFirstEntry + node.mEntryCount); ++i)
+		{
+			const Entry& entry = mEntries[i];
+			Datum* datum;
+
+			if (node.mShell != nullptr)
+			{
+				datum = scope->Find(entry.mKey);
+			}
+			else
+			{
+				//keys of a compiled plain scope are unique, so they are inserted without a lookup
+				if (entry.mDefaultValue.Type() == EDatumType::ETable)
+				{
+					datum = &scope->AppendUnique(entry.mKey, Datum()).second;
+				}
+				else
+				{
+					datum = &scope->AppendUnique(entry.mKey, entry.mDefaultValue).second;
+				}
+			}
+
+			if (entry.mDefaultValue.Type() == EDatumType::ETable)
+			{
+				datum->SetType(EDatumType::ETable);
+				datum->Reserve(datum->Size() + entry.mChildCount);
+
+				for (std::uint32_t j = entry.mFirstChild; j < (entry.mFirstChild + entry.mChildCount); ++j)
+				{
+					scope->Adopt(*Build(mChildren[j], arena), entry.mKey);
+				}
+			}
+		}
+
+		return scope;
+	}
+
+
+
+
+	size_t ScopePrototype::ArenaCapacity(const std::uint32_t count) const
+	{
+		//every plain Scope is preceded by its allocation header, which is also its alignment
+		size_t scopeSize = (((Scope::AllocationHeaderSize + sizeof(Scope)) + (Scope::AllocationHeaderSize - 1)) & ~(Scope::AllocationHeaderSize - 1));
+		return (scopeSize * mPlainScopeCount * count);
+	}
+
+
+
+
+	ScopePrototype::Arena* ScopePrototype::Arena::Create(const size_t capacity)
+	{
+		void* block = ::operator new(sizeof(Arena) + Scope::AllocationHeaderSize + capacity);
+		return new (block) Arena(capacity);
+	}
+
+
+
+
+	ScopePrototype::Arena::Arena(const size_t capacity) : mNext(reinterpret_cast<char*>(this) + sizeof(Arena)), mEnd(nullptr), mReferenceCount(1)
+	{
+		//the block has room for aligning the first part, wherever the Arena ends
+		mEnd = (mNext + Scope::AllocationHeaderSize + capacity);
+	}
+
+
+
+
+	void* ScopePrototype::Arena::Allocate(const size_t size, const size_t alignment)
+	{
+		std::uintptr_t next = ((reinterpret_cast<std::uintptr_t>(mNext) + alignment - 1) & ~(static_cast<std::uintptr_t>(alignment) - 1));
+		if ((next + size) > reinterpret_cast<std::uintptr_t>(mEnd))
+		{
+			throw std::exception("Arena is full.");
+		}
+
+		mNext = reinterpret_cast<char*>(next + size);
+		mReferenceCount.fetch_add(1, std::memory_order_relaxed);
+		return reinterpret_cast<void*>(next);
+	}
+
+
+
+
+	void ScopePrototype::Arena::Deallocate(void* memory)
+	{
+		UNREFERENCED_PARAMETER(memory);
+		Release();
+	}
+
+
+
+
+	void ScopePrototype::Arena::Release()
+	{
+		//the instances may be deleted on other threads, so the last one to leave frees the block
+		if (mReferenceCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		{
+			this->~Arena();
+			::operator delete(this);
+		}
+	}
+
+}
\ No newline at end of file
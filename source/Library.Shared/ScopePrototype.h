@@ -0,0 +1,192 @@
+#pragma once
+
+#include <vector>
+#include "Vector.h"
+#include "Scope.h"
+#include "IAllocator.h"
+
+/**
+*	@brief	The namespace under which the game engine is implemented.
+*/
+namespace FieaGameEngine
+{
+	/**
+	*	@brief	The ScopePrototype class compiles a Scope subtree once into a flat
+	*			template (the layout of every nested scope, its keys and the default
+	*			values of its datums) and then instantiates copies of that subtree from
+	*			the template. This is meant for spawning many copies of a prefab, where
+	*			Clone would otherwise re-run the full recursive deep copy each time.
+	*			Plain Scopes are built directly from the layout. Scopes of a derived type
+	*			(Attributed, Entity, Action, etc.) are instantiated by cloning a shell of
+	*			that object with its nested scopes stripped, so that their member fixups
+	*			still run, and their nested scopes are then built from the layout.
+	*			The plain Scopes of a call to Instantiate are placed in one contiguous block,
+	*			and the default values are shared with every instance until they are written.
+	*/
+	class ScopePrototype final
+	{
+
+	public:
+
+		/**
+		*	@brief	Parameterized constructor that compiles the given Scope subtree into
+		*			the flat template. The source is not referenced after construction.
+		*	@param	source const reference to the root of the subtree to be compiled
+		*/
+		explicit ScopePrototype(const Scope& source);
+
+		/**
+		*	@brief	The copy constructor is deleted.
+		*/
+		ScopePrototype(const ScopePrototype& other) = delete;
+
+		/**
+		*	@brief	The move constructor is defaulted.
+		*/
+		ScopePrototype(ScopePrototype&& other) = default;
+
+		/**
+		*	@brief	The copy assignment operator is deleted.
+		*/
+		ScopePrototype& operator=(const ScopePrototype& other) = delete;
+
+		/**
+		*	@brief	The move assignment operator is defaulted.
+		*/
+		ScopePrototype& operator=(ScopePrototype&& other) = default;
+
+		/**
+		*	@brief	The destructor deletes the shells of the derived type scopes.
+		*/
+		~ScopePrototype();
+
+		/**
+		*	@brief	Method to create a new copy of the compiled subtree. The returned
+		*			Scope has no parent and is owned by the caller, who will usually
+		*			adopt it into a hierarchy.
+		*	@return	pointer to the root of the newly created subtree
+		*/
+		Scope* Instantiate() const;
+
+		/**
+		*	@brief	Method to create a number of copies of the compiled subtree in one go. The plain
+		*			Scopes of all the copies share one block of memory.
+		*	@param	count the number of copies to create
+		*	@param	instances the vector that the roots of the new copies are appended to
+		*/
+		void Instantiate(const std::uint32_t count, Vector<Scope*>& instances) const;
+
+		/**
+		*	@brief	Method to get the number of scopes that each instance is made of
+		*	@return	unsigned int representing the number of scopes in the template
+		*/
+		std::uint32_t NumberOfScopes() const;
+
+	private:
+
+		/**
+		*	@brief	An Arena is the block of memory that the plain Scopes of one call to Instantiate are
+		*			placed in. The Arena lives at the start of its block, each Scope is still deleted on
+		*			its own, and the block is freed along with the last of them.
+		*/
+		class Arena final : public IAllocator
+		{
+
+		public:
+
+			/**
+			*	@brief	Static method that allocates a block and constructs the Arena at its start.
+			*	@param	capacity the number of bytes that can be handed out
+			*	@return	pointer to the new Arena, which holds one reference for the caller
+			*/
+			static Arena* Create(const size_t capacity);
+
+			/**
+			*	@brief	Method to hand out the next part of the block. Overriden from the IAllocator class.
+			*	@param	size the size of the part in bytes
+			*	@param	alignment the alignment that the part must have
+			*	@return	pointer to the part
+			*/
+			virtual void* Allocate(const size_t size, const size_t alignment) override;
+
+			/**
+			*	@brief	Method to give back a part of the block, which frees the block once nothing is
+			*			left in it. Overriden from the IAllocator class.
+			*	@param	memory pointer to the part
+			*/
+			virtual void Deallocate(void* memory) override;
+
+			/**
+			*	@brief	Method to drop the reference of the caller of Create.
+			*/
+			void Release();
+
+		private:
+
+			/**
+			*	@brief	Parameterized constructor for the Arena.
+			*	@param	capacity the number of bytes that can be handed out
+			*/
+			explicit Arena(const size_t capacity);
+
+			char* mNext;									/**<	The start of the part of the block that has not been handed out	*/
+			char* mEnd;										/**<	The end of the block	*/
+			std::atomic<std::uint32_t> mReferenceCount;		/**<	The number of parts that are alive, plus one while the caller of Create holds it	*/
+
+		};
+
+		/**
+		*	@brief	A Node represents one scope of the compiled subtree.
+		*/
+		struct Node
+		{
+			Scope* mShell;					/**<	Childless clone of a derived type scope, nullptr for a plain Scope	*/
+			std::uint32_t mBucketCount;		/**<	The number of buckets in the lookup table of the scope	*/
+			std::uint32_t mFirstEntry;		/**<	Index of the first entry of this node in the entry list	*/
+			std::uint32_t mEntryCount;		/**<	Number of entries that belong to this node	*/
+		};
+
+		/**
+		*	@brief	An Entry represents one key of a compiled scope. For a plain Scope every
+		*			key has an entry. For a derived type scope only the keys that hold nested
+		*			scopes have one, as everything else comes from the shell.
+		*/
+		struct Entry
+		{
+			std::string mKey;				/**<	The key of the datum in its scope	*/
+			Datum mDefaultValue;			/**<	The default value of the datum. Empty for nested scopes	*/
+			std::uint32_t mFirstChild;		/**<	Index of the first child node index in the child list	*/
+			std::uint32_t mChildCount;		/**<	Number of nested scopes stored at this key	*/
+		};
+
+		/**
+		*	@brief	Helper method that compiles a scope and everything nested in it.
+		*	@param	source the scope to be compiled
+		*	@return	index of the node that was created for the scope
+		*/
+		std::uint32_t Compile(const Scope& source);
+
+		/**
+		*	@brief	Helper method that builds the scope of the given node and everything
+		*			nested in it.
+		*	@param	nodeIndex index of the node to be built
+		*	@param	arena the Arena that the plain Scopes are placed in
+		*	@return	pointer to the newly built scope
+		*/
+		Scope* Build(const std::uint32_t nodeIndex, Arena& arena) const;
+
+		/**
+		*	@brief	Helper method to get the number of bytes of an Arena for a number of instances.
+		*	@param	count the number of instances
+		*	@return	the capacity of the Arena in bytes
+		*/
+		size_t ArenaCapacity(const std::uint32_t count) const;
+
+		Vector<Node> mNodes;						/**<	The compiled scopes in pre-order, the root being the first one	*/
+		std::vector<Entry> mEntries;				/**<	The compiled keys of all the scopes, grouped by node, in a std::vector since an Entry holds a string and a Datum	*/
+		Vector<std::uint32_t> mChildren;			/**<	The node indices of nested scopes, grouped by entry	*/
+		std::uint32_t mPlainScopeCount;				/**<	The number of plain Scopes in the template, which are placed in the Arena	*/
+
+	};
+
+}
\ No newline at end of file
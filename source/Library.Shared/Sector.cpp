@@ -1,6 +1,7 @@
 #include "pch.h"
 #include "Sector.h"
 #include "World.h"
+#include "JobSystem.h"
 
 namespace FieaGameEngine
 {
@@ -12,7 +13,7 @@ namespace FieaGameEngine
 
 	Sector::Sector(const std::string& name) : mName(name)
 	{
-		InitializeAttributes();
+		InitializePrescribedAttributes();
 	}
 
 
@@ -21,12 +22,13 @@ namespace FieaGameEngine
 	Sector::Sector(const Sector& other) : Attributed::Attributed(other), mName(other.mName), mEntities(other.mEntities)
 	{
 		UpdatePrescribedAttributes();
+		CopyColumns(other);
 	}
 
 
 
 
-	Sector::Sector(Sector&& other) : Attributed::Attributed(std::move(other)), mName(std::move(other.mName)), mEntities(std::move(other.mEntities))
+	Sector::Sector(Sector&& other) : Attributed::Attributed(std::move(other)), mName(std::move(other.mName)), mEntities(std::move(other.mEntities)), mColumns(std::move(other.mColumns))
 	{
 		UpdatePrescribedAttributes();
 	}
@@ -38,10 +40,12 @@ namespace FieaGameEngine
 	{
 		if (this != &other)
 		{
+			DeleteColumns();
 			Attributed::operator=(other);
 			mName = other.mName;
 			mEntities = other.mEntities;
 			UpdatePrescribedAttributes();
+			CopyColumns(other);
 		}
 
 		return *this;
@@ -54,14 +58,24 @@ namespace FieaGameEngine
 	{
 		if (this != &other)
 		{
+			DeleteColumns();
 			Attributed::operator=(std::move(other));
 			mName = std::move(other.mName);
 			mEntities = std::move(other.mEntities);
+			mColumns = std::move(other.mColumns);
 			UpdatePrescribedAttributes();
 		}
 
 		return *this;
 	}
+
+
+
+
+	Sector::~Sector()
+	{
+		DeleteColumns();
+	}
 		
 		
 		
@@ -77,6 +91,7 @@ namespace FieaGameEngine
 	void Sector::SetName(const std::string& name)
 	{
 		mName = name;
+		MarkChanged();
 	}
 
 
@@ -105,6 +120,65 @@ namespace FieaGameEngine
 
 
 
+	AttributeColumn& Sector::AddColumn(const std::string& key, const EDatumType type)
+	{
+		AttributeColumn* column = FindColumn(key);
+		if (column != nullptr)
+		{
+			if (column->Type() != type)
+			{
+				throw std::exception("Column type mismatch.");
+			}
+			return *column;
+		}
+
+		column = new AttributeColumn(key, type, mEntities->Size());
+		mColumns.PushBack(column);
+
+		for (std::uint32_t i = 0; i < mEntities->Size(); ++i)
+		{
+			column->Bind((*mEntities)[i]);
+		}
+
+		return *column;
+	}
+
+
+
+
+	AttributeColumn* Sector::FindColumn(const std::string& key)
+	{
+		for (auto& column : mColumns)
+		{
+			if (column->Key() == key)
+			{
+				return column;
+			}
+		}
+
+		return nullptr;
+	}
+
+
+
+
+	void Sector::RemoveColumn(const std::string& key)
+	{
+		for (std::uint32_t i = 0; i < mColumns.Size(); ++i)
+		{
+			if (mColumns[i]->Key() == key)
+			{
+				AttributeColumn* column = mColumns[i];
+				mColumns.Remove(column);
+				delete column;
+				return;
+			}
+		}
+	}
+
+
+
+
 	void Sector::SetWorld(World* world)
 	{
 		if (GetParent() != nullptr || world == nullptr)
@@ -123,7 +197,7 @@ namespace FieaGameEngine
 	World const* Sector::GetWorld() const
 	{
 		assert(GetParent() != nullptr);
-		assert(GetParent()->Is(World::TypeIdClass()));
+		assert(GetParent()->Is<World>());
 		return GetParent()->As<World>();
 	}
 
@@ -134,17 +208,60 @@ namespace FieaGameEngine
 	{
 		worldState.CurrentSector = this;
 
-		mEntities = Find("Entities");
-		for (std::uint32_t i = 0; i < mEntities->Size(); ++i)
+		const Vector<Entity*>& entities = mEntityArray.Get(mEntities);
+		std::uint64_t sectorOrder = worldState.UpdateOrder;
+		if (worldState.Jobs == nullptr)
+		{
+			for (std::uint32_t i = 0; i < entities.Size(); ++i)
+			{
+				worldState.UpdateOrder = sectorOrder | i;
+				entities[i]->Update(worldState);
+			}
+		}
+		else
+		{
+			//every job updates its entities with a world state of its own, since the entities set the current pointers
+			worldState.Jobs->ParallelFor(entities.Size(), EntityGrainSize, [&worldState, &entities, sectorOrder](std::uint32_t begin, std::uint32_t end)
+			{
+				WorldState state = worldState.Fork();
+				for (std::uint32_t i = begin; i < end; ++i)
+				{
+					state.UpdateOrder = sectorOrder | i;
+					entities[i]->Update(state);
+				}
+			});
+		}
+	}
+
+
+
+
+	void Sector::OnChildAdopted(Scope& child, const std::string& key)
+	{
+		if (key == "Entities")
 		{
-			assert((*mEntities)[i].Is(Entity::TypeIdClass()));
-			(*mEntities)[i].As<Entity>()->Update(worldState);
+			mEntityArray.Add(child);
+
+			Entity* entity = child.As<Entity>();
+			if (entity != nullptr)
+			{
+				BindColumns(*entity);
+			}
 		}
 	}
 
 
 
 
+	void Sector::OnChildOrphaned(Scope& child)
+	{
+		mEntityArray.Remove(child);
+		UnbindColumns(child);
+	}
+
+
+
+
 	Scope* Sector::Clone()
 	{
 		return new Sector(*this);
@@ -153,20 +270,56 @@ namespace FieaGameEngine
 
 
 
-	void Sector::InitializeAttributes()
+	void Sector::BindColumns(Entity& entity)
+	{
+		for (auto& column : mColumns)
+		{
+			column->Bind(entity);
+		}
+	}
+
+
+
+
+	void Sector::UnbindColumns(Scope& child)
 	{
-		mEntities = &Append("Entities");
-		AddToPrescribedAttributes("Entities");
-		AddExternalPrescribedAttribute("Name", &mName, 1);
+		for (auto& column : mColumns)
+		{
+			column->Unbind(child);
+		}
+	}
+
+
+
+
+	void Sector::CopyColumns(const Sector& other)
+	{
+		for (auto& column : other.mColumns)
+		{
+			AddColumn(column->Key(), column->Type());
+		}
 	}
 
 
 
 
-	void Sector::UpdatePrescribedAttributes()
+	void Sector::DeleteColumns()
+	{
+		for (auto& column : mColumns)
+		{
+			delete column;
+		}
+
+		mColumns.Clear();
+	}
+
+
+
+
+	void Sector::InitializeAttributes()
 	{
-		(*this)["Name"].SetStorage(&mName, 1);
-		*Find("Entities") = *mEntities;
+		AddTablePrescribedAttribute("Entities", &Sector::mEntities);
+		AddExternalPrescribedAttribute("Name", &Sector::mName);
 	}
 
 }
\ No newline at end of file
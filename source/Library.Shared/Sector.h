@@ -3,6 +3,8 @@
 #include "Attributed.h"
 #include "WorldState.h"
 #include "Entity.h"
+#include "AttributeColumn.h"
+#include "ChildArray.h"
 
 /**
 *	@brief	The namespace under which the game engine is implemented.
@@ -20,6 +22,8 @@ namespace FieaGameEngine
 	{
 		RTTI_DECLARATIONS(Sector, Attributed)
 
+		friend class Entity;		//Entity is allowed to bind its moves and unbind its copies from the columns of a sector
+
 	public:
 
 		/**
@@ -58,9 +62,9 @@ namespace FieaGameEngine
 		Sector& operator=(Sector&& other);
 
 		/**
-		*	@brief	The destructor is defaulted
+		*	@brief	The destructor deletes the columns, giving the entities their own storage back.
 		*/
-		~Sector() = default;
+		~Sector();
 
 		/**
 		*	@brief	Method that retrieves the name of the sector
@@ -88,6 +92,29 @@ namespace FieaGameEngine
 		*/
 		Entity& CreateEntity(const std::string& entityClassName, const std::string& entityInstanceName);
 
+		/**
+		*	@brief	Method to store an attribute of all the entities of this sector in a contiguous column.
+		*			Every entity that has the attribute as a single element of the given type, now or when
+		*			it is added to the sector later, keeps its value in the column instead of in itself.
+		*	@param	key the key of the attribute
+		*	@param	type the type of the attribute. Only integers, floats, vectors and matrices are supported
+		*	@return	reference to the column
+		*/
+		AttributeColumn& AddColumn(const std::string& key, const EDatumType type);
+
+		/**
+		*	@brief	Method to find the column that stores the given attribute.
+		*	@param	key the key of the attribute
+		*	@return	pointer to the column, nullptr if the attribute is not stored in a column
+		*/
+		AttributeColumn* FindColumn(const std::string& key);
+
+		/**
+		*	@brief	Method to stop storing an attribute in a column. The entities get their own storage back.
+		*	@param	key the key of the attribute
+		*/
+		void RemoveColumn(const std::string& key);
+
 		/**
 		*	@brief	Method to change the world that contains this sector.
 		*	@param	world the new world that will contain this sector
@@ -101,7 +128,8 @@ namespace FieaGameEngine
 		World const* GetWorld() const;
 
 		/**
-		*	@brief	The update method calls the update method in each of its contained entities
+		*	@brief	The update method calls the update method in each of its contained entities. When the
+		*			world state has a job system, the entities are updated in groups, one job per group.
 		*	@param	worldState the WorldState object reference
 		*/
 		void Update(WorldState& worldState);
@@ -119,18 +147,60 @@ namespace FieaGameEngine
 		*/
 		void InitializeAttributes() override;
 
+	protected:
+
 		/**
-		*	@brief	Method to update the list of prescribed attributes whenever
-		*			the list is reinitialized. Overriden from the Attributed class.
+		*	@brief	Method that adds entities that are adopted under the entities key to the array of entities
+		*			that is updated, and binds them to the columns of the sector. Overriden from the Scope class.
+		*	@param	child the adopted child
+		*	@param	key the key that the child was adopted under
 		*/
-		void UpdatePrescribedAttributes() override;
+		virtual void OnChildAdopted(Scope& child, const std::string& key) override;
+
+		/**
+		*	@brief	Method that drops entities that leave the sector from the array of entities that is updated,
+		*			and unbinds them from the columns of the sector. Overriden from the Scope class.
+		*	@param	child the child that left
+		*/
+		virtual void OnChildOrphaned(Scope& child) override;
 
 	private:
 
+		/**
+		*	@brief	Helper method to bind an entity to all the columns of this sector.
+		*	@param	entity the entity to be bound
+		*/
+		void BindColumns(Entity& entity);
+
+		/**
+		*	@brief	Helper method to unbind a child from all the columns of this sector. It takes a Scope,
+		*			since an entity is orphaned by the destructor of the Scope, when it is no longer an Entity.
+		*	@param	child the child to be unbound
+		*/
+		void UnbindColumns(Scope& child);
+
+		/**
+		*	@brief	Helper method that creates the same columns as the given sector has, and binds the
+		*			entities of this sector to them.
+		*	@param	other the sector whose columns are copied
+		*/
+		void CopyColumns(const Sector& other);
+
+		/**
+		*	@brief	Helper method that deletes all the columns of this sector.
+		*/
+		void DeleteColumns();
+
+		static const std::uint32_t EntityGrainSize = 32;		/**<	The number of entities that are updated by one job	*/
+
 		std::string mName;			/**<	The name of the sector.	*/
 
 		Datum* mEntities;			/**<	Datum pointer pointing to the datum containing the list of entities	*/
 
+		ChildArray<Entity> mEntityArray;			/**<	The entities that are updated, in order	*/
+
+		Vector<AttributeColumn*> mColumns;		/**<	The columns that store attributes of the entities of this sector	*/
+
 	};
 
 }
\ No newline at end of file
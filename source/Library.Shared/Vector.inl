@@ -425,7 +425,7 @@ typename FieaGameEngine::Vector<T>::Iterator FieaGameEngine::Vector<T>::Find(con
 template<typename T>
 void FieaGameEngine::Vector<T>::Clear()
 {
-	if (mCapacity != 0)
+	if (mBuffer != nullptr)
 	{
 		for (unsigned int i = 0; i < mSize; ++i)
 		{
@@ -453,7 +453,7 @@ void FieaGameEngine::Vector<T>::Remove(const Iterator& it)
 	{
 		throw std::exception("Invalid owner.");
 	}
-	if (mSize > 0)
+	if (it.mIndex < mSize)
 	{
 		if (it.mIndex == (mSize - 1))
 		{
@@ -461,7 +461,7 @@ void FieaGameEngine::Vector<T>::Remove(const Iterator& it)
 			return;
 		}
 		mBuffer[it.mIndex].~T();
-		memmove_s((mBuffer + it.mIndex), (sizeof(T) * (mSize - it.mIndex)), (mBuffer + it.mIndex + 1), (sizeof(T) * (mSize - it.mIndex)));
+		memmove_s((mBuffer + it.mIndex), (sizeof(T) * (mSize - it.mIndex)), (mBuffer + it.mIndex + 1), (sizeof(T) * (mSize - it.mIndex - 1)));
 		--mSize;
 	}
 }
@@ -1,6 +1,8 @@
 #include "pch.h"
 #include "World.h"
-#include "ActionDestroyer.h"
+#include "CommandBuffer.h"
+#include "DeferredDestroyer.h"
+#include "JobSystem.h"
 
 namespace FieaGameEngine
 {
@@ -11,7 +13,7 @@ namespace FieaGameEngine
 
 	World::World(const std::string& name) : mName(name), mWorldState(), mEventQueue()
 	{
-		InitializeAttributes();
+		InitializePrescribedAttributes();
 	}
 
 
@@ -78,6 +80,7 @@ namespace FieaGameEngine
 	void World::SetName(const std::string& name)
 	{
 		mName = name;
+		MarkChanged();
 	}
 
 
@@ -115,6 +118,23 @@ namespace FieaGameEngine
 
 
 
+	void World::SetJobSystem(JobSystem* jobs)
+	{
+		mWorldState.Jobs = jobs;
+		mEventQueue.SetJobSystem(jobs);
+	}
+
+
+
+
+	JobSystem* World::GetJobSystem() const
+	{
+		return mWorldState.Jobs;
+	}
+
+
+
+
 	Sector& World::CreateSector(const std::string& sectorName)
 	{
 		Sector* sector = new Sector(sectorName);
@@ -127,15 +147,24 @@ namespace FieaGameEngine
 
 	Reaction& World::CreateReaction(const std::string& reactionClassName, const std::string& reactionInstanceName)
 	{
-		reactionClassName;
-		reactionInstanceName;
-		Reaction* reaction = (Factory<Reaction>::Create(reactionClassName));
+		Reaction* reaction = Factory<Reaction>::Create(reactionClassName);
 		if (reaction == nullptr)
 		{
 			throw std::exception("Unable to create reaction.");
 		}
-		reaction->SetName(reactionInstanceName);
-		Adopt(*reaction, "Reactions");
+
+		//the reaction is named before it is adopted, so the world never holds it without its name
+		try
+		{
+			reaction->SetName(reactionInstanceName);
+			Adopt(*reaction, "Reactions");
+		}
+		catch (...)
+		{
+			delete reaction;
+			throw;
+		}
+
 		return *reaction;
 	}
 
@@ -146,48 +175,87 @@ namespace FieaGameEngine
 	{
 		mWorldState.CurrentWorld = this;
 
-		mSectors = Find("Sectors");
-		assert(mSectors != nullptr);
-		for (std::uint32_t i = 0; i < mSectors->Size(); ++i)
+		const Vector<Sector*>& sectors = mSectorArray.Get(mSectors);
+		if (mWorldState.Jobs == nullptr)
+		{
+			for (std::uint32_t i = 0; i < sectors.Size(); ++i)
+			{
+				mWorldState.UpdateOrder = static_cast<std::uint64_t>(i) << 32;
+				sectors[i]->Update(mWorldState);
+			}
+		}
+		else
+		{
+			mWorldState.Jobs->ParallelFor(sectors.Size(), SectorGrainSize, [this, &sectors](std::uint32_t begin, std::uint32_t end)
+			{
+				WorldState state = mWorldState.Fork();
+				for (std::uint32_t i = begin; i < end; ++i)
+				{
+					state.UpdateOrder = static_cast<std::uint64_t>(i) << 32;
+					sectors[i]->Update(state);
+				}
+			});
+		}
+
+		//a reaction whose subscription attributes were written during the last frame, e.g. by a command, hears the events of this one
+		const Vector<Reaction*>& reactions = mReactionArray.Get(mReactions);
+		for (std::uint32_t i = 0; i < reactions.Size(); ++i)
 		{
-			assert((*mSectors)[i].Is(Sector::TypeIdClass()));
-			(*mSectors)[i].As<Sector>()->Update(mWorldState);
+			reactions[i]->Resubscribe();
 		}
 
+		//reactions destroyed in the background stay subscribed until their destructor runs, so they must be gone before delivery
+		DeferredDestroyer::Flush();
+
+		//commands recorded by reactions are applied after those of every entity
+		mWorldState.UpdateOrder = (std::numeric_limits<std::uint64_t>::max)();
 		mEventQueue.Update(mWorldState.GetGameTime());
 
-		ActionDestroyer::Cleanup();
+		CommandBuffer::Apply(*this);
+		DeferredDestroyer::Cleanup(*this);
 
 	}
 
 
 
 
-	Scope* World::Clone()
+	void World::OnChildAdopted(Scope& child, const std::string& key)
 	{
-		return new World(*this);
+		if (key == "Sectors")
+		{
+			mSectorArray.Add(child);
+		}
+		else if (key == "Reactions")
+		{
+			mReactionArray.Add(child);
+		}
 	}
 
 
 
 
-	void World::InitializeAttributes()
+	void World::OnChildOrphaned(Scope& child)
+	{
+		mSectorArray.Remove(child);
+		mReactionArray.Remove(child);
+	}
+
+
+
+
+	Scope* World::Clone()
 	{
-		mSectors = &Append("Sectors");
-		AddToPrescribedAttributes("Sectors");
-		mReactions = &Append("Reactions");
-		AddToPrescribedAttributes("Reactions");
-		AddExternalPrescribedAttribute("Name", &mName, 1);
+		return new World(*this);
 	}
 
 
 
 
-	void World::UpdatePrescribedAttributes()
+	void World::InitializeAttributes()
 	{
-		(*this)["Name"].SetStorage(&mName, 1);
-		*Find("Sectors") = *mSectors;
-		*Find("Reactions") = *mReactions;
+		AddTablePrescribedAttribute("Sectors", &World::mSectors);
+		AddTablePrescribedAttribute("Reactions", &World::mReactions);
+		AddExternalPrescribedAttribute("Name", &World::mName);
 	}
 
 }
\ No newline at end of file
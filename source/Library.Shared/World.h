@@ -100,6 +100,22 @@ namespace FieaGameEngine
 		*/
 		EventQueue& GetEventQueue();
 
+		/**
+		*	@brief	Method to set the job system that the sectors and their entities are updated on, and
+		*			that the events of the world are delivered on. While one is set, every sector, and
+		*			every group of entities in a sector, is updated as a job of its own, so actions must
+		*			record changes outside of their own entity in the CommandBuffer, which applies them
+		*			at the end of the update.
+		*	@param	jobs the job system, or nullptr to update serially, which is the default
+		*/
+		void SetJobSystem(JobSystem* jobs);
+
+		/**
+		*	@brief	Method to get the job system that the sectors and their entities are updated on.
+		*	@return	pointer to the job system, or nullptr if the world is updated serially
+		*/
+		JobSystem* GetJobSystem() const;
+
 		/**
 		*	@brief	Method to create a new sector that will be contained in this world
 		*	@param	sectorName the name of the sector to be created
@@ -116,7 +132,9 @@ namespace FieaGameEngine
 		Reaction& CreateReaction(const std::string& reactionClassName, const std::string& reactionInstanceName);
 
 		/**
-		*	@brief	The update method calls the update method in each of its contained sectors
+		*	@brief	The update method calls the update method in each of its contained sectors, moves the
+		*			subscriptions of its reactions over to their attributes, delivers the expired events,
+		*			then applies the recorded commands and destroys the queued objects
 		*/
 		void Update();
 
@@ -133,19 +151,37 @@ namespace FieaGameEngine
 		*/
 		void InitializeAttributes() override;
 
+	protected:
+
 		/**
-		*	@brief	Method to update the list of prescribed attributes whenever
-		*			the list is reinitialized. Overriden from the Attributed class.
+		*	@brief	Method that adds sectors that are adopted under the sectors key to the array of sectors
+		*			that is updated, and reactions under the reactions key to the array of reactions.
+		*			Overriden from the Scope class.
+		*	@param	child the adopted child
+		*	@param	key the key that the child was adopted under
 		*/
-		void UpdatePrescribedAttributes() override;
+		virtual void OnChildAdopted(Scope& child, const std::string& key) override;
+
+		/**
+		*	@brief	Method that drops sectors and reactions that leave the world from their arrays.
+		*			Overriden from the Scope class.
+		*	@param	child the child that left
+		*/
+		virtual void OnChildOrphaned(Scope& child) override;
 
 	private:
 
+		static const std::uint32_t SectorGrainSize = 1;		/**<	The number of sectors that are updated by one job	*/
+
 		std::string mName;			/**<	The name of the world	*/
 
 		Datum* mSectors;			/**<	Datum pointer pointing to the datum containing the list of sectors	*/
+
+		ChildArray<Sector> mSectorArray;			/**<	The sectors that are updated, in order	*/
 		Datum* mReactions;			/**<	Datum pointer pointing to the datum containing the list of reactions	*/
 
+		ChildArray<Reaction> mReactionArray;		/**<	The reactions, which are resubscribed before events are delivered	*/
+
 		WorldState mWorldState;		/**<	The world state for this world.	*/
 
 		EventQueue mEventQueue;		/**<	The event queue for this world	*/
@@ -4,7 +4,7 @@
 namespace FieaGameEngine
 {
 
-	WorldState::WorldState() : mGameTime(), CurrentWorld(nullptr), CurrentSector(nullptr), CurrentEntity(nullptr), CurrentAction(nullptr)
+	WorldState::WorldState() : mGameTime(), CurrentWorld(nullptr), CurrentSector(nullptr), CurrentEntity(nullptr), CurrentAction(nullptr), Jobs(nullptr), UpdateOrder(0), EventSequence(0), SubscriberIndex(0)
 	{
 	}
 
@@ -24,4 +24,20 @@ namespace FieaGameEngine
 		mGameTime = newGameTimeObject;
 	}
 
+
+
+
+	WorldState WorldState::Fork() const
+	{
+		WorldState state;
+		state.mGameTime = mGameTime;
+		state.CurrentWorld = CurrentWorld;
+		state.CurrentSector = CurrentSector;
+		state.Jobs = Jobs;
+		state.UpdateOrder = UpdateOrder;
+		state.EventSequence = EventSequence;
+		state.SubscriberIndex = SubscriberIndex;
+		return state;
+	}
+
 }
\ No newline at end of file
@@ -59,6 +59,14 @@ namespace FieaGameEngine
 		*/
 		void SetGameTime(const GameTime& newGameTimeObject);
 
+		/**
+		*	@brief	Method that creates a world state for a job that updates part of the world in parallel.
+		*			The job gets its own current pointers, so that jobs do not overwrite each other's
+		*			context, and shares the game time, the job system, the update order and the event of this world state.
+		*	@return	the world state for the job
+		*/
+		WorldState Fork() const;
+
 
 		GameTime mGameTime;					/**<	The game time object associated with this world state.	*/
 
@@ -67,6 +75,13 @@ namespace FieaGameEngine
 		class Entity* CurrentEntity;		/**<	Pointer to the current entity.	*/
 		class Action* CurrentAction;		/**<	Pointer to the current action.	*/
 
+		class JobSystem* Jobs;				/**<	The job system that sectors and entities are updated on, or nullptr to update them serially.	*/
+
+		std::uint64_t UpdateOrder;			/**<	The position of the current entity in the update, the sector in the high half and the entity in the low half.	*/
+
+		std::uint64_t EventSequence;		/**<	The position in its queue's delivery of the event that the current reaction responds to.	*/
+		std::uint32_t SubscriberIndex;		/**<	The position of the current reaction among the subscribers of that event.	*/
+
 	};
 
 }
\ No newline at end of file
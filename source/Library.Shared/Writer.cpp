@@ -0,0 +1,98 @@
+#include "pch.h"
+#include "Writer.h"
+
+
+namespace FieaGameEngine
+{
+
+	Writer::Writer() : mStream(nullptr), mBuffer()
+	{
+	}
+
+
+
+
+	Writer::Writer(std::ostream& stream) : mStream(&stream), mBuffer()
+	{
+	}
+
+
+
+
+	Writer& Writer::Write(const char* data, const size_t size)
+	{
+		if (mStream != nullptr)
+		{
+			mStream->write(data, size);
+		}
+		else
+		{
+			mBuffer.append(data, size);
+		}
+
+		return *this;
+	}
+
+
+
+
+	Writer& Writer::Write(const std::string& data)
+	{
+		return Write(data.c_str(), data.size());
+	}
+
+
+
+
+	Writer& Writer::Write(const std::int32_t data)
+	{
+		char characters[16];
+		std::int32_t length = sprintf_s(characters, "%d", data);
+		return Write(characters, length);
+	}
+
+
+
+
+	Writer& Writer::Write(const std::float_t data)
+	{
+		//%f of the largest float is under 64 characters long
+		char characters[64];
+		std::int32_t length = sprintf_s(characters, "%f", data);
+		return Write(characters, length);
+	}
+
+
+
+
+	Writer& Writer::Write(const glm::vec4& data)
+	{
+		//glm's own formatting is used for vectors and matrices, so the output stays the same as glm::to_string and SetFromString can parse it
+		return Write(glm::to_string(data));
+	}
+
+
+
+
+	Writer& Writer::Write(const glm::mat4x4& data)
+	{
+		return Write(glm::to_string(data));
+	}
+
+
+
+
+	const std::string& Writer::Buffer() const
+	{
+		return mBuffer;
+	}
+
+
+
+
+	void Writer::Clear()
+	{
+		mBuffer.clear();
+	}
+
+}
\ No newline at end of file
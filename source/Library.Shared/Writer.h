@@ -0,0 +1,120 @@
+#pragma once
+
+/**
+*	@brief	The namespace under which the game engine is implemented.
+*/
+namespace FieaGameEngine
+{
+	/**
+	*	@brief	The Writer class is the target of the streaming serialization of Scopes and Datums.
+	*			It either appends everything written to it into its own growable buffer, which
+	*			keeps its memory when cleared so that it can be reused, or forwards it straight
+	*			to an output stream. Values are formatted in place, without building a temporary
+	*			string for each of them.
+	*/
+	class Writer final
+	{
+
+	public:
+
+		/**
+		*	@brief	Default constructor that creates a Writer which writes into its own buffer.
+		*/
+		Writer();
+
+		/**
+		*	@brief	Parameterized constructor that creates a Writer which writes to the given
+		*			output stream. The stream has to outlive the Writer.
+		*	@param	stream reference to the output stream to be written to
+		*/
+		explicit Writer(std::ostream& stream);
+
+		/**
+		*	@brief	The copy constructor is deleted.
+		*/
+		Writer(const Writer& other) = delete;
+
+		/**
+		*	@brief	The move constructor is defaulted.
+		*/
+		Writer(Writer&& other) = default;
+
+		/**
+		*	@brief	The copy assignment operator is deleted.
+		*/
+		Writer& operator=(const Writer& other) = delete;
+
+		/**
+		*	@brief	The move assignment operator is defaulted.
+		*/
+		Writer& operator=(Writer&& other) = default;
+
+		/**
+		*	@brief	The destructor is defaulted.
+		*/
+		~Writer() = default;
+
+		/**
+		*	@brief	Method to write a number of characters.
+		*	@param	data pointer to the characters to be written
+		*	@param	size the number of characters to be written
+		*	@return	reference to the Writer, so that calls can be chained
+		*/
+		Writer& Write(const char* data, const size_t size);
+
+		/**
+		*	@brief	Method to write an STL string.
+		*	@param	data the string to be written
+		*	@return	reference to the Writer, so that calls can be chained
+		*/
+		Writer& Write(const std::string& data);
+
+		/**
+		*	@brief	Method to write an integer, formatted like std::to_string.
+		*	@param	data the integer to be written
+		*	@return	reference to the Writer, so that calls can be chained
+		*/
+		Writer& Write(const std::int32_t data);
+
+		/**
+		*	@brief	Method to write a float, formatted like std::to_string.
+		*	@param	data the float to be written
+		*	@return	reference to the Writer, so that calls can be chained
+		*/
+		Writer& Write(const std::float_t data);
+
+		/**
+		*	@brief	Method to write a vector, formatted like glm::to_string.
+		*	@param	data the vector to be written
+		*	@return	reference to the Writer, so that calls can be chained
+		*/
+		Writer& Write(const glm::vec4& data);
+
+		/**
+		*	@brief	Method to write a matrix, formatted like glm::to_string.
+		*	@param	data the matrix to be written
+		*	@return	reference to the Writer, so that calls can be chained
+		*/
+		Writer& Write(const glm::mat4x4& data);
+
+		/**
+		*	@brief	Method to get everything that has been written into the buffer. Always
+		*			empty for a Writer that writes to a stream.
+		*	@return	const reference to the buffer
+		*/
+		const std::string& Buffer() const;
+
+		/**
+		*	@brief	Method to empty the buffer. The memory of the buffer is kept, so that the
+		*			Writer can be reused without allocating again.
+		*/
+		void Clear();
+
+	private:
+
+		std::ostream* mStream;				/**<	The stream to write to, nullptr when writing into the buffer	*/
+		std::string mBuffer;				/**<	The buffer that is written into when there is no stream	*/
+
+	};
+
+}
\ No newline at end of file